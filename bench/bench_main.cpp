@@ -0,0 +1,604 @@
+#include "l1_geometry_kernel.h"
+#include "job_json.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+  #include <psapi.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kPi = 3.14159265358979323846;
+
+double ElapsedMs(const Clock::time_point& begin, const Clock::time_point& end) {
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// ---------------------------------------------------------------------------
+// メモリ計測
+// ---------------------------------------------------------------------------
+
+std::size_t CurrentMemoryBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS_EX counters{};
+  if (GetProcessMemoryInfo(GetCurrentProcess(),
+                           reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
+                           sizeof(counters)))
+    return counters.PrivateUsage;
+  return 0;
+#else
+  std::ifstream statm("/proc/self/statm");
+  std::size_t pages = 0, resident = 0;
+  statm >> pages >> resident;
+  return resident * 4096;
+#endif
+}
+
+// 計測区間中のメモリ使用量を別スレッドでサンプリングし、開始時点からの最大増分を返す。
+// プロセスのピーク値はリセットできないため、ケースごとの値はこの方法で取る
+class MemorySampler {
+ public:
+  MemorySampler() : base_(CurrentMemoryBytes()), peak_(base_) {
+    thread_ = std::thread([this]() {
+      while (!stop_.load()) {
+        Sample();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+
+  ~MemorySampler() { Stop(); }
+
+  double StopPeakMb() {
+    Stop();
+    Sample();
+    return static_cast<double>(peak_.load() - base_) / (1024.0 * 1024.0);
+  }
+
+ private:
+  void Sample() {
+    const std::size_t now = CurrentMemoryBytes();
+    std::size_t peak = peak_.load();
+    while (now > peak && !peak_.compare_exchange_weak(peak, now)) {}
+  }
+
+  void Stop() {
+    stop_ = true;
+    if (thread_.joinable()) thread_.join();
+  }
+
+  const std::size_t        base_;
+  std::atomic<std::size_t> peak_;
+  std::atomic<bool>        stop_{false};
+  std::thread              thread_;
+};
+
+// ---------------------------------------------------------------------------
+// 合成ワークロード
+// ---------------------------------------------------------------------------
+
+constexpr double kBoxSize   = 200.0;
+constexpr double kBoxHeight = 40.0;
+constexpr double kBarRadius = 30.0;
+constexpr double kBarLength = 200.0;
+
+AxisDto MakeAxis(double ox, double oy, double oz, double dz) {
+  AxisDto axis{};
+  axis.origin[0] = ox;
+  axis.origin[1] = oy;
+  axis.origin[2] = oz;
+  axis.dir[2]    = dz;
+  axis.xdir[0]   = 1.0;
+  return axis;
+}
+
+StockDto MakeBoxStock() {
+  StockDto stock{};
+  stock.type = STOCK_BOX;
+  stock.p1   = kBoxSize;
+  stock.p2   = kBoxSize;
+  stock.p3   = kBoxHeight;
+  stock.axis = MakeAxis(0.0, 0.0, 0.0, 1.0);
+  return stock;
+}
+
+StockDto MakeBarStock() {
+  StockDto stock{};
+  stock.type = STOCK_CYLINDER;
+  stock.p1   = kBarRadius;
+  stock.p2   = kBarLength;
+  stock.axis = MakeAxis(0.0, 0.0, 0.0, 1.0);
+  return stock;
+}
+
+// 上面の n 個のセル中心（格子状）
+std::vector<std::pair<double, double>> GridCenters(int n, double* outCell) {
+  const int perRow = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+  const double cell = (kBoxSize - 20.0) / perRow;
+  std::vector<std::pair<double, double>> centers;
+  for (int i = 0; i < n; ++i)
+    centers.emplace_back(10.0 + cell * (i % perRow + 0.5), 10.0 + cell * (i / perRow + 0.5));
+  *outCell = cell;
+  return centers;
+}
+
+Path2DSegmentDto Line(double u0, double v0, double u1, double v1) {
+  Path2DSegmentDto seg{};
+  seg.from         = {u0, v0};
+  seg.to           = {u1, v1};
+  seg.type         = PATH_SEGMENT_LINE;
+  seg.arcDirection = ARC_DIR_CCW;
+  return seg;
+}
+
+// 外径側をのこぎり歯状に削る閉プロファイル（セグメント数 = n）
+std::vector<Path2DSegmentDto> SawtoothTurnProfile(int n) {
+  const int teeth = std::max(1, n - 3);
+  const double top = kBarRadius + 1.0;
+  std::vector<Path2DSegmentDto> segments;
+  segments.push_back(Line(0.0, top, kBarLength, top));
+
+  double u = kBarLength, v = kBarRadius - 4.0;
+  segments.push_back(Line(u, top, u, v));
+  for (int i = 1; i <= teeth; ++i) {
+    const double nu = kBarLength * (1.0 - static_cast<double>(i) / teeth);
+    const double nv = kBarRadius - ((i % 2) ? 2.0 : 4.0);
+    segments.push_back(Line(u, v, nu, nv));
+    u = nu;
+    v = nv;
+  }
+  segments.push_back(Line(u, v, 0.0, top));
+  return segments;
+}
+
+// 角を半径 fillet で丸めた正 k 角形（線分 k + 円弧 k）
+std::vector<Path2DSegmentDto> RoundedPolygonContour(int k, double radius, double fillet) {
+  std::vector<Path2DSegmentDto> segments;
+  const double half = kPi / k;                       // 中心角の半分
+  const double offset = fillet / std::sin(kPi / 2.0 - half);  // 頂点 → フィレット中心
+
+  struct Corner { double cu, cv, inU, inV, outU, outV; };
+  std::vector<Corner> corners(k);
+  for (int i = 0; i < k; ++i) {
+    const double a  = 2.0 * half * i;
+    const double vu = radius * std::cos(a), vv = radius * std::sin(a);
+    const double scale = (radius - offset) / radius;
+    Corner& c = corners[i];
+    c.cu = vu * scale;
+    c.cv = vv * scale;
+    // 接点は隣接辺の法線方向（辺中点方向）に fillet だけ離れた点
+    const double aIn = a - half, aOut = a + half;
+    c.inU  = c.cu + fillet * std::cos(aIn);
+    c.inV  = c.cv + fillet * std::sin(aIn);
+    c.outU = c.cu + fillet * std::cos(aOut);
+    c.outV = c.cv + fillet * std::sin(aOut);
+  }
+
+  for (int i = 0; i < k; ++i) {
+    const Corner& c    = corners[i];
+    const Corner& next = corners[(i + 1) % k];
+    Path2DSegmentDto arc{};
+    arc.from         = {c.inU, c.inV};
+    arc.to           = {c.outU, c.outV};
+    arc.center       = {c.cu, c.cv};
+    arc.type         = PATH_SEGMENT_ARC;
+    arc.arcDirection = ARC_DIR_CCW;
+    segments.push_back(arc);
+    segments.push_back(Line(c.outU, c.outV, next.inU, next.inV));
+  }
+  return segments;
+}
+
+// ---------------------------------------------------------------------------
+// ベンチマーク定義
+// ---------------------------------------------------------------------------
+
+struct Measurement {
+  double ms     = 0.0;  // 計測対象区間（繰り返しの中央値）
+  double lastMs = 0.0;  // 連続フィーチャ系: 最後の 1 回
+  double peakMb = 0.0;
+  double bytes  = 0.0;  // ファイル系: 出力 / 入力サイズ
+};
+
+// 1 回分の計測。kernel はリセット済みで渡される。失敗時は例外
+using BenchFn = std::function<Measurement(void* kernel, double size)>;
+
+struct Suite {
+  const char*         name;
+  std::vector<double> sizes;
+  std::vector<double> quickSizes;
+  BenchFn             run;
+};
+
+void Require(int rc, const char* step) {
+  if (rc != 0) throw std::runtime_error(std::string(step) + " failed: errorCode=" + std::to_string(rc));
+}
+
+int CreateStock(void* kernel, const StockDto& stock) {
+  int id = 0;
+  Require(L1_CreateStock(kernel, &stock, &id), "L1_CreateStock");
+  return id;
+}
+
+// 穴 n 個を順に適用し、最終 Result の ID を返す
+int ApplyHoles(void* kernel, int n, Measurement* m) {
+  int current = CreateStock(kernel, MakeBoxStock());
+  double cell = 0.0;
+  for (const auto& c : GridCenters(n, &cell)) {
+    MillHoleFeatureDto hole{};
+    hole.radius = std::min(3.0, cell * 0.3);
+    hole.depth  = 10.0;
+    hole.axis   = MakeAxis(c.first, c.second, kBoxHeight, -1.0);
+    OperationResult result{};
+    result.structSize = sizeof(result);
+    const auto start = Clock::now();
+    Require(L1_ApplyMillHole(kernel, current, &hole, &result), "L1_ApplyMillHole");
+    if (m) m->lastMs = ElapsedMs(start, Clock::now());
+    current = result.resultShapeId;
+  }
+  return current;
+}
+
+double FileBytes(const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  return ec ? 0.0 : static_cast<double>(size);
+}
+
+std::vector<Suite> MakeSuites(const std::filesystem::path& workDir) {
+  std::vector<Suite> suites;
+
+  // 既存フィーチャ数に対するブーリアンコスト
+  suites.push_back({"holes_on_box", {1, 10, 25, 50, 100}, {1, 10},
+      [](void* kernel, double size) {
+        Measurement m;
+        const auto start = Clock::now();
+        ApplyHoles(kernel, static_cast<int>(size), &m);
+        m.ms = ElapsedMs(start, Clock::now());
+        return m;
+      }});
+
+  suites.push_back({"chained_pockets", {1, 10, 25, 50}, {1, 10},
+      [](void* kernel, double size) {
+        Measurement m;
+        int current = CreateStock(kernel, MakeBoxStock());
+        double cell = 0.0;
+        const auto centers = GridCenters(static_cast<int>(size), &cell);
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < centers.size(); ++i) {
+          PocketRectFeatureDto pocket{};
+          pocket.width  = cell * 0.6;
+          pocket.height = cell * 0.4;
+          pocket.depth  = 4.0 + (i % 3);
+          pocket.axis   = MakeAxis(centers[i].first, centers[i].second, kBoxHeight, -1.0);
+          OperationResult result{};
+          result.structSize = sizeof(result);
+          const auto featureStart = Clock::now();
+          Require(L1_ApplyPocketRect(kernel, current, &pocket, &result), "L1_ApplyPocketRect");
+          m.lastMs = ElapsedMs(featureStart, Clock::now());
+          current = result.resultShapeId;
+        }
+        m.ms = ElapsedMs(start, Clock::now());
+        return m;
+      }});
+
+  // ValidateSegments / BuildFaceFromSegments のセグメント数依存
+  suites.push_back({"turn_profile_segments", {10, 100, 1000, 10000}, {10, 100},
+      [](void* kernel, double size) {
+        Measurement m;
+        const int stockId = CreateStock(kernel, MakeBarStock());
+        const auto profile = SawtoothTurnProfile(static_cast<int>(size));
+        const AxisDto axis = MakeAxis(0.0, 0.0, 0.0, 1.0);
+        OperationResult result{};
+        result.structSize = sizeof(result);
+        const auto start = Clock::now();
+        Require(L1_ApplyTurnOd(kernel, stockId, &axis, profile.data(),
+                               static_cast<int>(profile.size()), 1, &result),
+                "L1_ApplyTurnOd");
+        m.ms = ElapsedMs(start, Clock::now());
+        return m;
+      }});
+
+  suites.push_back({"contour_arcs", {8, 32, 128, 512, 2048}, {8, 32},
+      [](void* kernel, double size) {
+        Measurement m;
+        const int stockId = CreateStock(kernel, MakeBoxStock());
+        const auto contour = RoundedPolygonContour(static_cast<int>(size) / 2, 80.0, 2.0);
+        const AxisDto axis = MakeAxis(kBoxSize / 2, kBoxSize / 2, kBoxHeight, -1.0);
+        OperationResult result{};
+        result.structSize = sizeof(result);
+        const auto start = Clock::now();
+        Require(L1_ApplyMillContour(kernel, stockId, &axis, contour.data(),
+                                    static_cast<int>(contour.size()), 1, 8.0, &result),
+                "L1_ApplyMillContour");
+        m.ms = ElapsedMs(start, Clock::now());
+        return m;
+      }});
+
+  // STL 出力のたわみ依存（size = linearDeflection）
+  suites.push_back({"stl_export_deflection", {1.0, 0.3, 0.1, 0.03, 0.01}, {1.0, 0.1},
+      [workDir](void* kernel, double size) {
+        Measurement m;
+        const int shapeId = ApplyHoles(kernel, 16, nullptr);
+        OutputOptions opt{};
+        opt.format            = OUT_STL;
+        opt.linearDeflection  = size;
+        opt.angularDeflection = 0.5;
+        opt.parallel          = 1;
+        const std::filesystem::path path = workDir / "bench_export.stl";
+        const auto start = Clock::now();
+        Require(L1_ExportShape(kernel, shapeId, &opt, path.string().c_str()), "L1_ExportShape(STL)");
+        m.ms    = ElapsedMs(start, Clock::now());
+        m.bytes = FileBytes(path);
+        return m;
+      }});
+
+  // STEP 読込のファイルサイズ依存（size = 穴数）
+  suites.push_back({"step_import_size", {1, 25, 100}, {1, 25},
+      [workDir](void* kernel, double size) {
+        Measurement m;
+        const int shapeId = ApplyHoles(kernel, static_cast<int>(size), nullptr);
+        OutputOptions opt{};
+        opt.format = OUT_STEP;
+        const std::filesystem::path path = workDir / "bench_import.step";
+        Require(L1_ExportShape(kernel, shapeId, &opt, path.string().c_str()), "L1_ExportShape(STEP)");
+        int importedId = 0;
+        const auto start = Clock::now();
+        Require(L1_ImportStepAsShape(kernel, path.string().c_str(), &importedId),
+                "L1_ImportStepAsShape");
+        m.ms    = ElapsedMs(start, Clock::now());
+        m.bytes = FileBytes(path);
+        return m;
+      }});
+
+  return suites;
+}
+
+// ---------------------------------------------------------------------------
+// 実行・ベースライン比較
+// ---------------------------------------------------------------------------
+
+struct BenchOptions {
+  int                   repeat    = 3;
+  bool                  quick     = false;
+  bool                  unify     = false;  // KernelOptions.unifySameDomain
+  BooleanGlueMode       glue      = BOOLEAN_GLUE_OFF;
+  std::string           filter;
+  std::filesystem::path outPath;
+  std::filesystem::path baselinePath;
+  double                threshold = 0.20;  // 相対悪化の許容幅
+  double                minDiffMs = 1.0;   // これ未満の差は無視（計測ノイズ）
+  double                minDiffMb = 4.0;
+};
+
+struct BenchResult {
+  std::string name;
+  double      size = 0.0;
+  Measurement m;
+  std::string error;
+  double      baselineMs = -1.0;
+  double      baselineMb = -1.0;
+  bool        regression = false;
+};
+
+std::string Key(const std::string& name, double size) {
+  std::ostringstream os;
+  os << name << "@" << size;
+  return os.str();
+}
+
+double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+BenchResult RunCase(void* kernel, const Suite& suite, double size, int repeat) {
+  BenchResult r;
+  r.name = suite.name;
+  r.size = size;
+
+  std::vector<double> ms, lastMs, peakMb;
+  try {
+    for (int i = 0; i < repeat; ++i) {
+      L1_ResetKernel(kernel);
+      MemorySampler sampler;
+      Measurement m = suite.run(kernel, size);
+      m.peakMb = sampler.StopPeakMb();
+      ms.push_back(m.ms);
+      lastMs.push_back(m.lastMs);
+      peakMb.push_back(m.peakMb);
+      r.m.bytes = m.bytes;
+    }
+  } catch (const std::exception& ex) {
+    r.error = ex.what();
+    return r;
+  }
+  r.m.ms     = Median(ms);
+  r.m.lastMs = Median(lastMs);
+  r.m.peakMb = *std::max_element(peakMb.begin(), peakMb.end());
+  return r;
+}
+
+void ApplyBaseline(const std::filesystem::path& path, const BenchOptions& options,
+                   std::vector<BenchResult>* results) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) throw std::runtime_error("Failed to open baseline: " + path.string());
+  std::ostringstream ss;
+  ss << ifs.rdbuf();
+  const l1::JsonValue root = l1::JsonValue::Parse(ss.str());
+
+  std::map<std::string, std::pair<double, double>> baseline;
+  for (const l1::JsonValue& entry : root.Require("results", "baseline").AsArray("results")) {
+    const std::string name = entry.Require("name", "result").AsString("name");
+    const double size = entry.Require("size", "result").AsNumber("size");
+    baseline[Key(name, size)] = {entry.Require("ms", "result").AsNumber("ms"),
+                                 entry.Require("peakMb", "result").AsNumber("peakMb")};
+  }
+
+  for (BenchResult& r : *results) {
+    auto it = baseline.find(Key(r.name, r.size));
+    if (it == baseline.end()) {
+      // 比較されないケースを黙って通さない（サイズ追加後の基準の取り直し忘れなど）
+      std::cerr << "No baseline for " << r.name << " size=" << r.size << std::endl;
+      continue;
+    }
+    if (!r.error.empty()) continue;
+    r.baselineMs = it->second.first;
+    r.baselineMb = it->second.second;
+    const bool slower = r.m.ms > r.baselineMs * (1.0 + options.threshold) &&
+                        r.m.ms - r.baselineMs > options.minDiffMs;
+    const bool bigger = r.m.peakMb > r.baselineMb * (1.0 + options.threshold) &&
+                        r.m.peakMb - r.baselineMb > options.minDiffMb;
+    r.regression = slower || bigger;
+  }
+}
+
+std::string FormatResults(const std::vector<BenchResult>& results, const BenchOptions& options) {
+  std::ostringstream os;
+  os << std::setprecision(6);
+  os << "{\n  \"repeat\": " << options.repeat
+     << ",\n  \"unify\": " << (options.unify ? "true" : "false")
+     << ",\n  \"glueMode\": " << static_cast<int>(options.glue)
+     << ",\n  \"threshold\": " << options.threshold
+     << ",\n  \"results\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const BenchResult& r = results[i];
+    os << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+       << ", \"ms\": " << r.m.ms << ", \"lastMs\": " << r.m.lastMs
+       << ", \"peakMb\": " << r.m.peakMb << ", \"bytes\": " << r.m.bytes;
+    if (r.baselineMs >= 0.0)
+      os << ", \"baselineMs\": " << r.baselineMs << ", \"baselinePeakMb\": " << r.baselineMb
+         << ", \"regression\": " << (r.regression ? "true" : "false");
+    if (!r.error.empty()) {
+      std::string error;
+      l1::AppendJsonString(error, r.error);
+      os << ", \"error\": " << error;
+    }
+    os << "}";
+  }
+  os << "\n  ]\n}\n";
+  return os.str();
+}
+
+void PrintUsage() {
+  std::cerr << "Usage: occt_geometry_bench [--quick] [--unify] [--glue auto|off|on]\n"
+               "                           [--repeat N] [--filter name]\n"
+               "                           [--out results.json] [--baseline baseline.json]\n"
+               "                           [--threshold 0.2]" << std::endl;
+}
+
+bool ParseArgs(int argc, char* argv[], BenchOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if      (arg == "--quick")                 options->quick        = true;
+    else if (arg == "--unify")                 options->unify        = true;
+    else if (arg == "--glue"      && hasValue) {
+      const std::string mode = argv[++i];
+      if      (mode == "auto") options->glue = BOOLEAN_GLUE_AUTO;
+      else if (mode == "off")  options->glue = BOOLEAN_GLUE_OFF;
+      else if (mode == "on")   options->glue = BOOLEAN_GLUE_ON;
+      else return false;
+    }
+    else if (arg == "--repeat"    && hasValue) options->repeat       = std::max(1, std::stoi(argv[++i]));
+    else if (arg == "--filter"    && hasValue) options->filter       = argv[++i];
+    else if (arg == "--out"       && hasValue) options->outPath      = argv[++i];
+    else if (arg == "--baseline"  && hasValue) options->baselinePath = argv[++i];
+    else if (arg == "--threshold" && hasValue) options->threshold    = std::stod(argv[++i]);
+    else return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  BenchOptions options;
+  try {
+    if (!ParseArgs(argc, argv, &options)) {
+      PrintUsage();
+      return 1;
+    }
+  } catch (const std::exception&) {
+    PrintUsage();
+    return 1;
+  }
+
+  const std::filesystem::path workDir = std::filesystem::temp_directory_path() / "l1_bench";
+  std::filesystem::create_directories(workDir);
+
+  void* kernel = L1_CreateKernel();
+  if (!kernel) {
+    std::cerr << "L1_CreateKernel failed" << std::endl;
+    return 1;
+  }
+  KernelOptions kernelOptions{};
+  kernelOptions.structSize      = sizeof(KernelOptions);
+  kernelOptions.unifySameDomain = options.unify ? 1 : 0;
+  kernelOptions.glueMode        = options.glue;
+  L1_SetKernelOptions(kernel, &kernelOptions);
+
+  std::vector<BenchResult> results;
+  for (const Suite& suite : MakeSuites(workDir)) {
+    if (!options.filter.empty() && std::string(suite.name).find(options.filter) == std::string::npos)
+      continue;
+    for (double size : options.quick ? suite.quickSizes : suite.sizes) {
+      results.push_back(RunCase(kernel, suite, size, options.repeat));
+      const BenchResult& r = results.back();
+      std::cerr << std::fixed << std::setprecision(3) << suite.name << " size=" << size
+                << (r.error.empty() ? "" : " ERROR " + r.error)
+                << " ms=" << r.m.ms << " peakMb=" << r.m.peakMb << std::endl;
+    }
+  }
+  L1_DestroyKernel(kernel);
+
+  try {
+    if (!options.baselinePath.empty()) ApplyBaseline(options.baselinePath, options, &results);
+  } catch (const std::exception& ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+
+  const std::string json = FormatResults(results, options);
+  if (options.outPath.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream ofs(options.outPath, std::ios::trunc);
+    ofs << json;
+  }
+
+  int exitCode = 0;
+  for (const BenchResult& r : results) {
+    if (!r.error.empty()) exitCode = std::max(exitCode, 2);
+    if (r.regression) {
+      std::cerr << "REGRESSION " << r.name << " size=" << r.size << ": "
+                << r.baselineMs << " ms -> " << r.m.ms << " ms, "
+                << r.baselineMb << " MB -> " << r.m.peakMb << " MB" << std::endl;
+      exitCode = 3;
+    }
+  }
+  return exitCode;
+}
@@ -0,0 +1,459 @@
+#include "l1_geometry_kernel.h"
+#include "call_journal.h"
+#include "job_json.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using l1::journal::Call;
+using l1::journal::PayloadReader;
+using l1::journal::RecordHeader;
+
+constexpr std::size_t kSlowestCount = 20;
+
+// ---------------------------------------------------------------------------
+// 再生状態
+// ---------------------------------------------------------------------------
+
+struct ReplayOptions {
+  std::filesystem::path journalPath;
+  std::filesystem::path outDir;      // 出力ファイルの置き換え先（ファイル名だけ引き継ぐ）
+  std::filesystem::path reportPath;  // 空: 標準出力
+  bool                  skipExport = false;
+};
+
+// 記録時のカーネルハンドルごとに再生側カーネルと ID 対応表を持つ
+struct ReplayKernel {
+  void*              handle = nullptr;
+  std::map<int, int> ids;  // 記録時の Shape ID → 再生時の Shape ID
+
+  int Map(int recordedId) const {
+    auto it = ids.find(recordedId);
+    return it == ids.end() ? recordedId : it->second;
+  }
+
+  void Bind(int recordedId, int replayedId) {
+    if (recordedId != 0 && replayedId != 0) ids[recordedId] = replayedId;
+  }
+
+  void Bind(const OperationResult& recorded, const OperationResult& replayed) {
+    Bind(recorded.resultShapeId,  replayed.resultShapeId);
+    Bind(recorded.deltaShapeId,   replayed.deltaShapeId);
+    Bind(recorded.removalShapeId, replayed.removalShapeId);
+  }
+};
+
+// 記録された OperationResult（structSize 付きのバージョン付き構造体）
+OperationResult RecordedResult(PayloadReader& in) {
+  OperationResult recorded{};
+  in.GetVersioned(&recorded);
+  return recorded;
+}
+
+OperationResult NewResult() {
+  OperationResult result{};
+  result.structSize = sizeof(result);
+  return result;
+}
+
+struct CallStats {
+  int    count      = 0;
+  double recordedMs = 0.0;
+  double replayMs   = 0.0;
+};
+
+struct RecordRun {
+  std::size_t index = 0;
+  Call        call  = Call::kCreateKernel;
+  double      recordedMs = 0.0;
+  double      replayMs   = 0.0;
+  int         recordedRc = 0;
+  int         replayRc   = 0;
+};
+
+class Replayer {
+ public:
+  explicit Replayer(const ReplayOptions& options) : options_(options) {}
+
+  ~Replayer() {
+    for (auto& entry : kernels_)
+      if (entry.second.handle) L1_DestroyKernel(entry.second.handle);
+  }
+
+  RecordRun Run(std::size_t index, const RecordHeader& header, PayloadReader& in) {
+    RecordRun run;
+    run.index      = index;
+    run.call       = static_cast<Call>(header.call);
+    run.recordedMs = header.durationMs;
+    run.recordedRc = header.returnCode;
+
+    const auto start = Clock::now();
+    run.replayRc = Dispatch(run.call, header.kernel, in);
+    run.replayMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return run;
+  }
+
+ private:
+  // 記録がカーネル生成より後から始まっている場合は最初の呼び出しで作る
+  ReplayKernel& KernelFor(std::uint64_t tag) {
+    ReplayKernel& kernel = kernels_[tag];
+    if (!kernel.handle) kernel.handle = L1_CreateKernel();
+    return kernel;
+  }
+
+  std::string OutputPath(const std::string& recordedPath) const {
+    return (options_.outDir / std::filesystem::u8path(recordedPath).filename()).u8string();
+  }
+
+  int Dispatch(Call call, std::uint64_t tag, PayloadReader& in) {
+    switch (call) {
+      case Call::kCreateKernel: {
+        ReplayKernel& kernel = kernels_[tag];
+        if (kernel.handle) L1_DestroyKernel(kernel.handle);
+        kernel = ReplayKernel{};
+        kernel.handle = L1_CreateKernel();
+        return kernel.handle ? 0 : 1;
+      }
+      case Call::kDestroyKernel: {
+        auto it = kernels_.find(tag);
+        if (it == kernels_.end()) return 0;
+        const int rc = L1_DestroyKernel(it->second.handle);
+        kernels_.erase(it);
+        return rc;
+      }
+      case Call::kForkKernel: {
+        // 記録時のフォーク先ハンドルに、親の ID 対応表ごと引き継ぐ
+        const std::uint64_t forkTag = in.Get<std::uint64_t>();
+        ReplayKernel& parent = KernelFor(tag);
+        void* fork = nullptr;
+        const int rc = L1_ForkKernel(parent.handle, &fork);
+        if (rc != 0 || forkTag == 0) {
+          if (fork) L1_DestroyKernel(fork);
+          return rc;
+        }
+        ReplayKernel& child = kernels_[forkTag];
+        if (child.handle) L1_DestroyKernel(child.handle);
+        child.handle = fork;
+        child.ids    = parent.ids;
+        return rc;
+      }
+      case Call::kResetKernel: {
+        ReplayKernel& kernel = KernelFor(tag);
+        kernel.ids.clear();
+        return L1_ResetKernel(kernel.handle);
+      }
+      case Call::kSetKernelOptions: {
+        KernelOptions opt{};
+        in.GetVersioned(&opt);
+        opt.structSize = std::min<int>(opt.structSize, sizeof(KernelOptions));
+        return L1_SetKernelOptions(KernelFor(tag).handle, &opt);
+      }
+      case Call::kCreateStock: {
+        const StockDto dto = in.Get<StockDto>();
+        const int recordedId = in.Get<int>();
+        ReplayKernel& kernel = KernelFor(tag);
+        int id = 0;
+        const int rc = L1_CreateStock(kernel.handle, &dto, &id);
+        kernel.Bind(recordedId, id);
+        return rc;
+      }
+      case Call::kApplyMillHole: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int stockId = kernel.Map(in.Get<int>());
+        const MillHoleFeatureDto dto = in.Get<MillHoleFeatureDto>();
+        OperationResult result = NewResult();
+        const int rc = L1_ApplyMillHole(kernel.handle, stockId, &dto, &result);
+        kernel.Bind(RecordedResult(in), result);
+        return rc;
+      }
+      case Call::kApplyPocketRect: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int stockId = kernel.Map(in.Get<int>());
+        const PocketRectFeatureDto dto = in.Get<PocketRectFeatureDto>();
+        OperationResult result = NewResult();
+        const int rc = L1_ApplyPocketRect(kernel.handle, stockId, &dto, &result);
+        kernel.Bind(RecordedResult(in), result);
+        return rc;
+      }
+      case Call::kApplyTurnOd:
+      case Call::kApplyTurnId:
+      case Call::kApplyMillContour: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int stockId = kernel.Map(in.Get<int>());
+        const AxisDto axis = in.Get<AxisDto>();
+        const std::vector<Path2DSegmentDto> segments = in.GetArray<Path2DSegmentDto>();
+        const int closed = in.Get<int>();
+        const int count  = static_cast<int>(segments.size());
+        OperationResult result = NewResult();
+        int rc = 0;
+        if (call == Call::kApplyMillContour) {
+          const double depth = in.Get<double>();
+          rc = L1_ApplyMillContour(kernel.handle, stockId, &axis, segments.data(), count,
+                                   closed, depth, &result);
+        } else if (call == Call::kApplyTurnOd) {
+          rc = L1_ApplyTurnOd(kernel.handle, stockId, &axis, segments.data(), count,
+                              closed, &result);
+        } else {
+          rc = L1_ApplyTurnId(kernel.handle, stockId, &axis, segments.data(), count,
+                              closed, &result);
+        }
+        kernel.Bind(RecordedResult(in), result);
+        return rc;
+      }
+      case Call::kApplyMillSlot: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int stockId = kernel.Map(in.Get<int>());
+        const AxisDto axis = in.Get<AxisDto>();
+        const std::vector<Path2DSegmentDto> segments = in.GetArray<Path2DSegmentDto>();
+        const double toolRadius = in.Get<double>();
+        const double depth      = in.Get<double>();
+        OperationResult result = NewResult();
+        const int rc = L1_ApplyMillSlot(kernel.handle, stockId, &axis, segments.data(),
+                                        static_cast<int>(segments.size()), toolRadius, depth,
+                                        &result);
+        kernel.Bind(RecordedResult(in), result);
+        return rc;
+      }
+      case Call::kDeleteShape: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int recordedId = in.Get<int>();
+        const int rc = L1_DeleteShape(kernel.handle, kernel.Map(recordedId));
+        kernel.ids.erase(recordedId);
+        return rc;
+      }
+      case Call::kImportStep: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const std::string path = in.GetString();
+        const int recordedId = in.Get<int>();
+        int id = 0;
+        const int rc = L1_ImportStepAsShape(kernel.handle, path.c_str(), &id);
+        kernel.Bind(recordedId, id);
+        return rc;
+      }
+      case Call::kImportStepEx: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const std::string path = in.GetString();
+        ImportOptions opt{};
+        in.GetVersioned(&opt);
+        opt.structSize = std::min<int>(opt.structSize, sizeof(ImportOptions));
+        const int recordedId = in.Get<int>();
+        int id = 0;
+        const int rc = L1_ImportStepAsShapeEx(kernel.handle, path.c_str(), &opt, &id);
+        kernel.Bind(recordedId, id);
+        return rc;
+      }
+      case Call::kExportShape: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int shapeId = kernel.Map(in.Get<int>());
+        const OutputOptions opt = in.Get<OutputOptions>();
+        const std::string path = OutputPath(in.GetString());
+        if (options_.skipExport) return 0;
+        return L1_ExportShape(kernel.handle, shapeId, &opt, path.c_str());
+      }
+      case Call::kExportShapeEx: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int shapeId = kernel.Map(in.Get<int>());
+        const OutputFormat format = in.Get<OutputFormat>();
+        MeshOptions mesh{};
+        in.GetVersioned(&mesh);
+        mesh.structSize = std::min<int>(mesh.structSize, sizeof(MeshOptions));
+        const std::string path = OutputPath(in.GetString());
+        if (options_.skipExport) return 0;
+        return L1_ExportShapeEx(kernel.handle, shapeId, format, &mesh, path.c_str(), nullptr);
+      }
+      case Call::kExportStepBodies: {
+        ReplayKernel& kernel = KernelFor(tag);
+        const int count = in.Get<int>();
+        std::vector<std::string> names(static_cast<std::size_t>(std::max(count, 0)));
+        std::vector<StepBodyDto> bodies(names.size());
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+          bodies[i].shapeId  = kernel.Map(in.Get<int>());
+          names[i]           = in.GetString();
+          bodies[i].nameUtf8 = names[i].c_str();
+          bodies[i].hasColor = in.Get<int>();
+          for (double& c : bodies[i].rgb) c = in.Get<double>();
+        }
+        const std::string assemblyName = in.GetString();
+        const std::string path = OutputPath(in.GetString());
+        if (options_.skipExport) return 0;
+        return L1_ExportStepBodies(kernel.handle, bodies.data(), count, assemblyName.c_str(),
+                                   path.c_str());
+      }
+      case Call::kGetKernelOptions:
+      case Call::kValidateShape:
+      case Call::kCompareShapes:
+      case Call::kComputeMassProperties:
+      case Call::kSectionShape:
+      case Call::kQueryClearance:
+        break;  // worker protocol only; never journaled
+    }
+    throw std::runtime_error("unknown call " + std::to_string(static_cast<int>(call)));
+  }
+
+  const ReplayOptions&                  options_;
+  std::map<std::uint64_t, ReplayKernel> kernels_;
+};
+
+// ---------------------------------------------------------------------------
+// 読込・レポート
+// ---------------------------------------------------------------------------
+
+std::string ReadJournal(const std::filesystem::path& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) throw std::runtime_error("Failed to open journal: " + path.u8string());
+  std::ostringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+std::string FormatReport(const ReplayOptions& options, const std::vector<RecordRun>& runs,
+                         bool truncated) {
+  std::map<std::string, CallStats> perCall;
+  CallStats total;
+  int mismatches = 0;
+  for (const RecordRun& run : runs) {
+    CallStats& stats = perCall[l1::journal::CallName(run.call)];
+    for (CallStats* s : {&stats, &total}) {
+      ++s->count;
+      s->recordedMs += run.recordedMs;
+      s->replayMs   += run.replayMs;
+    }
+    if (run.recordedRc != run.replayRc) ++mismatches;
+  }
+
+  std::vector<const RecordRun*> slowest;
+  for (const RecordRun& run : runs) slowest.push_back(&run);
+  std::sort(slowest.begin(), slowest.end(), [](const RecordRun* a, const RecordRun* b) {
+    return a->replayMs - a->recordedMs > b->replayMs - b->recordedMs;
+  });
+  if (slowest.size() > kSlowestCount) slowest.resize(kSlowestCount);
+
+  std::string out = "{\n  \"journal\": ";
+  l1::AppendJsonString(out, options.journalPath.u8string());
+  out += ",\n  \"records\": " + std::to_string(runs.size());
+  out += ",\n  \"truncated\": " + std::string(truncated ? "true" : "false");
+  out += ",\n  \"returnCodeMismatches\": " + std::to_string(mismatches);
+  out += ",\n  \"recordedMs\": "; l1::AppendJsonNumber(out, total.recordedMs, 3);
+  out += ",\n  \"replayMs\": ";   l1::AppendJsonNumber(out, total.replayMs, 3);
+
+  out += ",\n  \"calls\": [";
+  bool first = true;
+  for (const auto& entry : perCall) {
+    out += first ? "\n    " : ",\n    ";
+    first = false;
+    out += "{\"call\": ";
+    l1::AppendJsonString(out, entry.first);
+    out += ", \"count\": " + std::to_string(entry.second.count);
+    out += ", \"recordedMs\": "; l1::AppendJsonNumber(out, entry.second.recordedMs, 3);
+    out += ", \"replayMs\": ";   l1::AppendJsonNumber(out, entry.second.replayMs, 3);
+    out += ", \"ratio\": ";
+    l1::AppendJsonNumber(out, entry.second.recordedMs > 0.0
+                                  ? entry.second.replayMs / entry.second.recordedMs : 0.0, 3);
+    out += "}";
+  }
+  out += "\n  ],\n  \"slowest\": [";
+  for (std::size_t i = 0; i < slowest.size(); ++i) {
+    const RecordRun& run = *slowest[i];
+    out += i ? ",\n    " : "\n    ";
+    out += "{\"index\": " + std::to_string(run.index) + ", \"call\": ";
+    l1::AppendJsonString(out, l1::journal::CallName(run.call));
+    out += ", \"recordedMs\": "; l1::AppendJsonNumber(out, run.recordedMs, 3);
+    out += ", \"replayMs\": ";   l1::AppendJsonNumber(out, run.replayMs, 3);
+    out += ", \"deltaMs\": ";    l1::AppendJsonNumber(out, run.replayMs - run.recordedMs, 3);
+    out += ", \"recordedRc\": " + std::to_string(run.recordedRc);
+    out += ", \"replayRc\": " + std::to_string(run.replayRc) + "}";
+  }
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+void PrintUsage() {
+  std::cerr << "Usage: occt_geometry_replay journal.l1j [--out-dir dir] [--skip-export]\n"
+               "                            [--report report.json]" << std::endl;
+}
+
+bool ParseArgs(int argc, char* argv[], ReplayOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if      (arg == "--out-dir"     && hasValue) options->outDir     = std::filesystem::u8path(argv[++i]);
+    else if (arg == "--report"      && hasValue) options->reportPath = std::filesystem::u8path(argv[++i]);
+    else if (arg == "--skip-export")             options->skipExport = true;
+    else if (arg.rfind("--", 0) != 0 && options->journalPath.empty())
+      options->journalPath = std::filesystem::u8path(arg);
+    else return false;
+  }
+  return !options->journalPath.empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ReplayOptions options;
+  if (!ParseArgs(argc, argv, &options)) {
+    PrintUsage();
+    return 1;
+  }
+  if (options.outDir.empty()) options.outDir = std::filesystem::temp_directory_path() / "l1_replay";
+
+  std::vector<RecordRun> runs;
+  bool truncated = false;
+  try {
+    std::filesystem::create_directories(options.outDir);
+    const std::string journal = ReadJournal(options.journalPath);
+
+    l1::journal::FileHeader fileHeader{};
+    if (journal.size() < sizeof(fileHeader))
+      throw std::runtime_error("Not a call journal: " + options.journalPath.u8string());
+    std::memcpy(&fileHeader, journal.data(), sizeof(fileHeader));
+    if (std::memcmp(fileHeader.magic, l1::journal::kMagic, sizeof(fileHeader.magic)) != 0 ||
+        fileHeader.version != l1::journal::kVersion ||
+        fileHeader.recordHeaderSize != sizeof(RecordHeader))
+      throw std::runtime_error("Unsupported journal format: " + options.journalPath.u8string());
+
+    Replayer replayer(options);
+    std::size_t pos = sizeof(fileHeader);
+    while (pos < journal.size()) {
+      // 停止せずに終了したプロセスの記録は末尾が欠けていることがある
+      RecordHeader header{};
+      if (journal.size() - pos < sizeof(header)) { truncated = true; break; }
+      std::memcpy(&header, journal.data() + pos, sizeof(header));
+      pos += sizeof(header);
+      if (journal.size() - pos < header.payloadSize) { truncated = true; break; }
+
+      PayloadReader payload(journal.data() + pos, header.payloadSize);
+      pos += header.payloadSize;
+      runs.push_back(replayer.Run(runs.size(), header, payload));
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+
+  const std::string report = FormatReport(options, runs, truncated);
+  if (options.reportPath.empty()) {
+    std::cout << report;
+  } else {
+    std::ofstream ofs(options.reportPath, std::ios::trunc);
+    ofs << report;
+  }
+
+  const bool mismatch = std::any_of(runs.begin(), runs.end(), [](const RecordRun& run) {
+    return run.recordedRc != run.replayRc;
+  });
+  return mismatch ? 2 : 0;
+}
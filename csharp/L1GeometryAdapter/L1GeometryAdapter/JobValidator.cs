@@ -78,6 +78,22 @@ public static class JobValidator
 					}
 					break;
 
+				case "MILL_SLOT":
+					if (feature.MillSlot is null)
+						errors.Add(Error("MISSING_PAYLOAD", $"{basePath}.millSlot", "feature.millSlot is required for type MILL_SLOT."));
+					else
+					{
+						ValidatePath2DProfile(feature.MillSlot.Path, $"{basePath}.millSlot.path", requireClosed: false, errors);
+						if (feature.MillSlot.Path is { Closed: true })
+							errors.Add(Error("PATH_CLOSED", $"{basePath}.millSlot.path.closed", "millSlot.path must be open."));
+						if (feature.MillSlot.ToolRadius <= 0)
+							errors.Add(Error("INVALID_TOOL_RADIUS", $"{basePath}.millSlot.toolRadius", "millSlot.toolRadius must be greater than 0."));
+						if (feature.MillSlot.Depth <= 0)
+							errors.Add(Error("INVALID_DEPTH", $"{basePath}.millSlot.depth", "millSlot.depth must be greater than 0."));
+						ValidateAxis(feature.MillSlot.Axis, $"{basePath}.millSlot.axis", errors);
+					}
+					break;
+
 				default:
 					errors.Add(Error("INVALID_FEATURE_TYPE", $"{basePath}.type", $"Unsupported feature.type: {feature.Type}"));
 					break;
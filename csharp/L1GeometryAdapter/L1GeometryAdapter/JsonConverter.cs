@@ -34,6 +34,7 @@ public sealed class JobJsonModel
 			DeltaStlFile  = Output.DeltaStlFile,
 			RemovalStepFile = Output.RemovalStepFile,
 			RemovalStlFile  = Output.RemovalStlFile,
+			CombinedStepFile = Output.CombinedStepFile,
 		};
 	}
 }
@@ -94,6 +95,9 @@ public sealed class FeatureJsonModel
 
 	[JsonPropertyAttribute("millContour")]
 	public MillContourJsonModel? MillContour { get; set; }
+
+	[JsonPropertyAttribute("millSlot")]
+	public MillSlotJsonModel? MillSlot { get; set; }
 }
 
 public sealed class MillHoleJsonModel
@@ -219,7 +223,7 @@ public sealed class Path2DProfileJsonModel
 }
 
 // ---------------------------------------------------------------------------
-// Turn / MillContour JSON モデル
+// Turn / MillContour / MillSlot JSON モデル
 // ---------------------------------------------------------------------------
 
 public sealed class TurnJsonModel
@@ -243,6 +247,22 @@ public sealed class MillContourJsonModel
 	public AxisJsonModel Axis { get; set; } = new();
 }
 
+// 開いた経路に沿った工具半径の溝（closed は false）
+public sealed class MillSlotJsonModel
+{
+	[JsonPropertyAttribute("path")]
+	public Path2DProfileJsonModel? Path { get; set; }
+
+	[JsonPropertyAttribute("toolRadius")]
+	public double ToolRadius { get; set; }
+
+	[JsonPropertyAttribute("depth")]
+	public double Depth { get; set; }
+
+	[JsonPropertyAttribute("axis")]
+	public AxisJsonModel Axis { get; set; } = new();
+}
+
 // ---------------------------------------------------------------------------
 // Axis JSON モデル
 // ---------------------------------------------------------------------------
@@ -315,6 +335,9 @@ public sealed class OutputJsonModel
 	[JsonPropertyAttribute("removalStlFile")]
 	public string RemovalStlFile { get; set; } = string.Empty;
 
+	[JsonPropertyAttribute("combinedStepFile")]
+	public string CombinedStepFile { get; set; } = string.Empty;
+
 	public OutputOptions ToKernelOptions() => new()
 	{
 		LinearDeflection  = LinearDeflection,
@@ -345,6 +368,7 @@ public sealed class KernelJobModel
 	public string               DeltaStlFile  { get; set; } = string.Empty;
 	public string               RemovalStepFile { get; set; } = string.Empty;
 	public string               RemovalStlFile  { get; set; } = string.Empty;
+	public string               CombinedStepFile { get; set; } = string.Empty;
 }
 
 // ---------------------------------------------------------------------------
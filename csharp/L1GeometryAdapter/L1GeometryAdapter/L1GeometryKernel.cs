@@ -91,19 +91,194 @@ namespace L1GeometryAdapter
         public ArcDirection      ArcDirection;
     }
 
+    public enum BooleanPath : int
+    {
+        Full        = 0,
+        Miss        = 1,
+        Contained   = 2,
+        TurnSection = 3,
+        Glue        = 4,
+    }
+
     [StructLayout(LayoutKind.Sequential)]
     public struct OperationResult
     {
-        public int ResultShapeId;
-        public int DeltaShapeId;
-        public int RemovalShapeId;
-        public int ErrorCode;
+        public int         StructSize;     // L1Kernel.Apply* が設定する
+        public int         ResultShapeId;
+        public int         DeltaShapeId;
+        public int         RemovalShapeId;
+        public int         ErrorCode;
+        public BooleanPath BooleanPath;
+        public int         FaceCountBefore;
+        public int         FaceCountAfter;
+    }
+
+    public enum BooleanGlueMode : int
+    {
+        Off  = 0,
+        Auto = 1,
+        On   = 2,
+    }
+
+    public enum ValidationLevel : int
+    {
+        Off       = 0,
+        Structure = 1,  // トポロジのみ（安価）
+        Closed    = 2,  // 自由エッジ・開いたシェル・公差
+        Full      = 3,  // BRepCheck_Analyzer（面単位で並列）
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct KernelOptions
+    {
+        public int             StructSize;       // L1Kernel.SetOptions が設定する
+        public int             UnifySameDomain;  // 1: ブーリアン結果の同一面・同一曲線の面/エッジを統合
+        public BooleanGlueMode GlueMode;         // 既定 Off: Auto なら素材面に一致する工具をグルーで演算
+        public ValidationLevel ValidateResults;  // 既定 Off: ブーリアン結果をこのレベルで検査
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct ValidationOptions
+    {
+        public int             StructSize;
+        public ValidationLevel Level;
+        public double          ToleranceLimit;  // <= 0: 1e-3
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ValidationReport
+    {
+        public int    StructSize;
+        public int    Valid;
+        public int    FailedLevel;
+        public int    SolidCount;
+        public int    ShellCount;
+        public int    FaceCount;
+        public int    EdgeCount;
+        public int    FreeEdgeCount;
+        public int    OpenShellCount;
+        public double MaxTolerance;
+        public int    InvalidSubShapeCount;
+        public double StructureMs;
+        public double ClosedMs;
+        public double FullMs;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CompareOptions
+    {
+        public int    StructSize;         // L1Kernel.CompareShapes が設定する
+        public double LinearDeflection;   // <= 0: 比較対象のバウンディングボックス対角の 0.1%
+        public double AngularDeflection;  // <= 0: 0.5
+        public double HistogramRange;     // ヒストグラムは [-Range, +Range]。<= 0: 最大 |偏差|
+        public int    ThreadCount;        // 0: ハードウェアスレッド数
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CompareReport
+    {
+        public const int HistogramBins = 32;  // L1_DEVIATION_HISTOGRAM_BINS
+
+        public int    StructSize;
+        public int    SampleCount;             // 比較対象の面上の標本点数（頂点 + 大きい三角形内の格子点）
+        public int    ReferenceTriangleCount;
+        public double MinDeviation;            // 負: 参照より内側（削りすぎ）
+        public double MaxDeviation;            // 正: 参照より外側（削り残し）
+        public double MeanDeviation;
+        public double MeanAbsDeviation;
+        public double RmsDeviation;
+        public double HistogramRange;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = HistogramBins)]
+        public int[]  Histogram;
+        public double MeshMs;
+        public double BvhMs;
+        public double QueryMs;                 // 両方向
+        public int    ReverseSampleCount;      // 参照の面上の標本点数
+        public double ReverseMaxAbsDeviation;  // 参照の標本点から比較対象までの最大距離
+        public double HausdorffDistance;       // 対称ハウスドルフ距離（両方向の大きい方）
+    }
+
+    public enum MassMode : int
+    {
+        Exact = 0,  // B-rep 面の厳密な積分
+        Fast  = 1,  // メッシュ上の積分（誤差は Tolerance で抑える）
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct MassPropertiesOptions
+    {
+        public int      StructSize;
+        public MassMode Mode;
+        public double   Tolerance;    // Fast: バウンディングボックス対角に対する相対たわみ。<= 0: 1e-3
+        public int      ThreadCount;  // 0: ハードウェアスレッド数
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MassProperties
+    {
+        public int    ShapeId;
+        public int    ErrorCode;  // この Shape の結果（0: 成功）
+        public double Volume;
+        public double Area;
+        public Vec3   Centroid;   // 体積の重心（体積 0 のときは表面の重心）
+        public double Tolerance;  // 0: 厳密、それ以外は使った相対たわみ
+        public int    Cached;     // 1: Registry のキャッシュから返した
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct SectionOptions
+    {
+        public int     StructSize;
+        public AxisDto Axis;            // 平面 k は Origin + k * Spacing * Dir を通り法線 Dir。u: Xdir, v: Dir × Xdir
+        public int     PlaneCount;      // >= 1
+        public double  Spacing;         // 平面の間隔（PlaneCount >= 2 では 0 以外）
+        public double  ChordTolerance;  // 直線・円以外の曲線を折れ線にする許容差。<= 0: 0.01
+        public int     ThreadCount;     // 0: ハードウェアスレッド数
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SectionPlane
+    {
+        public double Offset;        // Axis.Origin から Dir 方向の距離
+        public int    ErrorCode;     // この平面の結果（0: 成功）
+        public int    FirstSegment;  // Segments 配列内の先頭
+        public int    SegmentCount;
+        public int    ChainCount;    // 連続したセグメント列の数
+        public int    Closed;        // 1: すべてのチェーンが閉じている
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct ClearanceOptions
+    {
+        public int    StructSize;
+        public double MaxDistance;  // これより離れていれば測らない（Far）。<= 0: 常に測る
+        public int    ThreadCount;  // 0: ハードウェアスレッド数
+    }
+
+    public enum ClearanceState : int
+    {
+        Clear     = 0,  // 離れている（Distance が最小クリアランス）
+        Far       = 1,  // MaxDistance より離れている（Distance はバウンディングボックスによる下限）
+        Contact   = 2,  // 境界が接触・交差している（干渉）
+        Contained = 3,  // 一方が他方の内部にある（干渉）
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ClearanceResult
+    {
+        public int            ErrorCode;  // この配置の結果（0: 成功）
+        public ClearanceState State;
+        public double         Distance;
+        public Vec3           PointA;     // Shape 上の最近点（Clear / Contact のみ）
+        public Vec3           PointB;     // 配置した相手 Shape 上の最近点
+        public double         QueryMs;
     }
 
     public enum OutputFormat : int
     {
-        Step = 1,
-        Stl  = 2,
+        Step  = 1,
+        Stl   = 2,
+        QMesh = 3,  // 量子化・圧縮メッシュ（wwwroot/qmesh-decoder.js で復元）
     }
 
     [StructLayout(LayoutKind.Sequential)]
@@ -115,6 +290,80 @@ namespace L1GeometryAdapter
         public int          Parallel;
     }
 
+    public enum MeshAlgorithm : int
+    {
+        Default   = 0,
+        Watson    = 1,
+        Delabella = 2,
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MeshOptions
+    {
+        public int           StructSize;          // L1Kernel.ExportShape が設定する
+        public double        LinearDeflection;    // 絶対値（RelativeDeflection <= 0 のとき）
+        public double        RelativeDeflection;  // > 0: バウンディングボックス対角長に対する比
+        public double        AngularDeflection;
+        public double        MinSize;             // <= 0: メッシャーが決定
+        public int           TriangleBudget;      // > 0: 収まるまでたわみを粗くする（最大 4 回）
+        public MeshAlgorithm Algorithm;
+        public int           Parallel;
+        public int           PositionBits;        // QMesh: 座標あたりのビット数 1..16（0: 16）
+        public int           OctNormals;          // QMesh: 1: 八面体符号化の法線を付ける
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MeshStats
+    {
+        public int    StructSize;
+        public int    TriangleCount;
+        public int    NodeCount;
+        public int    Passes;
+        public double LinearDeflection;
+        public double MeshMs;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ImportOptions
+    {
+        public int    StructSize;       // L1Kernel.ImportStep が設定する
+        public int    Heal;             // 1: ShapeFix・微小エッジ除去・ワイヤ隙間修正
+        public double Tolerance;        // > 0: 修正精度、公差の上限
+        public int    UnifySameDomain;  // 1: 同一面・同一曲線の統合
+        public int    ExtractSolids;    // 1: ソリッドのみ残す
+        public int    NoCache;          // 1: キャッシュを使わず読み直す
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StepBodyDto
+    {
+        public int    ShapeId;
+        [MarshalAs(UnmanagedType.LPUTF8Str)]
+        public string? NameUtf8;  // null / 空: "body_<ShapeId>"
+        public int    HasColor;   // 1: R/G/B を色として出力
+        public double R;          // 0..1
+        public double G;
+        public double B;
+    }
+
+    /// <summary>箱素材の近似 Z マッププレビュー（ステージ送りの対話表示用）。</summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PreviewGridOptions
+    {
+        public double CellSize;     // 格子間隔（モデル単位）
+        public int    ThreadCount;  // 0: ハードウェア並列数
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct StageMeshOptions
+    {
+        public int StructSize;   // L1Kernel.BuildStageMeshes が設定する
+        public int ThreadCount;  // 0: ハードウェア並列数 - 1
+        [MarshalAs(UnmanagedType.LPUTF8Str)]
+        public string OutDirUtf8;
+        public OutputFormat Format;  // Stl / QMesh
+    }
+
     // ---------------------------------------------------------------
     // Raw P/Invoke  (internal — 呼び出し側は L1Kernel を使う)
     // ---------------------------------------------------------------
@@ -129,6 +378,15 @@ namespace L1GeometryAdapter
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_DestroyKernel(IntPtr kernel);
 
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ForkKernel(IntPtr kernel, out IntPtr outKernel);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ResetKernel(IntPtr kernel);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_SetKernelOptions(IntPtr kernel, ref KernelOptions opt);
+
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_CreateStock(IntPtr kernel, ref StockDto dto, out int outStockId);
 
@@ -136,27 +394,27 @@ namespace L1GeometryAdapter
         internal static extern int L1_ApplyMillHole(
             IntPtr kernel, int stockId,
             ref MillHoleFeatureDto dto,
-            out OperationResult outResult);
+            ref OperationResult outResult);
 
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_ApplyPocketRect(
             IntPtr kernel, int stockId,
             ref PocketRectFeatureDto dto,
-            out OperationResult outResult);
+            ref OperationResult outResult);
 
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_ApplyTurnOd(
             IntPtr kernel, int stockId,
             ref AxisDto axis,
             [In] Path2DSegmentDto[] segments, int segmentCount, int closed,
-            out OperationResult outResult);
+            ref OperationResult outResult);
 
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_ApplyTurnId(
             IntPtr kernel, int stockId,
             ref AxisDto axis,
             [In] Path2DSegmentDto[] segments, int segmentCount, int closed,
-            out OperationResult outResult);
+            ref OperationResult outResult);
 
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_ApplyMillContour(
@@ -164,22 +422,141 @@ namespace L1GeometryAdapter
             ref AxisDto axis,
             [In] Path2DSegmentDto[] segments, int segmentCount, int closed,
             double depth,
-            out OperationResult outResult);
+            ref OperationResult outResult);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ApplyMillSlot(
+            IntPtr kernel, int stockId,
+            ref AxisDto axis,
+            [In] Path2DSegmentDto[] segments, int segmentCount,
+            double toolRadius, double depth,
+            ref OperationResult outResult);
 
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
         internal static extern int L1_DeleteShape(IntPtr kernel, int shapeId);
 
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ValidateShape(
+            IntPtr kernel, int shapeId,
+            ref ValidationOptions opt,
+            ref ValidationReport outReport);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_CompareShapes(
+            IntPtr kernel, int shapeId, int referenceId,
+            ref CompareOptions opt,
+            [MarshalAs(UnmanagedType.LPUTF8Str)] string? deviationMeshFileUtf8,
+            ref CompareReport outReport);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ComputeMassProperties(
+            IntPtr kernel,
+            [In] int[] shapeIds, int shapeCount,
+            ref MassPropertiesOptions opt,
+            [Out] MassProperties[] outProps);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_SectionShape(
+            IntPtr kernel, int shapeId,
+            ref SectionOptions opt,
+            [Out] SectionPlane[] outPlanes,
+            [Out] Path2DSegmentDto[]? outSegments, int segmentCapacity,
+            out int outSegmentCount);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_QueryClearance(
+            IntPtr kernel, int shapeId, int otherId,
+            [In] Vec3[]? offsets, int placementCount,
+            ref ClearanceOptions opt,
+            [Out] ClearanceResult[] outResults);
+
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         internal static extern int L1_ImportStepAsShape(
             IntPtr kernel,
             string filePathUtf8,
             out int outShapeId);
 
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int L1_ImportStepAsShapeEx(
+            IntPtr kernel,
+            string filePathUtf8,
+            ref ImportOptions opt,
+            out int outShapeId);
+
         [DllImport(Dll, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         internal static extern int L1_ExportShape(
             IntPtr kernel, int shapeId,
             ref OutputOptions opt,
             string filePathUtf8);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int L1_ExportShapeEx(
+            IntPtr kernel, int shapeId,
+            OutputFormat format, ref MeshOptions mesh,
+            string filePathUtf8,
+            ref MeshStats outStats);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ExportStepBodies(
+            IntPtr kernel,
+            [In] StepBodyDto[] bodies, int bodyCount,
+            [MarshalAs(UnmanagedType.LPUTF8Str)] string? assemblyNameUtf8,
+            [MarshalAs(UnmanagedType.LPUTF8Str)] string filePathUtf8);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_BuildStageMeshes(
+            [MarshalAs(UnmanagedType.LPUTF8Str)] string jobJsonUtf8,
+            ref StageMeshOptions opt,
+            out IntPtr outResultJson);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_CreatePreviewGrid(
+            IntPtr kernel, ref StockDto stock, ref PreviewGridOptions opt, out int outPreviewId);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_ClonePreviewGrid(IntPtr kernel, int previewId, out int outPreviewId);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_DeletePreviewGrid(IntPtr kernel, int previewId);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_PreviewMillHole(IntPtr kernel, int previewId, ref MillHoleFeatureDto dto);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_PreviewPocketRect(IntPtr kernel, int previewId, ref PocketRectFeatureDto dto);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern int L1_PreviewMillContour(
+            IntPtr kernel, int previewId,
+            ref AxisDto axis,
+            [In] Path2DSegmentDto[] segments, int segmentCount, int closed,
+            double depth);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int L1_ExportPreviewStl(
+            IntPtr kernel, int previewId,
+            string filePathUtf8);
+
+        [DllImport(Dll, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern void L1_FreeString(IntPtr text);
+
+        // --- Worker pool (l1_geometry_remote) ---
+
+        private const string RemoteDll = "l1_geometry_remote";
+        private static int _redirected;
+
+        /// <summary>以後の l1_geometry_kernel への P/Invoke を l1_geometry_remote に向ける（最初の呼び出し前のみ有効）。</summary>
+        internal static void RedirectToRemote()
+        {
+            if (Interlocked.Exchange(ref _redirected, 1) != 0) return;
+            NativeLibrary.SetDllImportResolver(typeof(L1GeometryKernelNative).Assembly,
+                (name, assembly, searchPath) => name == Dll
+                    ? NativeLibrary.Load(RemoteDll, assembly, searchPath)
+                    : IntPtr.Zero);
+        }
+
+        [DllImport(RemoteDll, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
+        internal static extern int L1_SetWorkerEndpoint(string socketPathUtf8, int workerCount);
     }
 
     // ---------------------------------------------------------------
@@ -200,6 +577,53 @@ namespace L1GeometryAdapter
                 throw new InvalidOperationException("L1_CreateKernel failed.");
         }
 
+        private L1Kernel(IntPtr handle, Stack<int> trackedShapes)
+        {
+            _handle = handle;
+            _trackedShapes = trackedShapes;
+        }
+
+        /// <summary>
+        /// 以後のカーネルを occt_geometry_worker のプロセス上で動かす（プロセス内で最初の L1Kernel 生成前に呼ぶ）。
+        /// workerCount = 0 は単体ワーカーのソケット、N は --pool N で起動したプールの基底パス。
+        /// </summary>
+        public static void UseWorkerPool(string socketPath, int workerCount)
+        {
+            L1GeometryKernelNative.RedirectToRemote();
+            int rc = L1GeometryKernelNative.L1_SetWorkerEndpoint(socketPath, workerCount);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_SetWorkerEndpoint));
+        }
+
+        /// <summary>
+        /// 現在の Shape を同じ ID のまま参照で共有する新しいカーネル（設定も引き継ぐ）。
+        /// 親と別スレッドで同時に使え、それぞれ Dispose する。
+        /// </summary>
+        public L1Kernel Fork()
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_ForkKernel(_handle, out IntPtr fork);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ForkKernel));
+            return new L1Kernel(fork, new Stack<int>(_trackedShapes.Reverse()));
+        }
+
+        /// <summary>全 Shape を破棄して新規カーネル相当に戻す（内部アロケータは再利用）。</summary>
+        public void Reset()
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_ResetKernel(_handle);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ResetKernel));
+            _trackedShapes.Clear();
+        }
+
+        /// <summary>以後に開始する演算へ適用するカーネル設定。</summary>
+        public void SetOptions(KernelOptions opt)
+        {
+            ThrowIfDisposed();
+            opt.StructSize = Marshal.SizeOf<KernelOptions>();
+            int rc = L1GeometryKernelNative.L1_SetKernelOptions(_handle, ref opt);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_SetKernelOptions));
+        }
+
         // --- Stock ---
 
         public int CreateStock(ref StockDto dto)
@@ -216,7 +640,8 @@ namespace L1GeometryAdapter
         public OperationResult ApplyMillHole(int stockId, MillHoleFeatureDto dto)
         {
             ThrowIfDisposed();
-            int rc = L1GeometryKernelNative.L1_ApplyMillHole(_handle, stockId, ref dto, out var result);
+            var result = NewResult();
+            int rc = L1GeometryKernelNative.L1_ApplyMillHole(_handle, stockId, ref dto, ref result);
             ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ApplyMillHole));
             TrackResult(result);
             return result;
@@ -225,7 +650,8 @@ namespace L1GeometryAdapter
         public OperationResult ApplyPocketRect(int stockId, PocketRectFeatureDto dto)
         {
             ThrowIfDisposed();
-            int rc = L1GeometryKernelNative.L1_ApplyPocketRect(_handle, stockId, ref dto, out var result);
+            var result = NewResult();
+            int rc = L1GeometryKernelNative.L1_ApplyPocketRect(_handle, stockId, ref dto, ref result);
             ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ApplyPocketRect));
             TrackResult(result);
             return result;
@@ -235,9 +661,10 @@ namespace L1GeometryAdapter
                                            Path2DSegmentDto[] segments, bool closed)
         {
             ThrowIfDisposed();
+            var result = NewResult();
             int rc = L1GeometryKernelNative.L1_ApplyTurnOd(
                 _handle, stockId, ref axis, segments, segments.Length, closed ? 1 : 0,
-                out var result);
+                ref result);
             ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ApplyTurnOd));
             TrackResult(result);
             return result;
@@ -247,9 +674,10 @@ namespace L1GeometryAdapter
                                            Path2DSegmentDto[] segments, bool closed)
         {
             ThrowIfDisposed();
+            var result = NewResult();
             int rc = L1GeometryKernelNative.L1_ApplyTurnId(
                 _handle, stockId, ref axis, segments, segments.Length, closed ? 1 : 0,
-                out var result);
+                ref result);
             ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ApplyTurnId));
             TrackResult(result);
             return result;
@@ -260,14 +688,148 @@ namespace L1GeometryAdapter
                                                 double depth)
         {
             ThrowIfDisposed();
+            var result = NewResult();
             int rc = L1GeometryKernelNative.L1_ApplyMillContour(
                 _handle, stockId, ref axis, segments, segments.Length, closed ? 1 : 0,
-                depth, out var result);
+                depth, ref result);
             ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ApplyMillContour));
             TrackResult(result);
             return result;
         }
 
+        /// <summary>開いた経路 segments に沿って半径 toolRadius の工具で深さ depth の溝を加工する。</summary>
+        public OperationResult ApplyMillSlot(int stockId, AxisDto axis,
+                                             Path2DSegmentDto[] segments,
+                                             double toolRadius, double depth)
+        {
+            ThrowIfDisposed();
+            var result = NewResult();
+            int rc = L1GeometryKernelNative.L1_ApplyMillSlot(
+                _handle, stockId, ref axis, segments, segments.Length,
+                toolRadius, depth, ref result);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ApplyMillSlot));
+            TrackResult(result);
+            return result;
+        }
+
+        // --- Validation ---
+
+        /// <summary>指定レベルまで順に検査する。不正な形状でも例外にはならず、結果は Report に入る。</summary>
+        public ValidationReport ValidateShape(int shapeId, ValidationLevel level, double toleranceLimit = 0.0)
+        {
+            ThrowIfDisposed();
+            var opt = new ValidationOptions
+            {
+                StructSize     = Marshal.SizeOf<ValidationOptions>(),
+                Level          = level,
+                ToleranceLimit = toleranceLimit,
+            };
+            var report = new ValidationReport { StructSize = Marshal.SizeOf<ValidationReport>() };
+            int rc = L1GeometryKernelNative.L1_ValidateShape(_handle, shapeId, ref opt, ref report);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ValidateShape));
+            return report;
+        }
+
+        /// <summary>shapeId のメッシュ頂点ごとに referenceId の面までの符号付き偏差を測る。deviationMeshPath を指定すると偏差付き QMesh を書く。</summary>
+        public CompareReport CompareShapes(int shapeId, int referenceId, CompareOptions opt,
+                                           string? deviationMeshPath = null)
+        {
+            ThrowIfDisposed();
+            opt.StructSize = Marshal.SizeOf<CompareOptions>();
+            var report = new CompareReport
+            {
+                StructSize = Marshal.SizeOf<CompareReport>(),
+                Histogram  = new int[CompareReport.HistogramBins],
+            };
+            int rc = L1GeometryKernelNative.L1_CompareShapes(_handle, shapeId, referenceId, ref opt,
+                                                             deviationMeshPath, ref report);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_CompareShapes));
+            return report;
+        }
+
+        // --- Mass properties ---
+
+        /// <summary>各 Shape の体積・表面積・重心を並列に求める（Shape ごとにキャッシュされ、2 回目以降は計算しない）。</summary>
+        public MassProperties[] ComputeMassProperties(int[] shapeIds, MassMode mode = MassMode.Exact,
+                                                      double tolerance = 0.0, int threadCount = 0)
+        {
+            ThrowIfDisposed();
+            var opt = new MassPropertiesOptions
+            {
+                StructSize  = Marshal.SizeOf<MassPropertiesOptions>(),
+                Mode        = mode,
+                Tolerance   = tolerance,
+                ThreadCount = threadCount,
+            };
+            var props = new MassProperties[shapeIds.Length];
+            int rc = L1GeometryKernelNative.L1_ComputeMassProperties(_handle, shapeIds, shapeIds.Length,
+                                                                     ref opt, props);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ComputeMassProperties));
+            return props;
+        }
+
+        // --- Section ---
+
+        private const int ErrorBufferTooSmall = 14;
+
+        /// <summary>
+        /// Shape を平行な平面群で切り、各平面の (u,v) 座標のセグメントを返す。
+        /// 平面 k のセグメントは Segments[Planes[k].FirstSegment ..] の Planes[k].SegmentCount 本。
+        /// </summary>
+        public (SectionPlane[] Planes, Path2DSegmentDto[] Segments) SectionShape(
+            int shapeId, AxisDto axis, int planeCount = 1, double spacing = 0.0,
+            double chordTolerance = 0.0, int threadCount = 0)
+        {
+            ThrowIfDisposed();
+            var opt = new SectionOptions
+            {
+                StructSize     = Marshal.SizeOf<SectionOptions>(),
+                Axis           = axis,
+                PlaneCount     = planeCount,
+                Spacing        = spacing,
+                ChordTolerance = chordTolerance,
+                ThreadCount    = threadCount,
+            };
+            var planes   = new SectionPlane[Math.Max(planeCount, 0)];
+            var segments = new Path2DSegmentDto[64 * Math.Max(planeCount, 1)];
+            int rc = L1GeometryKernelNative.L1_SectionShape(_handle, shapeId, ref opt, planes,
+                                                            segments, segments.Length, out int count);
+            if (rc == ErrorBufferTooSmall)
+            {
+                // 足りなければ総数ぶん確保して計算し直す
+                segments = new Path2DSegmentDto[count];
+                rc = L1GeometryKernelNative.L1_SectionShape(_handle, shapeId, ref opt, planes,
+                                                            segments, segments.Length, out count);
+            }
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_SectionShape));
+            Array.Resize(ref segments, count);
+            return (planes, segments);
+        }
+
+        // --- Clearance ---
+
+        /// <summary>
+        /// otherId を offsets の各位置へ平行移動したときに shapeId と干渉するか、しないならクリアランスを求める。
+        /// offsets が null なら登録時の位置で 1 回だけ調べる。形状は変更しない。
+        /// </summary>
+        public ClearanceResult[] QueryClearance(int shapeId, int otherId, Vec3[]? offsets = null,
+                                                double maxDistance = 0.0, int threadCount = 0)
+        {
+            ThrowIfDisposed();
+            var opt = new ClearanceOptions
+            {
+                StructSize  = Marshal.SizeOf<ClearanceOptions>(),
+                MaxDistance = maxDistance,
+                ThreadCount = threadCount,
+            };
+            int count = offsets?.Length ?? 1;
+            var results = new ClearanceResult[count];
+            int rc = L1GeometryKernelNative.L1_QueryClearance(_handle, shapeId, otherId, offsets, count,
+                                                              ref opt, results);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_QueryClearance));
+            return results;
+        }
+
         // --- Export ---
 
         public int ImportStep(string filePath)
@@ -279,6 +841,17 @@ namespace L1GeometryAdapter
             return shapeId;
         }
 
+        /// <summary>取り込み時に修正・公差調整・面統合・ソリッド抽出を 1 回だけ行う。前処理済み形状はプロセス内でキャッシュされる。</summary>
+        public int ImportStep(string filePath, ImportOptions opt)
+        {
+            ThrowIfDisposed();
+            opt.StructSize = Marshal.SizeOf<ImportOptions>();
+            int rc = L1GeometryKernelNative.L1_ImportStepAsShapeEx(_handle, filePath, ref opt, out int shapeId);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ImportStepAsShapeEx));
+            _trackedShapes.Push(shapeId);
+            return shapeId;
+        }
+
         public void ExportShape(int shapeId, OutputOptions opt, string filePath)
         {
             ThrowIfDisposed();
@@ -286,6 +859,115 @@ namespace L1GeometryAdapter
             ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ExportShape));
         }
 
+        public MeshStats ExportShape(int shapeId, OutputFormat format, MeshOptions mesh, string filePath)
+        {
+            ThrowIfDisposed();
+            mesh.StructSize = Marshal.SizeOf<MeshOptions>();
+            var stats = new MeshStats { StructSize = Marshal.SizeOf<MeshStats>() };
+            int rc = L1GeometryKernelNative.L1_ExportShapeEx(_handle, shapeId, format, ref mesh, filePath, ref stats);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ExportShapeEx));
+            return stats;
+        }
+
+        /// <summary>
+        /// 複数の Shape を 1 つの STEP に名前・色付きで出力する（書き出しセッションは 1 回）。
+        /// assemblyName を指定するとその名前のアセンブリの構成部品として出力する。
+        /// </summary>
+        public void ExportStepBodies(StepBodyDto[] bodies, string filePath, string? assemblyName = null)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_ExportStepBodies(_handle, bodies, bodies.Length, assemblyName, filePath);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ExportStepBodies));
+        }
+
+        // --- Stage preview ---
+
+        /// <summary>
+        /// ジョブ JSON の素材と全ステージの result / delta / removal を outDir に STL（または QMesh）出力する。
+        /// 戻り値はファイル一覧とステージ別時間の JSON（失敗したステージは JSON の errorCode に入る）。
+        /// </summary>
+        public static string BuildStageMeshes(string jobJson, string outDir, int threadCount = 0,
+                                              OutputFormat format = OutputFormat.Stl)
+        {
+            var opt = new StageMeshOptions
+            {
+                StructSize = Marshal.SizeOf<StageMeshOptions>(),
+                ThreadCount = threadCount,
+                OutDirUtf8 = outDir,
+                Format = format,
+            };
+            int rc = L1GeometryKernelNative.L1_BuildStageMeshes(jobJson, ref opt, out IntPtr json);
+            if (json == IntPtr.Zero)
+                ThrowIfError(rc == 0 ? -1 : rc, nameof(L1GeometryKernelNative.L1_BuildStageMeshes));
+            try
+            {
+                return Marshal.PtrToStringUTF8(json) ?? string.Empty;
+            }
+            finally
+            {
+                L1GeometryKernelNative.L1_FreeString(json);
+            }
+        }
+
+        // --- Z-map preview ---
+        // プレビューグリッドはカーネルに属し、カーネル破棄時に一緒に破棄される。
+
+        /// <summary>箱素材（StockDto.Type = Box）の上面の Z マップを作る。戻り値はプレビュー ID。</summary>
+        public int CreatePreviewGrid(StockDto stock, PreviewGridOptions opt)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_CreatePreviewGrid(_handle, ref stock, ref opt, out int previewId);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_CreatePreviewGrid));
+            return previewId;
+        }
+
+        /// <summary>ステージの分岐用に複製する。</summary>
+        public int ClonePreviewGrid(int previewId)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_ClonePreviewGrid(_handle, previewId, out int cloneId);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ClonePreviewGrid));
+            return cloneId;
+        }
+
+        public void DeletePreviewGrid(int previewId)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_DeletePreviewGrid(_handle, previewId);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_DeletePreviewGrid));
+        }
+
+        public void PreviewMillHole(int previewId, MillHoleFeatureDto dto)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_PreviewMillHole(_handle, previewId, ref dto);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_PreviewMillHole));
+        }
+
+        public void PreviewPocketRect(int previewId, PocketRectFeatureDto dto)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_PreviewPocketRect(_handle, previewId, ref dto);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_PreviewPocketRect));
+        }
+
+        public void PreviewMillContour(int previewId, AxisDto axis,
+                                       Path2DSegmentDto[] segments, bool closed, double depth)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_PreviewMillContour(
+                _handle, previewId, ref axis, segments, segments.Length, closed ? 1 : 0, depth);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_PreviewMillContour));
+        }
+
+        /// <summary>柱状の表面をバイナリ STL（ワールド座標）で出力する。</summary>
+        public void ExportPreviewStl(int previewId, string filePath)
+        {
+            ThrowIfDisposed();
+            int rc = L1GeometryKernelNative.L1_ExportPreviewStl(_handle, previewId, filePath);
+            ThrowIfError(rc, nameof(L1GeometryKernelNative.L1_ExportPreviewStl));
+        }
+
         // --- IDisposable ---
 
         public void Dispose()
@@ -301,6 +983,9 @@ namespace L1GeometryAdapter
 
         // --- helpers ---
 
+        private static OperationResult NewResult() =>
+            new OperationResult { StructSize = Marshal.SizeOf<OperationResult>() };
+
         private void TrackResult(OperationResult result)
         {
             TrackShape(result.ResultShapeId);
@@ -67,6 +67,11 @@ namespace L1GeometryAdapter
                     kernel.ExportShape(finalResult.RemovalShapeId, stepOpt, removalStepPath);
                 if (removalStlPath is not null)
                     kernel.ExportShape(finalResult.RemovalShapeId, stlOpt, removalStlPath);
+                string? combinedStepPath = string.IsNullOrWhiteSpace(job.CombinedStepFile)
+                    ? null
+                    : Path.Combine(outDir, job.CombinedStepFile);
+                if (combinedStepPath is not null)
+                    kernel.ExportStepBodies(CombinedBodies(finalResult), combinedStepPath, "job");
 
                 Console.WriteLine($"Generated: {stepPath}");
                 Console.WriteLine($"Generated: {stlPath}");
@@ -76,6 +81,8 @@ namespace L1GeometryAdapter
                     Console.WriteLine($"Generated: {removalStepPath}");
                 if (removalStlPath is not null)
                     Console.WriteLine($"Generated: {removalStlPath}");
+                if (combinedStepPath is not null)
+                    Console.WriteLine($"Generated: {combinedStepPath}");
                 return 0;
             }
             catch (Exception ex)
@@ -86,6 +93,19 @@ namespace L1GeometryAdapter
 
         }
 
+        // result / delta / removal を 1 つの STEP にまとめる（removal は無い場合がある）
+        private static StepBodyDto[] CombinedBodies(OperationResult result)
+        {
+            var bodies = new List<StepBodyDto>
+            {
+                new() { ShapeId = result.ResultShapeId, NameUtf8 = "result", HasColor = 1, R = 0.75, G = 0.75, B = 0.75 },
+                new() { ShapeId = result.DeltaShapeId,  NameUtf8 = "delta",  HasColor = 1, R = 0.90, G = 0.45, B = 0.20 },
+            };
+            if (result.RemovalShapeId > 0)
+                bodies.Add(new() { ShapeId = result.RemovalShapeId, NameUtf8 = "removal", HasColor = 1, R = 0.25, G = 0.50, B = 0.90 });
+            return bodies.ToArray();
+        }
+
         private static OperationResult ApplyFeature(L1Kernel kernel, int stockId, FeatureJsonModel feature)
         {
             var type = (feature.Type ?? string.Empty).ToUpperInvariant();
@@ -98,6 +118,7 @@ namespace L1GeometryAdapter
                 "TURN_ID"     => ApplyTurn(kernel, stockId, feature.TurnId!,
                                            (id, axis, segs, closed) => kernel.ApplyTurnId(id, axis, segs, closed)),
                 "MILL_CONTOUR" => ApplyMillContour(kernel, stockId, feature.MillContour!),
+                "MILL_SLOT"    => ApplyMillSlot(kernel, stockId, feature.MillSlot!),
                 _ => throw new InvalidOperationException($"Unsupported feature.type: {feature.Type}"),
             };
         }
@@ -117,6 +138,14 @@ namespace L1GeometryAdapter
             return kernel.ApplyMillContour(stockId, mc.Axis.ToKernel(),
                                            mc.Profile.ToKernelSegments(), mc.Profile.Closed, mc.Depth);
         }
+
+        private static OperationResult ApplyMillSlot(L1Kernel kernel, int stockId, MillSlotJsonModel slot)
+        {
+            if (slot.Path is null)
+                throw new InvalidOperationException("millSlot path is required.");
+            return kernel.ApplyMillSlot(stockId, slot.Axis.ToKernel(),
+                                        slot.Path.ToKernelSegments(), slot.ToolRadius, slot.Depth);
+        }
     }
 
 }
@@ -1,3 +1,4 @@
+using System.Text.Json;
 using L1GeometryAdapter;
 using Microsoft.AspNetCore.StaticFiles;
 
@@ -21,11 +22,14 @@ app.UseStaticFiles();
 app.MapJobApi();
 app.MapPreviewBridgeApi();
 
+var outputContentTypes = new FileExtensionContentTypeProvider();
+outputContentTypes.Mappings[".qmesh"] = "application/octet-stream";
+
 app.UseStaticFiles(new StaticFileOptions
 {
 	FileProvider = new Microsoft.Extensions.FileProviders.PhysicalFileProvider(outputRoot),
 	RequestPath = "/output",
-	ContentTypeProvider = new FileExtensionContentTypeProvider(),
+	ContentTypeProvider = outputContentTypes,
 });
 
 app.MapGet("/pipeline/final-stl/{runId}/{fileName}", (string runId, string fileName) =>
@@ -237,6 +241,66 @@ app.MapPost("/pipeline/preview", (PreviewStageRequest request) =>
 	}
 });
 
+// 全ステージの STL を一括生成する（ブーリアンと並行してメッシュ化されるため、順に /pipeline/preview を呼ぶより速い）
+app.MapPost("/pipeline/preview-stages", (PreviewStagesRequest request) =>
+{
+	try
+	{
+		var previewId = $"stages-{DateTime.UtcNow:yyyyMMddHHmmssfff}-{Guid.NewGuid():N}";
+		var previewDir = Path.Combine(previewRoot, previewId);
+		Directory.CreateDirectory(previewDir);
+
+		var format = string.Equals(request.Format, "qmesh", StringComparison.OrdinalIgnoreCase)
+			? OutputFormat.QMesh
+			: OutputFormat.Stl;
+		var jobJson = JsonSerializer.Serialize(request.Job);
+		var resultJson = L1Kernel.BuildStageMeshes(jobJson, previewDir, format: format);
+		using var result = JsonDocument.Parse(resultJson);
+		var root = result.RootElement;
+		if (root.TryGetProperty("error", out var parseError))
+			return Results.BadRequest(new { error = parseError.GetString() });
+
+		string? FileUrl(JsonElement parent, string key) =>
+			parent.TryGetProperty(key, out var mesh) && mesh.ValueKind == JsonValueKind.Object
+				&& mesh.GetProperty("errorCode").GetInt32() == 0
+				? $"/output/preview/{previewId}/{mesh.GetProperty("file").GetString()}"
+				: null;
+
+		var stages = new List<PreviewStageResponse>();
+		foreach (var stage in root.GetProperty("stages").EnumerateArray())
+		{
+			var modelUrl = FileUrl(stage, "result");
+			if (modelUrl is null)
+				break;
+			stages.Add(new PreviewStageResponse
+			{
+				StageIndex = stage.GetProperty("index").GetInt32(),
+				ModelStlUrl = modelUrl,
+				DeltaStlUrl = FileUrl(stage, "delta"),
+				RemovalStlUrl = FileUrl(stage, "removal"),
+			});
+		}
+
+		CleanupOldDirectories(previewRoot, TimeSpan.FromMinutes(10));
+
+		return Results.Ok(new PreviewStagesResponse
+		{
+			ErrorCode = root.GetProperty("errorCode").GetInt32(),
+			Format = format == OutputFormat.QMesh ? "qmesh" : "stl",
+			StockStlUrl = FileUrl(root, "stock"),
+			Stages = stages,
+		});
+	}
+	catch (InvalidOperationException ex)
+	{
+		return Results.BadRequest(new { error = ex.Message });
+	}
+	catch (Exception ex)
+	{
+		return Results.Problem(title: "Stage preview generation failed", detail: ex.Message, statusCode: 500);
+	}
+});
+
 app.MapPost("/pipeline/reference-step", async (HttpRequest request) =>
 {
 	if (!request.HasFormContentType)
@@ -284,14 +348,7 @@ app.MapPost("/pipeline/reference-step", async (HttpRequest request) =>
 
 		kernel.ExportShape(shapeId, stlOpt, stlPath);
 
-		try
-		{
-			System.IO.File.Delete(stepPath);
-		}
-		catch
-		{
-		}
-
+		// STEP は /pipeline/compare-reference のために残す（ディレクトリごと 10 分で削除）
 		CleanupOldDirectories(Path.Combine(outputRoot, "reference"), TimeSpan.FromMinutes(10));
 
 		return Results.Ok(new ReferenceStepResponse
@@ -310,6 +367,60 @@ app.MapPost("/pipeline/reference-step", async (HttpRequest request) =>
 	}
 });
 
+// ジョブの最終形状と取り込み済み参照 STEP の偏差を測り、偏差付き QMesh（wwwroot/qmesh-decoder.js の scalars）を返す
+app.MapPost("/pipeline/compare-reference", (CompareReferenceRequest request) =>
+{
+	try
+	{
+		var referenceId = request.ReferenceId ?? string.Empty;
+		if (referenceId.Length == 0 || referenceId != Path.GetFileName(referenceId))
+			return Results.BadRequest(new { error = "referenceId is invalid." });
+
+		var refDir = Path.Combine(outputRoot, "reference", referenceId);
+		var stepPath = Directory.Exists(refDir)
+			? Directory.EnumerateFiles(refDir).FirstOrDefault(f =>
+				Path.GetExtension(f).ToLowerInvariant() is ".step" or ".stp")
+			: null;
+		if (stepPath is null)
+			return Results.NotFound(new { error = "Reference STEP not found or expired." });
+
+		var deviationFile = $"deviation-{Guid.NewGuid():N}.qmesh";
+
+		using var kernel = new L1Kernel();
+		var replay = ReplayJob(kernel, request.Job);
+		var referenceShapeId = kernel.ImportStep(stepPath);
+
+		var report = kernel.CompareShapes(replay.FinalShapeId, referenceShapeId, new CompareOptions
+		{
+			LinearDeflection = request.LinearDeflection,
+			HistogramRange = request.HistogramRange,
+		}, Path.Combine(refDir, deviationFile));
+
+		return Results.Ok(new CompareReferenceResponse
+		{
+			SampleCount = report.SampleCount,
+			MinDeviation = report.MinDeviation,
+			MaxDeviation = report.MaxDeviation,
+			MeanDeviation = report.MeanDeviation,
+			MeanAbsDeviation = report.MeanAbsDeviation,
+			RmsDeviation = report.RmsDeviation,
+			HistogramRange = report.HistogramRange,
+			Histogram = report.Histogram,
+			ReverseMaxAbsDeviation = report.ReverseMaxAbsDeviation,
+			HausdorffDistance = report.HausdorffDistance,
+			DeviationMeshUrl = $"/output/reference/{referenceId}/{deviationFile}",
+		});
+	}
+	catch (InvalidOperationException ex)
+	{
+		return Results.BadRequest(new { error = ex.Message });
+	}
+	catch (Exception ex)
+	{
+		return Results.Problem(title: "Reference comparison failed", detail: ex.Message, statusCode: 500);
+	}
+});
+
 app.Run();
 
 static string SanitizeFileName(string? value, string fallback)
@@ -377,6 +488,7 @@ static OperationResult ApplyFeature(L1Kernel kernel, int stockId, FeatureJsonMod
 		"TURN_ID"      => ApplyTurn(kernel, stockId, feature.TurnId!,
 		                            (id, ax, segs, c) => kernel.ApplyTurnId(id, ax, segs, c)),
 		"MILL_CONTOUR" => ApplyMillContour(kernel, stockId, feature.MillContour!),
+		"MILL_SLOT"    => ApplyMillSlot(kernel, stockId, feature.MillSlot!),
 		_ => throw new InvalidOperationException($"Unsupported feature.type: {feature.Type}"),
 	};
 }
@@ -397,6 +509,14 @@ static OperationResult ApplyMillContour(L1Kernel kernel, int stockId, MillContou
 	                               mc.Profile.ToKernelSegments(), mc.Profile.Closed, mc.Depth);
 }
 
+static OperationResult ApplyMillSlot(L1Kernel kernel, int stockId, MillSlotJsonModel slot)
+{
+	if (slot.Path is null)
+		throw new InvalidOperationException("millSlot path is required.");
+	return kernel.ApplyMillSlot(stockId, slot.Axis.ToKernel(),
+	                            slot.Path.ToKernelSegments(), slot.ToolRadius, slot.Depth);
+}
+
 static void TryDeleteDirectory(string path)
 {
 	try
@@ -462,8 +582,45 @@ sealed class PreviewStageResponse
 	public string? RemovalStlUrl { get; set; }
 }
 
+sealed class PreviewStagesRequest
+{
+	public JobJsonModel Job { get; set; } = new();
+	public string? Format { get; set; }  // "stl"（既定）/ "qmesh"（wwwroot/qmesh-decoder.js で復元）
+}
+
+sealed class PreviewStagesResponse
+{
+	public int ErrorCode { get; set; }
+	public string Format { get; set; } = "stl";
+	public string? StockStlUrl { get; set; }
+	public List<PreviewStageResponse> Stages { get; set; } = new();
+}
+
 sealed class ReferenceStepResponse
 {
 	public string ReferenceId { get; set; } = string.Empty;
 	public string ReferenceStlUrl { get; set; } = string.Empty;
 }
+
+sealed class CompareReferenceRequest
+{
+	public string? ReferenceId { get; set; }
+	public JobJsonModel Job { get; set; } = new();
+	public double LinearDeflection { get; set; }  // 0: 形状サイズから自動
+	public double HistogramRange { get; set; }    // 0: 最大 |偏差|
+}
+
+sealed class CompareReferenceResponse
+{
+	public int SampleCount { get; set; }
+	public double MinDeviation { get; set; }
+	public double MaxDeviation { get; set; }
+	public double MeanDeviation { get; set; }
+	public double MeanAbsDeviation { get; set; }
+	public double RmsDeviation { get; set; }
+	public double HistogramRange { get; set; }
+	public int[] Histogram { get; set; } = Array.Empty<int>();
+	public double ReverseMaxAbsDeviation { get; set; }
+	public double HausdorffDistance { get; set; }
+	public string DeviationMeshUrl { get; set; } = string.Empty;
+}
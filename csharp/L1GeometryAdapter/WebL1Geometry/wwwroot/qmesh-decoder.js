@@ -0,0 +1,115 @@
+// Reference decoder for OUT_QMESH files (1_funcspec.md §30).
+
+const HEADER_SIZE = 52;
+const FLAG_DEFLATE = 1;
+const FLAG_NORMALS = 2;
+const FLAG_SCALARS = 4;
+
+async function inflate(bytes) {
+  const stream = new Blob([bytes]).stream().pipeThrough(new DecompressionStream("deflate"));
+  return new Uint8Array(await new Response(stream).arrayBuffer());
+}
+
+function decodeOctahedral(u8, v8, out, offset) {
+  let u = (u8 / 255) * 2 - 1;
+  let v = (v8 / 255) * 2 - 1;
+  const z = 1 - Math.abs(u) - Math.abs(v);
+  if (z < 0) {
+    const fu = (1 - Math.abs(v)) * (u >= 0 ? 1 : -1);
+    const fv = (1 - Math.abs(u)) * (v >= 0 ? 1 : -1);
+    u = fu;
+    v = fv;
+  }
+  const length = Math.hypot(u, v, z) || 1;
+  out[offset] = u / length;
+  out[offset + 1] = v / length;
+  out[offset + 2] = z / length;
+}
+
+export async function decodeQMesh(arrayBuffer) {
+  const view = new DataView(arrayBuffer);
+  const magic = String.fromCharCode(...new Uint8Array(arrayBuffer, 0, 4));
+  if (magic !== "L1QM") {
+    throw new Error("Not a qmesh file");
+  }
+  const version = view.getUint16(4, true);
+  if (version !== 1) {
+    throw new Error(`Unsupported qmesh version ${version}`);
+  }
+
+  const flags = view.getUint16(6, true);
+  const vertexCount = view.getUint32(8, true);
+  const triangleCount = view.getUint32(12, true);
+  const positionBits = view.getUint32(16, true);
+  const bodySize = view.getUint32(20, true);
+  const min = [0, 1, 2].map((c) => view.getFloat32(28 + c * 4, true));
+  const max = [0, 1, 2].map((c) => view.getFloat32(40 + c * 4, true));
+
+  let body = new Uint8Array(arrayBuffer, HEADER_SIZE, bodySize);
+  if (flags & FLAG_DEFLATE) {
+    body = await inflate(body);
+  }
+  const bodyView = new DataView(body.buffer, body.byteOffset, body.byteLength);
+
+  const positions = new Float32Array(vertexCount * 3);
+  const steps = 2 ** positionBits - 1;
+  let offset = 0;
+  for (let c = 0; c < 3; c++) {
+    const scale = (max[c] - min[c]) / steps;
+    let q = 0;
+    for (let i = 0; i < vertexCount; i++) {
+      q = (q + bodyView.getUint16(offset, true)) & 0xffff;
+      offset += 2;
+      positions[i * 3 + c] = min[c] + q * scale;
+    }
+  }
+
+  let normals = null;
+  if (flags & FLAG_NORMALS) {
+    normals = new Float32Array(vertexCount * 3);
+    for (let i = 0; i < vertexCount; i++) {
+      decodeOctahedral(body[offset], body[offset + 1], normals, i * 3);
+      offset += 2;
+    }
+  }
+
+  const indices = new Uint32Array(triangleCount * 3);
+  let previous = 0;
+  for (let i = 0; i < indices.length; i++) {
+    let value = 0;
+    let shift = 0;
+    let byte;
+    do {
+      byte = body[offset++];
+      value += (byte & 0x7f) * 2 ** shift;
+      shift += 7;
+    } while (byte & 0x80);
+    const delta = value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+    previous += delta;
+    indices[i] = previous;
+  }
+
+  let scalars = null;
+  if (flags & FLAG_SCALARS) {
+    scalars = new Float32Array(vertexCount);
+    for (let i = 0; i < vertexCount; i++) {
+      scalars[i] = bodyView.getFloat32(offset, true);
+      offset += 4;
+    }
+  }
+
+  return { vertexCount, triangleCount, positions, normals, indices, scalars };
+}
+
+// Builds a THREE.BufferGeometry; normals are derived when the file has none.
+export function toBufferGeometry(THREE, mesh) {
+  const geometry = new THREE.BufferGeometry();
+  geometry.setAttribute("position", new THREE.BufferAttribute(mesh.positions, 3));
+  geometry.setIndex(new THREE.BufferAttribute(mesh.indices, 1));
+  if (mesh.normals) {
+    geometry.setAttribute("normal", new THREE.BufferAttribute(mesh.normals, 3));
+  } else {
+    geometry.computeVertexNormals();
+  }
+  return geometry;
+}
@@ -71,28 +71,320 @@ typedef struct Path2DSegmentDto {
   ArcDirection      arcDirection; /* offset 52,  4 bytes */
 } Path2DSegmentDto;               /* total: 56 bytes     */
 
+/* Which route ApplyBooleanOp took (for hit-rate measurement). */
+typedef enum BooleanPath {
+  BOOLEAN_PATH_FULL         = 0,  /* Cut + Common                              */
+  BOOLEAN_PATH_MISS         = 1,  /* bounds disjoint: result = stock, no delta */
+  BOOLEAN_PATH_CONTAINED    = 2,  /* tool strictly inside: Cut only, delta = tool */
+  BOOLEAN_PATH_TURN_SECTION = 3,  /* 2D lathe half-section                     */
+  BOOLEAN_PATH_GLUE         = 4   /* Cut + Common with BOPAlgo_GlueShift       */
+} BooleanPath;
+
+/* Output of the L1_Apply* calls and L1_WaitOperation. Versioned like
+   MeshStats: set structSize = sizeof(OperationResult) before the call; only
+   the fields up to structSize are written. */
 typedef struct OperationResult {
-  int resultShapeId;
-  int deltaShapeId;
-  int removalShapeId;
-  int errorCode;
+  int         structSize;
+  int         resultShapeId;
+  int         deltaShapeId;
+  int         removalShapeId;
+  int         errorCode;
+  BooleanPath booleanPath;
+  int         faceCountBefore;  /* faces of the raw boolean result; 0 unless unifySameDomain is on */
+  int         faceCountAfter;   /* faces after compaction; 0 unless unifySameDomain is on          */
 } OperationResult;
 
 typedef enum OutputFormat {
-  OUT_STEP = 1,
-  OUT_STL  = 2
+  OUT_STEP  = 1,
+  OUT_STL   = 2,
+  OUT_QMESH = 3   /* quantized, compressed triangle mesh for web previews (1_funcspec.md §30) */
 } OutputFormat;
 
 typedef struct OutputOptions {
   OutputFormat format;
   double linearDeflection;
   double angularDeflection;
-  int parallel;
+  int parallel;  /* as in the first release: 1 = linearDeflection is relative to each edge's
+                    size; faces are always meshed in parallel. Use MeshOptions for more. */
 } OutputOptions;
 
+typedef enum MeshAlgorithm {
+  MESH_ALGO_DEFAULT   = 0,  /* OCCT's default 2D triangulator */
+  MESH_ALGO_WATSON    = 1,
+  MESH_ALGO_DELABELLA = 2
+} MeshAlgorithm;
+
+/* Tessellation settings for L1_ExportShapeEx. Versioned like KernelOptions:
+   set structSize = sizeof(MeshOptions); omitted trailing fields use their
+   defaults (linearDeflection 0.1, angularDeflection 0.5, the rest 0). */
+typedef struct MeshOptions {
+  int           structSize;
+  double        linearDeflection;    /* absolute; used when relativeDeflection <= 0              */
+  double        relativeDeflection;  /* > 0: linear deflection = this * bounding-box diagonal    */
+  double        angularDeflection;   /* radians                                                 */
+  double        minSize;             /* smallest element size; <= 0: derived by the mesher      */
+  int           triangleBudget;      /* > 0: coarsen the deflection between passes (max 4) until
+                                        the mesh fits; the last pass is kept even if it does not */
+  MeshAlgorithm algorithm;
+  int           parallel;            /* 1: mesh faces in parallel                               */
+  int           positionBits;        /* OUT_QMESH: grid bits per coordinate, 1..16 (0: 16)       */
+  int           octNormals;          /* OUT_QMESH: 1: 2-byte octahedral normals per vertex;
+                                        0: none, the reader derives them from the triangles     */
+} MeshOptions;
+
+/* Preprocessing run once by L1_ImportStepAsShapeEx. Versioned like
+   KernelOptions: set structSize = sizeof(ImportOptions); omitted fields are
+   0 (off). */
+typedef struct ImportOptions {
+  int    structSize;
+  int    heal;             /* 1: ShapeFix the shape, drop edges shorter than the precision and close wire gaps */
+  double tolerance;        /* > 0: healing precision, and vertex / edge / face tolerances are capped at this  */
+  int    unifySameDomain;  /* 1: merge same-surface faces / same-curve edges                                 */
+  int    extractSolids;    /* 1: keep only the solids (ERROR_IMPORT_FAILED when there are none)               */
+  int    noCache;          /* 1: read and prepare the file even when a prepared copy is cached                */
+} ImportOptions;
+
+/* One body of L1_ExportStepBodies. */
+typedef struct StepBodyDto {
+  int         shapeId;
+  const char* nameUtf8;  /* product name; NULL or "": "body_<shapeId>" */
+  int         hasColor;  /* 1: rgb is written as the body's colour     */
+  double      rgb[3];    /* 0..1                                       */
+} StepBodyDto;
+
+typedef struct MeshStats {
+  int    structSize;
+  int    triangleCount;
+  int    nodeCount;
+  int    passes;            /* > 1 when the triangle budget forced coarsening */
+  double linearDeflection;  /* absolute deflection of the final pass          */
+  double meshMs;
+} MeshStats;
+
+/* Approximate z-map preview of a STOCK_BOX (interactive stage scrubbing). */
+typedef struct PreviewGridOptions {
+  double cellSize;     /* grid pitch in model units */
+  int    threadCount;  /* 0: hardware concurrency   */
+} PreviewGridOptions;
+
+/* Async operations: called on the worker thread once the operation is done. */
+typedef void (*L1_CompletionCallback)(int operationId, int errorCode, void* userData);
+
+typedef struct AsyncOptions {
+  double                timeoutMs;   /* <= 0: no deadline                 */
+  L1_CompletionCallback onComplete;  /* optional                          */
+  void*                 userData;    /* passed through to onComplete      */
+} AsyncOptions;
+
+/* Native job runner (same JSON shape as samples/machining_job.json).
+   Versioned like KernelOptions. */
+typedef struct JobRunOptions {
+  int         structSize;
+  int         threadCount;  /* 0: hardware concurrency; one kernel per worker   */
+  int         skipExport;   /* 1: run stock + features only, no files written   */
+  const char* baseDirUtf8;  /* output.dir is resolved against this; NULL: cwd   */
+  int         pipelined;    /* 1: build the next feature's tool during each boolean */
+  void*       kernel;       /* non-NULL: run the jobs in order on this kernel instead of on
+                               private ones (threadCount is ignored); every shape a job
+                               creates is deleted again, other shapes are left alone */
+} JobRunOptions;
+
+/* L1_BuildStageMeshes settings. Versioned like KernelOptions. */
+typedef struct StageMeshOptions {
+  int          structSize;
+  int          threadCount;  /* mesh workers; 0: hardware concurrency - 1 (at least 1) */
+  const char*  outDirUtf8;   /* meshes are written here; created when missing (required) */
+  OutputFormat format;       /* OUT_STL (0 is taken as OUT_STL) or OUT_QMESH (*.qmesh)   */
+} StageMeshOptions;
+
+/* Per-kernel behaviour switches. Set structSize = sizeof(KernelOptions):
+   fields past structSize keep their defaults, so callers built against an
+   older header keep working when fields are appended. */
+typedef enum BooleanGlueMode {
+  BOOLEAN_GLUE_OFF  = 0,  /* always the general boolean                                           */
+  BOOLEAN_GLUE_AUTO = 1,  /* glue when a tool face is flush with a stock face and the boxes nest   */
+  BOOLEAN_GLUE_ON   = 2   /* caller guarantees tools only touch the stock through coinciding faces */
+} BooleanGlueMode;
+
+/* Validation tiers; each level includes the ones below it. */
+typedef enum ValidationLevel {
+  VALIDATE_OFF       = 0,
+  VALIDATE_STRUCTURE = 1,  /* topology only: faces with surfaces and wires, edges with curves (cheap)  */
+  VALIDATE_CLOSED    = 2,  /* no free edges or open shells, tolerances within the limit               */
+  VALIDATE_FULL      = 3   /* BRepCheck_Analyzer with geometry checks, faces checked in parallel      */
+} ValidationLevel;
+
+typedef struct KernelOptions {
+  int             structSize;
+  int             unifySameDomain;  /* 1: merge same-surface faces / same-curve edges of each boolean result (default 0) */
+  BooleanGlueMode glueMode;         /* default BOOLEAN_GLUE_OFF; a glue boolean that fails or reports
+                                       intersection warnings is redone without glue */
+  ValidationLevel validateResults;  /* check each boolean result at this level (default VALIDATE_OFF); a glue
+                                       result that fails is redone without glue, otherwise ERROR_INVALID_RESULT */
+} KernelOptions;
+
+/* L1_ValidateShape settings. Versioned like KernelOptions. */
+typedef struct ValidationOptions {
+  int             structSize;
+  ValidationLevel level;           /* highest level to run (default VALIDATE_STRUCTURE)    */
+  double          toleranceLimit;  /* VALIDATE_CLOSED: largest tolerance accepted; <= 0: 1e-3 */
+} ValidationOptions;
+
+typedef struct ValidationReport {
+  int    structSize;
+  int    valid;                 /* 1: every level that ran passed                         */
+  int    failedLevel;           /* first failing ValidationLevel; 0 when valid; later
+                                   levels are not run                                     */
+  int    solidCount;
+  int    shellCount;
+  int    faceCount;
+  int    edgeCount;
+  int    freeEdgeCount;         /* VALIDATE_CLOSED: edges bounding a single face          */
+  int    openShellCount;        /* VALIDATE_CLOSED                                        */
+  double maxTolerance;          /* VALIDATE_CLOSED: over vertices, edges and faces        */
+  int    invalidSubShapeCount;  /* VALIDATE_FULL: sub-shapes BRepCheck rejects            */
+  double structureMs;           /* per-level timings; 0 for levels that did not run       */
+  double closedMs;
+  double fullMs;
+} ValidationReport;
+
+/* L1_CompareShapes settings. Versioned like KernelOptions. */
+typedef struct CompareOptions {
+  int    structSize;
+  double linearDeflection;   /* both shapes are meshed with it; <= 0: 0.1% of the compared shape's
+                                bounding-box diagonal. Deviations are accurate to about this much */
+  double angularDeflection;  /* <= 0: 0.5                                                           */
+  double histogramRange;     /* bins span [-range, +range], outliers go to the end bins;
+                                <= 0: the largest |deviation|                                       */
+  int    threadCount;        /* BVH build and queries; 0: hardware concurrency                      */
+} CompareOptions;
+
+#define L1_DEVIATION_HISTOGRAM_BINS 32
+
+/* Signed deviation of points spread over the compared shape's surface (mesh
+   vertices plus a grid inside large triangles) from the reference surface:
+   positive outside the reference (material left), negative inside (material
+   missing). The reverse fields measure the reference surface against the
+   compared one, which catches reference features the compared shape lacks. */
+typedef struct CompareReport {
+  int    structSize;
+  int    sampleCount;             /* surface samples of the compared shape         */
+  int    referenceTriangleCount;
+  double minDeviation;
+  double maxDeviation;
+  double meanDeviation;           /* signed                                        */
+  double meanAbsDeviation;
+  double rmsDeviation;
+  double histogramRange;          /* range the bins actually span                  */
+  int    histogram[L1_DEVIATION_HISTOGRAM_BINS];
+  double meshMs;                  /* both shapes                                   */
+  double bvhMs;
+  double queryMs;                 /* both directions                               */
+  int    reverseSampleCount;      /* surface samples of the reference              */
+  double reverseMaxAbsDeviation;  /* largest distance of those from the compared shape */
+  double hausdorffDistance;       /* symmetric: the larger of both directions      */
+} CompareReport;
+
+typedef enum MassMode {
+  MASS_EXACT = 0,  /* Gauss integration over the B-rep faces                              */
+  MASS_FAST  = 1   /* integration over a mesh; error bounded by MassPropertiesOptions.tolerance */
+} MassMode;
+
+/* L1_ComputeMassProperties settings. Versioned like KernelOptions. */
+typedef struct MassPropertiesOptions {
+  int      structSize;
+  MassMode mode;         /* default MASS_EXACT                                                 */
+  double   tolerance;    /* MASS_FAST: mesh deflection relative to the shape's bounding-box
+                            diagonal; volume and area are off by at most about deflection x
+                            area. <= 0: 1e-3                                                   */
+  int      threadCount;  /* shapes evaluated at once; 0: hardware concurrency                  */
+} MassPropertiesOptions;
+
+/* One entry per requested shape, in request order. */
+typedef struct MassProperties {
+  int    shapeId;
+  int    errorCode;    /* ERROR_OK, or e.g. ERROR_SHAPE_NOT_FOUND for this shape          */
+  double volume;
+  double area;
+  double centroid[3];  /* centre of the volume; of the surface when the volume is 0      */
+  double tolerance;    /* accuracy of these values: 0 exact, else the relative deflection */
+  int    cached;       /* 1: answered from the registry without integrating               */
+} MassProperties;
+
+/* L1_SectionShape settings. Versioned like KernelOptions. Plane k (0-based)
+   has normal axis.dir and passes through axis.origin + k * spacing * axis.dir.
+   Its (u,v) frame is the one of L1_ApplyMillContour: u along axis.xdir,
+   v along axis.dir x axis.xdir, origin at the foot of axis.origin. */
+typedef struct SectionOptions {
+  int     structSize;
+  AxisDto axis;
+  int     planeCount;      /* >= 1                                                         */
+  double  spacing;         /* distance between planes along axis.dir; != 0 for several     */
+  double  chordTolerance;  /* lines and circles come back exact; other curves as LINE
+                              chords within this distance of the curve. <= 0: 0.01        */
+  int     threadCount;     /* planes cut at once; 0: hardware concurrency                  */
+} SectionOptions;
+
+/* One entry per plane. Its segments are outSegments[firstSegment ..
+   firstSegment + segmentCount - 1], ordered into connected chains: a chain
+   starts where `from` differs from the previous segment's `to`. */
+typedef struct SectionPlane {
+  double offset;        /* signed distance from axis.origin along axis.dir           */
+  int    errorCode;     /* ERROR_OK, or why this plane failed (it then has no segments) */
+  int    firstSegment;
+  int    segmentCount;
+  int    chainCount;
+  int    closed;        /* 1: every chain is a closed loop (0 for an empty plane)    */
+} SectionPlane;
+
+/* L1_QueryClearance settings. Versioned like KernelOptions. */
+typedef struct ClearanceOptions {
+  int    structSize;
+  double maxDistance;  /* clearances above this are not measured (CLEARANCE_FAR); the
+                          bounding boxes then answer without touching the B-rep.
+                          <= 0: always measure                                        */
+  int    threadCount;  /* placements evaluated at once; 0: hardware concurrency     */
+} ClearanceOptions;
+
+typedef enum ClearanceState {
+  CLEARANCE_CLEAR     = 0,  /* apart; distance is the minimum clearance                    */
+  CLEARANCE_FAR       = 1,  /* apart by more than maxDistance (or a shape is empty);
+                               distance is a lower bound from the face boxes             */
+  CLEARANCE_CONTACT   = 2,  /* boundaries touch or cross: interference                     */
+  CLEARANCE_CONTAINED = 3   /* one shape lies entirely inside the other: interference      */
+} ClearanceState;
+
+/* One entry per placement, in request order. */
+typedef struct ClearanceResult {
+  int            errorCode;  /* ERROR_OK, or why this placement failed                     */
+  ClearanceState state;
+  double         distance;   /* 0 for CLEARANCE_CONTACT / CLEARANCE_CONTAINED               */
+  double         pointA[3];  /* closest points on the shape and on the placed other shape;
+                                CLEARANCE_CLEAR / CLEARANCE_CONTACT only                    */
+  double         pointB[3];
+  double         queryMs;
+} ClearanceResult;
+
 L1_API void* L1_CreateKernel();
 L1_API int   L1_DestroyKernel(void* kernel);
 
+/* Creates a kernel holding the parent's shapes under the same ids, with the
+   parent's options. Shapes are shared by reference, not copied, and both
+   kernels may be used from different threads at once. Preview grids and
+   async operations are not carried over. Each kernel is destroyed on its
+   own, in any order. */
+L1_API int   L1_ForkKernel(void* kernel, void** outKernel);
+
+/* Deletes every shape, preview grid and async operation (pending ones are
+   cancelled and awaited). Ids restart as in a new kernel; kernel options
+   and pooled allocator memory are kept. */
+L1_API int   L1_ResetKernel(void* kernel);
+
+/* Applies to operations started after the call. */
+L1_API int   L1_SetKernelOptions(void* kernel, const KernelOptions* opt);
+/* Fills outOpt up to outOpt->structSize. */
+L1_API int   L1_GetKernelOptions(void* kernel, KernelOptions* outOpt);
+
 L1_API int   L1_CreateStock(void* kernel, const StockDto* dto, int* outStockId);
 
 L1_API int   L1_ApplyMillHole(void* kernel, int stockId,
@@ -119,17 +411,207 @@ L1_API int   L1_ApplyMillContour(void* kernel, int stockId,
                                  double depth,
                                  OperationResult* outResult);
 
+/* Slot an end mill of toolRadius cuts along an open path in the plane of
+   axis (same frame as L1_ApplyMillContour), depth along axis->dir. */
+L1_API int   L1_ApplyMillSlot(void* kernel, int stockId,
+                              const AxisDto* axis,
+                              const Path2DSegmentDto* segments, int segmentCount,
+                              double toolRadius, double depth,
+                              OperationResult* outResult);
+
 L1_API int   L1_DeleteShape(void* kernel, int shapeId);
 
+/* Checks a registry shape up to opt->level. A shape that fails is not an
+   error: the call returns ERROR_OK and the report says what failed. */
+L1_API int   L1_ValidateShape(void* kernel, int shapeId,
+                              const ValidationOptions* opt,
+                              ValidationReport* outReport);
+
+/* Meshes both shapes, builds a BVH over the reference triangles and measures
+   every vertex of shapeId's mesh against it in parallel. The reference should
+   be closed for the sign to be meaningful. deviationMeshFileUtf8 (optional)
+   receives the compared mesh as OUT_QMESH with the deviation of each vertex
+   as its scalar, for colouring. */
+L1_API int   L1_CompareShapes(void* kernel, int shapeId, int referenceId,
+                              const CompareOptions* opt,
+                              const char* deviationMeshFileUtf8,
+                              CompareReport* outReport);
+
+/* Volume, surface area and centroid of each registry shape, evaluated in
+   parallel. Results are cached per shape, so asking again (or for a coarser
+   tolerance) is free; a failing shape only sets its own errorCode. */
+L1_API int   L1_ComputeMassProperties(void* kernel, const int* shapeIds, int shapeCount,
+                                      const MassPropertiesOptions* opt,
+                                      MassProperties* outProps);
+
+/* Cuts a registry shape with opt->planeCount parallel planes, computed in
+   parallel, and returns the section curves as Path2DSegmentDto in each
+   plane's (u,v) frame. outPlanes receives planeCount entries and
+   *outSegmentCount the total number of segments. When that exceeds
+   segmentCapacity no segment is written and ERROR_BUFFER_TOO_SMALL (14) is
+   returned; outSegments may be NULL to ask for the count. A plane that
+   misses the shape has no segments; one that fails only sets its own
+   errorCode. */
+L1_API int   L1_SectionShape(void* kernel, int shapeId, const SectionOptions* opt,
+                             SectionPlane* outPlanes, Path2DSegmentDto* outSegments,
+                             int segmentCapacity, int* outSegmentCount);
+
+/* Whether otherId, translated by each of `placementCount` offsets (xyz per
+   placement; NULL for one query as registered), touches or overlaps shapeId,
+   and the clearance when it does not. Nothing is cut or registered. A tool
+   is queried as its own shape, e.g. a cylinder from L1_CreateStock. Far
+   placements are settled by the cached bounding boxes; the rest use the
+   exact B-rep distance. Placements run in parallel; a failing one only sets
+   its own errorCode. */
+L1_API int   L1_QueryClearance(void* kernel, int shapeId, int otherId,
+                               const double* offsets, int placementCount,
+                               const ClearanceOptions* opt, ClearanceResult* outResults);
+
 L1_API int   L1_ImportStepAsShape(void* kernel,
                                   const char* filePathUtf8,
                                   int* outShapeId);
 
+/* L1_ImportStepAsShape with preprocessing. The prepared shape is cached
+   process-wide by path, file size, modification time and options, so
+   importing the same file again (in any kernel) skips reading and
+   preparing; every import still gets its own topology. */
+L1_API int   L1_ImportStepAsShapeEx(void* kernel,
+                                    const char* filePathUtf8,
+                                    const ImportOptions* opt,
+                                    int* outShapeId);
+
 L1_API int   L1_ExportShape(void* kernel,
                             int shapeId,
                             const OutputOptions* opt,
                             const char* filePathUtf8);
 
+/* L1_ExportShape with full tessellation control (OUT_STEP ignores mesh).
+   outStats may be NULL. */
+L1_API int   L1_ExportShapeEx(void* kernel, int shapeId,
+                              OutputFormat format, const MeshOptions* mesh,
+                              const char* filePathUtf8,
+                              MeshStats* outStats);
+
+/* Writes several shapes into one STEP file in a single writer session, each
+   as a named product with an optional colour. assemblyNameUtf8 NULL or "":
+   the bodies are separate top-level products; otherwise they become the
+   components of one assembly of that name. */
+L1_API int   L1_ExportStepBodies(void* kernel,
+                                 const StepBodyDto* bodies, int bodyCount,
+                                 const char* assemblyNameUtf8,
+                                 const char* filePathUtf8);
+
+L1_API int   L1_CreatePreviewGrid(void* kernel, const StockDto* stock,
+                                  const PreviewGridOptions* opt,
+                                  int* outPreviewId);
+
+L1_API int   L1_ClonePreviewGrid(void* kernel, int previewId, int* outPreviewId);
+
+L1_API int   L1_DeletePreviewGrid(void* kernel, int previewId);
+
+L1_API int   L1_PreviewMillHole(void* kernel, int previewId,
+                                const MillHoleFeatureDto* dto);
+
+L1_API int   L1_PreviewPocketRect(void* kernel, int previewId,
+                                  const PocketRectFeatureDto* dto);
+
+L1_API int   L1_PreviewMillContour(void* kernel, int previewId,
+                                   const AxisDto* axis,
+                                   const Path2DSegmentDto* segments, int segmentCount, int closed,
+                                   double depth);
+
+L1_API int   L1_ExportPreviewStl(void* kernel, int previewId,
+                                 const char* filePathUtf8);
+
+/* Async variants: inputs are copied; async may be NULL. Operations run on the
+   kernel's worker threads (at most hardware concurrency; more queue). The
+   operation id is valid until L1_ReleaseOperation; the operation calls below
+   return ERROR_INVALID_ARGUMENT for an unknown or released id. */
+L1_API int   L1_ApplyMillHoleAsync(void* kernel, int stockId,
+                                   const MillHoleFeatureDto* dto,
+                                   const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ApplyPocketRectAsync(void* kernel, int stockId,
+                                     const PocketRectFeatureDto* dto,
+                                     const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ApplyTurnOdAsync(void* kernel, int stockId,
+                                 const AxisDto* axis,
+                                 const Path2DSegmentDto* segments, int segmentCount, int closed,
+                                 const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ApplyTurnIdAsync(void* kernel, int stockId,
+                                 const AxisDto* axis,
+                                 const Path2DSegmentDto* segments, int segmentCount, int closed,
+                                 const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ApplyMillContourAsync(void* kernel, int stockId,
+                                      const AxisDto* axis,
+                                      const Path2DSegmentDto* segments, int segmentCount, int closed,
+                                      double depth,
+                                      const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ApplyMillSlotAsync(void* kernel, int stockId,
+                                   const AxisDto* axis,
+                                   const Path2DSegmentDto* segments, int segmentCount,
+                                   double toolRadius, double depth,
+                                   const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ExportShapeAsync(void* kernel, int shapeId,
+                                 const OutputOptions* opt,
+                                 const char* filePathUtf8,
+                                 const AsyncOptions* async, int* outOperationId);
+
+L1_API int   L1_ExportShapeExAsync(void* kernel, int shapeId,
+                                   OutputFormat format, const MeshOptions* mesh,
+                                   const char* filePathUtf8,
+                                   const AsyncOptions* async, int* outOperationId);
+
+/* outProgress (optional) is in [0,1]. */
+L1_API int   L1_PollOperation(void* kernel, int operationId, int* outDone, double* outProgress);
+
+/* timeoutMs < 0 waits forever. Returns the operation's error code, or
+   ERROR_OPERATION_PENDING (11) if it is still running. outResult may be NULL. */
+L1_API int   L1_WaitOperation(void* kernel, int operationId, double timeoutMs,
+                              OperationResult* outResult);
+
+L1_API int   L1_Cancel(void* kernel, int operationId);
+
+/* Cancels if still running, waits for it to finish and frees the handle. */
+L1_API int   L1_ReleaseOperation(void* kernel, int operationId);
+
+/* jobsJsonUtf8: one job object, an array of jobs or {"jobs": [...]}. opt may be
+   NULL. *outResultJson receives per-job error codes and timings (or {"error"}
+   when the document cannot be parsed) and must be freed with L1_FreeString.
+   Individual job failures are reported in the JSON, not in the return code. */
+L1_API int   L1_RunJobs(const char* jobsJsonUtf8, const JobRunOptions* opt,
+                        char** outResultJson);
+
+/* Writes meshes of the stock and of the result / delta / removal of every
+   stage of one job (same JSON as L1_RunJobs) to opt->outDirUtf8: stock.stl,
+   stage_000_result.stl, stage_000_delta.stl, ... (.qmesh for OUT_QMESH). The booleans run in order
+   on a private kernel; each finished stage is meshed on the worker threads
+   while later booleans run, and the next stage's tool is built during the
+   current boolean. Mesh settings come from the job's output block.
+   *outResultJson lists the files with per-stage timings and must be freed
+   with L1_FreeString. Returns the first failing error code; stages before a
+   failing feature are still written. */
+L1_API int   L1_BuildStageMeshes(const char* jobJsonUtf8, const StageMeshOptions* opt,
+                                 char** outResultJson);
+
+L1_API void  L1_FreeString(char* text);
+
+/* Process-wide binary call journal for offline replay (occt_geometry_replay).
+   Records every kernel lifecycle, stock, feature, delete, import and export
+   call with its inputs, outputs, return code and timing. Setting
+   L1_JOURNAL_PATH starts it on the first API call. L1_StopJournal writes
+   the rest, closes the file and ends the writer thread; call it before
+   unloading the library. A journal still running at process exit is
+   flushed without waiting for the writer, so a batch being written then
+   may be cut short. */
+L1_API int   L1_StartJournal(const char* filePathUtf8);
+L1_API int   L1_StopJournal();
+
 #ifdef __cplusplus
 }
 #endif
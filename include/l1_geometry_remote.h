@@ -0,0 +1,29 @@
+#pragma once
+
+/* l1_geometry_remote: drop-in replacement for l1_geometry_kernel that runs
+   every kernel in an occt_geometry_worker process (1_funcspec.md §27).
+   Exports the synchronous shape API of l1_geometry_kernel.h under the same
+   names — kernel lifecycle, options, stock, features, delete, STEP import
+   and export — so a caller switches by loading this library instead.
+   Preview, async and job-runner entry points are not provided.
+
+   A kernel handle is one connection; shapes stay in the worker and are
+   addressed by the same ids. When the worker dies or cannot be reached,
+   calls on that handle return ERROR_WORKER_UNAVAILABLE (12); destroy it
+   and create a new kernel, which connects to the next live worker. */
+
+#include "l1_geometry_kernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Socket of a single worker (workerCount 0) or the base path of a pool
+   started with `occt_geometry_worker --pool N` (workers at "<base>.0" ..
+   "<base>.N-1"). Affects kernels created afterwards. Defaults come from
+   the L1_WORKER_SOCKET / L1_WORKER_COUNT environment variables. */
+L1_API int   L1_SetWorkerEndpoint(const char* socketPathUtf8, int workerCount);
+
+#ifdef __cplusplus
+}
+#endif
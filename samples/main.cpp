@@ -1,15 +1,22 @@
 #include "l1_geometry_kernel.h"
+#include "job_json.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -131,6 +138,15 @@ const std::string& Require(const std::unordered_map<std::string, std::string>& k
   return it->second;
 }
 
+// 出力ファイル名など、空にできない値
+const std::string& RequireNonEmpty(const std::unordered_map<std::string, std::string>& kv,
+                                   const std::string& key) {
+  const std::string& value = Require(kv, key);
+  if (value.empty())
+    throw std::runtime_error("Empty value: " + key);
+  return value;
+}
+
 const std::string* Find(const std::unordered_map<std::string, std::string>& kv,
                         const std::string& key) {
   auto it = kv.find(key);
@@ -338,11 +354,11 @@ SampleCase LoadCaseFile(const std::filesystem::path& filePath) {
   sample.outputOptions.angularDeflection = std::stod(Require(kv, "output.angularDeflection"));
   sample.outputOptions.parallel          = ParseBool01(Require(kv, "output.parallel")) ? 1 : 0;
 
-  sample.outputDir       = Require(kv, "output.dir");
-  sample.stepFileName    = Require(kv, "output.stepFile");
-  sample.stlFileName     = Require(kv, "output.stlFile");
-  sample.deltaStepFileName = Require(kv, "output.deltaStepFile");
-  sample.deltaStlFileName  = Require(kv, "output.deltaStlFile");
+  sample.outputDir       = RequireNonEmpty(kv, "output.dir");
+  sample.stepFileName    = RequireNonEmpty(kv, "output.stepFile");
+  sample.stlFileName     = RequireNonEmpty(kv, "output.stlFile");
+  sample.deltaStepFileName = RequireNonEmpty(kv, "output.deltaStepFile");
+  sample.deltaStlFileName  = RequireNonEmpty(kv, "output.deltaStlFile");
   if (const std::string* removalStepFile = Find(kv, "output.removalStepFile"))
     sample.removalStepFileName = *removalStepFile;
   if (const std::string* removalStlFile = Find(kv, "output.removalStlFile"))
@@ -351,143 +367,496 @@ SampleCase LoadCaseFile(const std::filesystem::path& filePath) {
   return sample;
 }
 
-}  // namespace
+// ---------------------------------------------------------------------------
+// ケース実行（単発モード / バッチモード共通）
+// ---------------------------------------------------------------------------
 
-int main(int argc, char* argv[]) {
-  using Clock = std::chrono::steady_clock;
-  const auto totalStart = Clock::now();
+using Clock = std::chrono::steady_clock;
 
-  const std::filesystem::path casePath = (argc >= 2)
-      ? std::filesystem::path(argv[1])
-      : std::filesystem::path("samples") / "box_mill_hole_case.txt";
+struct CaseTiming {
+  double loadMs   = 0.0;
+  double stockMs  = 0.0;
+  double applyMs  = 0.0;
+  double exportMs = 0.0;
+  double totalMs  = 0.0;
+};
 
-  const auto loadStart = Clock::now();
-  SampleCase sample{};
+struct CaseRun {
+  int                      errorCode = 0;
+  std::string              failedStep;
+  CaseTiming               timing;
+  std::vector<std::string> generated;
+};
+
+int ApplyCaseFeature(void* kernel, int stockId, const SampleCase& sample,
+                     OperationResult* result) {
+  const std::string& ft = sample.featureType;
+  if (ft == "MILL_HOLE")
+    return L1_ApplyMillHole(kernel, stockId, &sample.millHole, result);
+  if (ft == "POCKET_RECT")
+    return L1_ApplyPocketRect(kernel, stockId, &sample.pocketRect, result);
+  if (ft == "TURN_OD")
+    return L1_ApplyTurnOd(kernel, stockId,
+                          &sample.turnOd.axis,
+                          sample.turnOd.segments.data(),
+                          static_cast<int>(sample.turnOd.segments.size()),
+                          sample.turnOd.closed, result);
+  if (ft == "TURN_ID")
+    return L1_ApplyTurnId(kernel, stockId,
+                          &sample.turnId.axis,
+                          sample.turnId.segments.data(),
+                          static_cast<int>(sample.turnId.segments.size()),
+                          sample.turnId.closed, result);
+  if (ft == "MILL_CONTOUR")
+    return L1_ApplyMillContour(kernel, stockId,
+                               &sample.millContour.axis,
+                               sample.millContour.segments.data(),
+                               static_cast<int>(sample.millContour.segments.size()),
+                               sample.millContour.closed,
+                               sample.millContour.depth, result);
+  return 3;  // ERROR_FEATURE_NOT_SUPPORTED
+}
+
+// Stock 作成 → フィーチャ適用 → 出力。作成した Shape は終了時に削除する
+CaseRun RunCase(void* kernel, const SampleCase& sample, bool doExport) {
+  CaseRun run;
+  auto fail = [&run](int code, const char* step) {
+    run.errorCode  = code;
+    run.failedStep = step;
+    return run;
+  };
+
+  const auto stockStart = Clock::now();
+  int stockId = 0;
+  const int stockRc = L1_CreateStock(kernel, &sample.stock, &stockId);
+  run.timing.stockMs = ElapsedMs(stockStart, Clock::now());
+  if (stockRc != 0) return fail(stockRc, "L1_CreateStock");
+
+  const auto applyStart = Clock::now();
+  OperationResult result{};
+  result.structSize = sizeof(result);
+  const int applyRc = ApplyCaseFeature(kernel, stockId, sample, &result);
+  run.timing.applyMs = ElapsedMs(applyStart, Clock::now());
+
+  auto cleanup = [&]() {
+    L1_DeleteShape(kernel, result.removalShapeId);
+    L1_DeleteShape(kernel, result.deltaShapeId);
+    L1_DeleteShape(kernel, result.resultShapeId);
+    L1_DeleteShape(kernel, stockId);
+  };
+
+  if (applyRc != 0) {
+    cleanup();
+    return fail(applyRc, "L1_ApplyXxx");
+  }
+
+  if (doExport) {
+    const auto exportStart = Clock::now();
+    std::filesystem::path outDir = std::filesystem::current_path() / sample.outputDir;
+    std::filesystem::create_directories(outDir);
+
+    OutputOptions stepOpt = sample.outputOptions;
+    stepOpt.format = OUT_STEP;
+
+    OutputOptions stlOpt = sample.outputOptions;
+    stlOpt.format = OUT_STL;
+
+    struct Export {
+      int                  shapeId;
+      const OutputOptions* opt;
+      const std::string*   fileName;
+      const char*          step;
+    };
+    const Export exports[] = {
+        {result.resultShapeId,  &stepOpt, &sample.stepFileName,        "L1_ExportShape(STEP)"},
+        {result.resultShapeId,  &stlOpt,  &sample.stlFileName,         "L1_ExportShape(STL)"},
+        {result.deltaShapeId,   &stepOpt, &sample.deltaStepFileName,   "L1_ExportShape(DELTA STEP)"},
+        {result.deltaShapeId,   &stlOpt,  &sample.deltaStlFileName,    "L1_ExportShape(DELTA STL)"},
+        {result.removalShapeId, &stepOpt, &sample.removalStepFileName, "L1_ExportShape(REMOVAL STEP)"},
+        {result.removalShapeId, &stlOpt,  &sample.removalStlFileName,  "L1_ExportShape(REMOVAL STL)"},
+    };
+    for (const Export& e : exports) {
+      if (e.fileName->empty()) continue;  // removal 出力は任意（他は LoadCaseFile が空を拒否する）
+      const std::string path = (outDir / *e.fileName).string();
+      const int rc = L1_ExportShape(kernel, e.shapeId, e.opt, path.c_str());
+      if (rc != 0) {
+        cleanup();
+        return fail(rc, e.step);
+      }
+      run.generated.push_back(path);
+    }
+    run.timing.exportMs = ElapsedMs(exportStart, Clock::now());
+  }
+
+  cleanup();
+  return run;
+}
+
+// ---------------------------------------------------------------------------
+// バッチモード
+// ---------------------------------------------------------------------------
+
+struct BatchOptions {
+  std::filesystem::path input;        // ディレクトリまたはマニフェスト
+  int                   threads  = 0; // 0: ハードウェア並列数
+  bool                  doExport = true;
+  std::filesystem::path summaryPath;  // 空なら標準出力
+};
+
+struct BatchRecord {
+  std::filesystem::path path;
+  int                   errorCode = 0;
+  std::string           message;
+  CaseTiming            timing;
+};
+
+bool IsBatchInput(const std::filesystem::path& path) {
+  const std::string ext = path.extension().string();
+  return ext == ".txt" || ext == ".json";
+}
+
+// ディレクトリなら直下の *.txt（ケース）/ *.json（ジョブ）、ファイルならマニフェスト
+// （1 行 1 パス、マニフェストからの相対、# はコメント）として読む
+std::vector<std::filesystem::path> CollectBatchInputs(const std::filesystem::path& input) {
+  std::vector<std::filesystem::path> files;
+  if (std::filesystem::is_directory(input)) {
+    for (const auto& entry : std::filesystem::directory_iterator(input))
+      if (entry.is_regular_file() && IsBatchInput(entry.path())) files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    return files;
+  }
+
+  std::ifstream ifs(input);
+  if (!ifs)
+    throw std::runtime_error("Failed to open manifest: " + input.string());
+  std::string line;
+  while (std::getline(ifs, line)) {
+    const std::string trimmed = Trim(line);
+    if (trimmed.empty() || trimmed[0] == '#') continue;
+    std::filesystem::path path(trimmed);
+    if (path.is_relative()) path = input.parent_path() / path;
+    files.push_back(path);
+  }
+  return files;
+}
+
+std::string ReadTextFile(const std::filesystem::path& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs)
+    throw std::runtime_error("Failed to open file: " + path.string());
+  std::ostringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+// L1_RunJobs の結果 JSON を記録に移す。ファイル内の全ジョブの時間を合算し、
+// 最初に失敗したジョブのエラーを報告する
+void ReadJobResults(const std::string& json, BatchRecord* record) {
+  const l1::JsonValue root = l1::JsonValue::Parse(json);
+  for (const l1::JsonValue& job : root.Require("jobs", "result").AsArray("result.jobs")) {
+    auto number = [&job](const char* key) {
+      return job.Require(key, "result.jobs[]").AsNumber(key);
+    };
+    record->timing.stockMs  += number("stockMs");
+    record->timing.applyMs  += number("featuresMs");
+    record->timing.exportMs += number("exportMs");
+
+    const int errorCode = static_cast<int>(number("errorCode"));
+    if (errorCode != 0 && record->errorCode == 0) {
+      record->errorCode = errorCode;
+      record->message   = job.Require("stage", "result.jobs[]").AsString("stage") + ": " +
+                          job.Require("message", "result.jobs[]").AsString("message");
+    }
+  }
+}
+
+// ジョブ JSON はネイティブジョブランナーにワーカーのカーネルごと渡す
+// （並列度はバッチ側で持つ）
+BatchRecord RunJobFile(void* kernel, const std::filesystem::path& path, bool doExport) {
+  BatchRecord record;
+  record.path = path;
+  const auto start = Clock::now();
+
+  std::string json;
   try {
-    sample = LoadCaseFile(casePath);
+    json = ReadTextFile(path);
   } catch (const std::exception& ex) {
-    std::cerr << "Failed to load case file: " << casePath << "\n" << ex.what() << std::endl;
-    return 1;
+    record.errorCode = 1;
+    record.message   = ex.what();
+    return record;
   }
-  const auto loadEnd = Clock::now();
+  record.timing.loadMs = ElapsedMs(start, Clock::now());
 
-  const auto kernelStart = Clock::now();
+  JobRunOptions opt{};
+  opt.structSize = sizeof(opt);
+  opt.skipExport = doExport ? 0 : 1;
+  opt.kernel     = kernel;
+  char* resultJson = nullptr;
+  const int rc = L1_RunJobs(json.c_str(), &opt, &resultJson);
+  const std::string result = resultJson ? resultJson : "";
+  L1_FreeString(resultJson);
 
-  void* kernel = L1_CreateKernel();
-  if (!kernel) {
-    std::cerr << "L1_CreateKernel failed" << std::endl;
-    return 1;
+  try {
+    if (rc != 0) {
+      record.errorCode = rc;
+      const l1::JsonValue root = l1::JsonValue::Parse(result);
+      if (const l1::JsonValue* error = root.Find("error"))
+        record.message = error->AsString("error");
+    } else {
+      ReadJobResults(result, &record);
+    }
+  } catch (const std::exception& ex) {
+    if (record.errorCode == 0) record.errorCode = 1;
+    record.message = std::string("Unreadable L1_RunJobs result: ") + ex.what();
   }
+  record.timing.totalMs = ElapsedMs(start, Clock::now());
+  return record;
+}
 
-  int stockId = 0;
-  if (!Check(L1_CreateStock(kernel, &sample.stock, &stockId), "L1_CreateStock")) {
-    L1_DestroyKernel(kernel);
-    return 1;
+BatchRecord RunCaseFile(void* kernel, const std::filesystem::path& path, bool doExport) {
+  BatchRecord record;
+  record.path = path;
+  const auto start = Clock::now();
+
+  SampleCase sample{};
+  try {
+    sample = LoadCaseFile(path);
+  } catch (const std::exception& ex) {
+    record.errorCode = 1;
+    record.message   = ex.what();
+    return record;
   }
-  const auto kernelEnd = Clock::now();
+  record.timing.loadMs = ElapsedMs(start, Clock::now());
+
+  const CaseRun run = RunCase(kernel, sample, doExport);
+  record.errorCode      = run.errorCode;
+  record.message        = run.failedStep;
+  record.timing.stockMs  = run.timing.stockMs;
+  record.timing.applyMs  = run.timing.applyMs;
+  record.timing.exportMs = run.timing.exportMs;
+  record.timing.totalMs  = ElapsedMs(start, Clock::now());
+  return record;
+}
 
-  const auto applyStart = Clock::now();
+std::vector<BatchRecord> RunBatch(const std::vector<std::filesystem::path>& files,
+                                  int threads, bool doExport) {
+  std::vector<BatchRecord> records(files.size());
+  std::atomic<std::size_t> next{0};
+
+  // ワーカーごとにカーネルを 1 つ持ち、ケース / ジョブ間は L1_ResetKernel で使い回す
+  auto worker = [&]() {
+    void* kernel = nullptr;
+    for (std::size_t i = next++; i < files.size(); i = next++) {
+      if (!kernel) kernel = L1_CreateKernel();
+      if (!kernel) {
+        records[i].path      = files[i];
+        records[i].errorCode = 4;
+        records[i].message   = "L1_CreateKernel failed";
+        continue;
+      }
+      records[i] = files[i].extension() == ".json" ? RunJobFile(kernel, files[i], doExport)
+                                                   : RunCaseFile(kernel, files[i], doExport);
+      L1_ResetKernel(kernel);
+    }
+    if (kernel) L1_DestroyKernel(kernel);
+  };
 
-  OperationResult result{};
-  int rc = 0;
-  const std::string& ft = sample.featureType;
+  std::vector<std::thread> pool;
+  for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+  worker();
+  for (std::thread& thread : pool) thread.join();
+  return records;
+}
 
-  if (ft == "MILL_HOLE") {
-    rc = L1_ApplyMillHole(kernel, stockId, &sample.millHole, &result);
-  } else if (ft == "POCKET_RECT") {
-    rc = L1_ApplyPocketRect(kernel, stockId, &sample.pocketRect, &result);
-  } else if (ft == "TURN_OD") {
-    rc = L1_ApplyTurnOd(kernel, stockId,
-                         &sample.turnOd.axis,
-                         sample.turnOd.segments.data(),
-                         static_cast<int>(sample.turnOd.segments.size()),
-                         sample.turnOd.closed, &result);
-  } else if (ft == "TURN_ID") {
-    rc = L1_ApplyTurnId(kernel, stockId,
-                         &sample.turnId.axis,
-                         sample.turnId.segments.data(),
-                         static_cast<int>(sample.turnId.segments.size()),
-                         sample.turnId.closed, &result);
-  } else if (ft == "MILL_CONTOUR") {
-    rc = L1_ApplyMillContour(kernel, stockId,
-                              &sample.millContour.axis,
-                              sample.millContour.segments.data(),
-                              static_cast<int>(sample.millContour.segments.size()),
-                              sample.millContour.closed,
-                              sample.millContour.depth, &result);
-  } else {
-    std::cerr << "Unsupported feature.type: " << ft << std::endl;
-    L1_DeleteShape(kernel, stockId);
-    L1_DestroyKernel(kernel);
-    return 1;
+// 最近順位法によるパーセンタイル
+double Percentile(std::vector<double> values, double p) {
+  if (values.empty()) return 0.0;
+  std::sort(values.begin(), values.end());
+  const std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * values.size()));
+  return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+      out += buf;
+    } else {
+      out += c;
+    }
   }
+  return out;
+}
 
-  if (!Check(rc, "L1_ApplyXxx")) {
-    L1_DeleteShape(kernel, stockId);
-    L1_DestroyKernel(kernel);
+std::string FormatBatchSummary(const std::vector<BatchRecord>& records, int threads,
+                               double wallMs) {
+  struct Phase {
+    const char* name;
+    double CaseTiming::*field;
+  };
+  const Phase phases[] = {
+      {"load",   &CaseTiming::loadMs},
+      {"stock",  &CaseTiming::stockMs},
+      {"apply",  &CaseTiming::applyMs},
+      {"export", &CaseTiming::exportMs},
+      {"total",  &CaseTiming::totalMs},
+  };
+
+  int failed = 0;
+  for (const BatchRecord& r : records)
+    if (r.errorCode != 0) ++failed;
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\n  \"files\": " << records.size()
+     << ",\n  \"failed\": " << failed
+     << ",\n  \"threads\": " << threads
+     << ",\n  \"wallMs\": " << wallMs
+     << ",\n  \"jobsPerSecond\": " << (wallMs > 0.0 ? records.size() * 1000.0 / wallMs : 0.0)
+     << ",\n  \"phasesMs\": {";
+
+  // 失敗したケースは計測対象から外す
+  for (std::size_t k = 0; k < std::size(phases); ++k) {
+    std::vector<double> values;
+    for (const BatchRecord& r : records)
+      if (r.errorCode == 0) values.push_back(r.timing.*phases[k].field);
+    const double maxValue = values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+    os << (k ? "," : "") << "\n    \"" << phases[k].name << "\": {"
+       << "\"p50\": " << Percentile(values, 50.0)
+       << ", \"p95\": " << Percentile(values, 95.0)
+       << ", \"p99\": " << Percentile(values, 99.0)
+       << ", \"max\": " << maxValue << "}";
+  }
+  os << "\n  },\n  \"failures\": [";
+
+  bool first = true;
+  for (const BatchRecord& r : records) {
+    if (r.errorCode == 0) continue;
+    os << (first ? "" : ",") << "\n    {\"file\": \"" << JsonEscape(r.path.string())
+       << "\", \"errorCode\": " << r.errorCode
+       << ", \"message\": \"" << JsonEscape(r.message) << "\"}";
+    first = false;
+  }
+  os << (first ? "]" : "\n  ]") << "\n}\n";
+  return os.str();
+}
+
+int RunBatchMode(const BatchOptions& options) {
+  std::vector<std::filesystem::path> files;
+  try {
+    files = CollectBatchInputs(options.input);
+  } catch (const std::exception& ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+  if (files.empty()) {
+    std::cerr << "No case/job files found: " << options.input << std::endl;
     return 1;
   }
-  const auto applyEnd = Clock::now();
 
-  std::filesystem::path outDir = std::filesystem::current_path() / sample.outputDir;
-  std::filesystem::create_directories(outDir);
+  const int hw = static_cast<int>(std::thread::hardware_concurrency());
+  int threads = options.threads > 0 ? options.threads : std::max(1, hw);
+  threads = std::min<int>(threads, static_cast<int>(files.size()));
 
-  OutputOptions stepOpt = sample.outputOptions;
-  stepOpt.format = OUT_STEP;
+  const auto start = Clock::now();
+  const std::vector<BatchRecord> records = RunBatch(files, threads, options.doExport);
+  const double wallMs = ElapsedMs(start, Clock::now());
 
-  OutputOptions stlOpt = sample.outputOptions;
-  stlOpt.format = OUT_STL;
+  const std::string summary = FormatBatchSummary(records, threads, wallMs);
+  if (options.summaryPath.empty()) {
+    std::cout << summary;
+  } else {
+    std::ofstream ofs(options.summaryPath, std::ios::trunc);
+    ofs << summary;
+    if (!ofs) {
+      std::cerr << "Failed to write summary: " << options.summaryPath << std::endl;
+      return 1;
+    }
+  }
 
-  const std::string stepPath      = (outDir / sample.stepFileName).string();
-  const std::string stlPath       = (outDir / sample.stlFileName).string();
-  const std::string deltaStepPath = (outDir / sample.deltaStepFileName).string();
-  const std::string deltaStlPath  = (outDir / sample.deltaStlFileName).string();
-  const bool hasRemovalStepPath   = !sample.removalStepFileName.empty();
-  const bool hasRemovalStlPath    = !sample.removalStlFileName.empty();
-  const std::string removalStepPath = hasRemovalStepPath
-      ? (outDir / sample.removalStepFileName).string()
-      : std::string();
-  const std::string removalStlPath = hasRemovalStlPath
-      ? (outDir / sample.removalStlFileName).string()
-      : std::string();
+  for (const BatchRecord& r : records)
+    if (r.errorCode != 0) return 2;
+  return 0;
+}
 
-  const auto exportStart = Clock::now();
+// --batch <dir|manifest> [--threads N] [--no-export] [--summary file]
+bool ParseBatchArgs(int argc, char* argv[], BatchOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--batch" && i + 1 < argc) {
+      options->input = argv[++i];
+    } else if (arg == "--threads" && i + 1 < argc) {
+      options->threads = std::stoi(argv[++i]);
+    } else if (arg == "--summary" && i + 1 < argc) {
+      options->summaryPath = argv[++i];
+    } else if (arg == "--no-export") {
+      options->doExport = false;
+    } else {
+      throw std::runtime_error("Unknown batch argument: " + arg);
+    }
+  }
+  return !options->input.empty();
+}
 
-  auto cleanup = [&]() {
-    L1_DeleteShape(kernel, result.removalShapeId);
-    L1_DeleteShape(kernel, result.deltaShapeId);
-    L1_DeleteShape(kernel, result.resultShapeId);
-    L1_DeleteShape(kernel, stockId);
-    L1_DestroyKernel(kernel);
-  };
+}  // namespace
 
-  if (!Check(L1_ExportShape(kernel, result.resultShapeId, &stepOpt, stepPath.c_str()),      "L1_ExportShape(STEP)"))      { cleanup(); return 1; }
-  if (!Check(L1_ExportShape(kernel, result.resultShapeId, &stlOpt,  stlPath.c_str()),       "L1_ExportShape(STL)"))       { cleanup(); return 1; }
-  if (!Check(L1_ExportShape(kernel, result.deltaShapeId,  &stepOpt, deltaStepPath.c_str()), "L1_ExportShape(DELTA STEP)")) { cleanup(); return 1; }
-  if (!Check(L1_ExportShape(kernel, result.deltaShapeId,  &stlOpt,  deltaStlPath.c_str()),  "L1_ExportShape(DELTA STL)"))  { cleanup(); return 1; }
-  if (hasRemovalStepPath &&
-      !Check(L1_ExportShape(kernel, result.removalShapeId, &stepOpt, removalStepPath.c_str()), "L1_ExportShape(REMOVAL STEP)")) { cleanup(); return 1; }
-  if (hasRemovalStlPath &&
-      !Check(L1_ExportShape(kernel, result.removalShapeId, &stlOpt, removalStlPath.c_str()), "L1_ExportShape(REMOVAL STL)")) { cleanup(); return 1; }
+int main(int argc, char* argv[]) {
+  if (argc >= 2 && std::string(argv[1]).rfind("--", 0) == 0) {
+    BatchOptions options;
+    try {
+      if (!ParseBatchArgs(argc, argv, &options)) {
+        std::cerr << "Usage: occt_geometry_sample --batch <dir|manifest> [--threads N]"
+                     " [--no-export] [--summary file]" << std::endl;
+        return 1;
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return 1;
+    }
+    return RunBatchMode(options);
+  }
 
-  const auto exportEnd = Clock::now();
+  const auto totalStart = Clock::now();
 
-  cleanup();
+  const std::filesystem::path casePath = (argc >= 2)
+      ? std::filesystem::path(argv[1])
+      : std::filesystem::path("samples") / "box_mill_hole_case.txt";
+
+  const auto loadStart = Clock::now();
+  SampleCase sample{};
+  try {
+    sample = LoadCaseFile(casePath);
+  } catch (const std::exception& ex) {
+    std::cerr << "Failed to load case file: " << casePath << "\n" << ex.what() << std::endl;
+    return 1;
+  }
+  const auto loadEnd = Clock::now();
+
+  const auto kernelStart = Clock::now();
+  void* kernel = L1_CreateKernel();
+  if (!kernel) {
+    std::cerr << "L1_CreateKernel failed" << std::endl;
+    return 1;
+  }
+  const double createKernelMs = ElapsedMs(kernelStart, Clock::now());
+
+  const CaseRun run = RunCase(kernel, sample, true);
+  L1_DestroyKernel(kernel);
+  if (!Check(run.errorCode, run.failedStep.c_str())) return 1;
 
-  std::cout << "Generated: " << stepPath      << "\n"
-            << "Generated: " << stlPath       << "\n"
-            << "Generated: " << deltaStepPath << "\n"
-            << "Generated: " << deltaStlPath  << "\n";
-  if (hasRemovalStepPath)
-    std::cout << "Generated: " << removalStepPath << "\n";
-  if (hasRemovalStlPath)
-    std::cout << "Generated: " << removalStlPath << "\n";
+  for (const std::string& path : run.generated)
+    std::cout << "Generated: " << path << "\n";
 
   std::cout << std::fixed << std::setprecision(3)
             << "Timing(ms): LoadCaseFile=" << ElapsedMs(loadStart, loadEnd)
-            << ", CreateKernel+CreateStock=" << ElapsedMs(kernelStart, kernelEnd)
-            << ", ApplyFeature=" << ElapsedMs(applyStart, applyEnd)
-            << ", Export=" << ElapsedMs(exportStart, exportEnd)
+            << ", CreateKernel+CreateStock=" << createKernelMs + run.timing.stockMs
+            << ", ApplyFeature=" << run.timing.applyMs
+            << ", Export=" << run.timing.exportMs
             << ", Total=" << ElapsedMs(totalStart, Clock::now()) << std::endl;
 
   return 0;
@@ -0,0 +1,231 @@
+#include "call_journal.h"
+#include "l1_error_codes.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace l1 {
+namespace journal {
+
+namespace {
+
+const char* kJournalPathEnv = "L1_JOURNAL_PATH";
+
+// Producers block once this much is queued and the writer has not caught up.
+constexpr std::size_t kMaxPendingBytes = 64 * 1024 * 1024;
+
+// How long the exit flush waits for a batch the writer is writing.
+constexpr std::chrono::milliseconds kExitFlushWait{200};
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<bool>              gEnabled{false};
+std::atomic<Clock::rep>        gEpoch{0};
+std::atomic<std::uint32_t>     gNextThreadTag{0};
+
+std::uint32_t ThreadTag() {
+  thread_local const std::uint32_t tag = ++gNextThreadTag;
+  return tag;
+}
+
+// Calls append to an in-memory buffer; one background thread swaps it out
+// and writes it, so a call never waits on the disk.
+class Journal {
+ public:
+
+  int Start(const std::string& pathUtf8) {
+    Stop();
+    std::lock_guard<std::mutex> control(controlMutex_);
+
+    std::ofstream file(std::filesystem::u8path(pathUtf8), std::ios::binary | std::ios::trunc);
+    if (!file) return ERROR_INVALID_ARGUMENT;
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version          = kVersion;
+    header.recordHeaderSize = sizeof(RecordHeader);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      file_     = std::move(file);
+      pending_.clear();
+      open_     = true;
+      stopping_ = false;
+    }
+    gEpoch = Clock::now().time_since_epoch().count();
+    writer_ = std::thread([this] { WriterLoop(); });
+    gEnabled = true;
+    return ERROR_OK;
+  }
+
+  void Stop() {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    gEnabled = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!open_) return;
+      stopping_ = true;
+    }
+    dataCv_.notify_all();
+    spaceCv_.notify_all();
+    if (writer_.joinable()) writer_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+    pending_.clear();
+    file_.close();
+    open_ = false;
+  }
+
+  // Runs during static destruction when the journal was not stopped. The
+  // writer must not be joined there: under the loader lock that deadlocks,
+  // and at process exit the thread may already have been terminated, even
+  // while holding one of the mutexes. So the mutexes are only tried, and
+  // whatever is still queued is written behind the writer's back.
+  void FlushAtExit() {
+    gEnabled = false;
+    std::unique_lock<std::mutex> fileLock(fileMutex_, std::try_to_lock);
+    for (const auto deadline = Clock::now() + kExitFlushWait;
+         !fileLock && Clock::now() < deadline;) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      fileLock.try_lock();
+    }
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!fileLock || !lock || !open_) return;
+    stopping_ = true;
+    file_.write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+    pending_.clear();
+    file_.flush();
+  }
+
+  void Append(const RecordHeader& header, const std::string& payload) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    spaceCv_.wait(lock, [this] { return pending_.size() < kMaxPendingBytes || stopping_; });
+    if (!open_ || stopping_) return;
+    pending_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    pending_.append(payload);
+    dataCv_.notify_one();
+  }
+
+ private:
+  void WriterLoop() {
+    std::string batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      dataCv_.wait(lock, [this] { return !pending_.empty() || stopping_; });
+      if (pending_.empty()) break;  // stopping
+      batch.swap(pending_);
+      spaceCv_.notify_all();
+
+      lock.unlock();
+      {
+        std::lock_guard<std::mutex> fileLock(fileMutex_);
+        file_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+      }
+      batch.clear();
+      lock.lock();
+    }
+    file_.flush();
+  }
+
+  std::mutex              controlMutex_;  // serialises Start / Stop
+  std::mutex              fileMutex_;     // held by the writer while it writes a batch
+  std::mutex              mutex_;
+  std::condition_variable dataCv_;
+  std::condition_variable spaceCv_;
+  std::string             pending_;
+  std::ofstream           file_;
+  bool                    open_     = false;
+  bool                    stopping_ = false;
+  std::thread             writer_;
+};
+
+// Never destroyed: a writer left running by a caller that did not stop the
+// journal may still touch it after static destruction.
+Journal& Instance() {
+  static Journal* const journal = new Journal;
+  return *journal;
+}
+
+struct ExitFlush {
+  ~ExitFlush() { Instance().FlushAtExit(); }
+} gExitFlush;
+
+}  // namespace
+
+const char* CallName(Call call) {
+  switch (call) {
+    case Call::kCreateKernel:     return "CreateKernel";
+    case Call::kDestroyKernel:    return "DestroyKernel";
+    case Call::kResetKernel:      return "ResetKernel";
+    case Call::kSetKernelOptions: return "SetKernelOptions";
+    case Call::kCreateStock:      return "CreateStock";
+    case Call::kApplyMillHole:    return "ApplyMillHole";
+    case Call::kApplyPocketRect:  return "ApplyPocketRect";
+    case Call::kApplyTurnOd:      return "ApplyTurnOd";
+    case Call::kApplyTurnId:      return "ApplyTurnId";
+    case Call::kApplyMillContour: return "ApplyMillContour";
+    case Call::kDeleteShape:      return "DeleteShape";
+    case Call::kImportStep:       return "ImportStep";
+    case Call::kExportShape:      return "ExportShape";
+    case Call::kExportShapeEx:    return "ExportShapeEx";
+    case Call::kGetKernelOptions: return "GetKernelOptions";
+    case Call::kExportStepBodies: return "ExportStepBodies";
+    case Call::kImportStepEx:     return "ImportStepEx";
+    case Call::kValidateShape:    return "ValidateShape";
+    case Call::kCompareShapes:    return "CompareShapes";
+    case Call::kApplyMillSlot:    return "ApplyMillSlot";
+    case Call::kForkKernel:       return "ForkKernel";
+    case Call::kComputeMassProperties: return "ComputeMassProperties";
+    case Call::kSectionShape:     return "SectionShape";
+    case Call::kQueryClearance:   return "QueryClearance";
+  }
+  return "Unknown";
+}
+
+bool IsEnabled() {
+  static const bool startedFromEnvironment = [] {
+    const char* path = std::getenv(kJournalPathEnv);
+    return path && *path != '\0' && Instance().Start(path) == ERROR_OK;
+  }();
+  (void)startedFromEnvironment;
+  return gEnabled.load(std::memory_order_relaxed);
+}
+
+double NowMs() {
+  const Clock::duration elapsed = Clock::now().time_since_epoch() - Clock::duration(gEpoch.load());
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+int Start(const std::string& pathUtf8) {
+  IsEnabled();  // an environment-started journal must not replace this one later
+  return Instance().Start(pathUtf8);
+}
+
+void Stop() {
+  Instance().Stop();
+}
+
+void Append(Call call, std::uint16_t flags, const void* kernel,
+            double startMs, double durationMs, int returnCode, std::string payload) {
+  RecordHeader header{};
+  header.payloadSize = static_cast<std::uint32_t>(payload.size());
+  header.call        = static_cast<std::uint16_t>(call);
+  header.flags       = flags;
+  header.kernel      = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(kernel));
+  header.startMs     = startMs;
+  header.durationMs  = durationMs;
+  header.returnCode  = returnCode;
+  header.threadTag   = ThreadTag();
+  Instance().Append(header, payload);
+}
+
+}  // namespace journal
+}  // namespace l1
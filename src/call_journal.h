@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace l1 {
+namespace journal {
+
+// Binary call journal (see 1_funcspec.md §26). The file is a FileHeader
+// followed by records; each record is a RecordHeader and `payloadSize`
+// bytes of payload. Values are stored in native (little-endian) layout, so
+// a journal is replayed on the platform that wrote it.
+
+constexpr char          kMagic[4] = {'L', '1', 'J', 'R'};
+constexpr std::uint32_t kVersion  = 2;
+
+struct FileHeader {
+  char          magic[4];
+  std::uint32_t version;
+  std::uint32_t recordHeaderSize;
+  std::uint32_t reserved;
+};
+
+enum class Call : std::uint16_t {
+  kCreateKernel     = 1,
+  kDestroyKernel    = 2,
+  kResetKernel      = 3,
+  kSetKernelOptions = 4,
+  kCreateStock      = 5,
+  kApplyMillHole    = 6,
+  kApplyPocketRect  = 7,
+  kApplyTurnOd      = 8,
+  kApplyTurnId      = 9,
+  kApplyMillContour = 10,
+  kDeleteShape      = 11,
+  kImportStep       = 12,
+  kExportShape      = 13,
+  kExportShapeEx    = 14,
+  kGetKernelOptions = 15,  // worker protocol only; not journaled
+  kExportStepBodies = 16,
+  kImportStepEx     = 17,
+  kValidateShape    = 18,  // worker protocol only; not journaled
+  kCompareShapes    = 19,  // worker protocol only; not journaled
+  kApplyMillSlot    = 20,
+  kForkKernel       = 21,  // in-process only; the worker protocol has no fork
+  kComputeMassProperties = 22,  // worker protocol only; not journaled
+  kSectionShape     = 23,  // worker protocol only; not journaled
+  kQueryClearance   = 24,  // worker protocol only; not journaled
+};
+
+const char* CallName(Call call);
+
+enum RecordFlags : std::uint16_t {
+  kFlagAsync = 1,  // ran as an async operation; timing covers the work only
+};
+
+struct RecordHeader {
+  std::uint32_t payloadSize;
+  std::uint16_t call;
+  std::uint16_t flags;
+  std::uint64_t kernel;      // kernel handle as seen by the caller
+  double        startMs;     // since the journal was started
+  double        durationMs;
+  std::int32_t  returnCode;
+  std::uint32_t threadTag;   // small per-thread number, for reading the journal
+};
+static_assert(sizeof(RecordHeader) == 40, "RecordHeader layout is part of the file format");
+
+// Payload encoding. Plain structs are stored as their bytes; versioned
+// option structs, arrays and strings as a u32 byte count plus the bytes.
+class PayloadWriter {
+ public:
+  template <typename T>
+  PayloadWriter& Put(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "journal values must be plain data");
+    bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    return *this;
+  }
+
+  PayloadWriter& PutBlob(const void* data, std::size_t size) {
+    Put(static_cast<std::uint32_t>(size));
+    bytes_.append(static_cast<const char*>(data), size);
+    return *this;
+  }
+
+  PayloadWriter& PutString(const char* text) {
+    return PutBlob(text, text ? std::strlen(text) : 0);
+  }
+
+  std::string Take() { return std::move(bytes_); }
+
+ private:
+  std::string bytes_;
+};
+
+class PayloadReader {
+ public:
+  PayloadReader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  T Get() {
+    static_assert(std::is_trivially_copyable<T>::value, "journal values must be plain data");
+    T value;
+    std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  // Copies at most sizeof(T) bytes over `*value` (versioned structs written
+  // by an older or newer build).
+  template <typename T>
+  void GetVersioned(T* value) {
+    const std::uint32_t size = Get<std::uint32_t>();
+    const char* bytes = Take(size);
+    std::memcpy(value, bytes, size < sizeof(T) ? size : sizeof(T));
+  }
+
+  std::string GetString() {
+    const std::uint32_t size = Get<std::uint32_t>();
+    return std::string(Take(size), size);
+  }
+
+  // Array of plain structs stored with PutBlob.
+  template <typename T>
+  std::vector<T> GetArray() {
+    const std::uint32_t size = Get<std::uint32_t>();
+    if (size % sizeof(T) != 0) throw std::runtime_error("journal: bad array size");
+    std::vector<T> items(size / sizeof(T));
+    if (size) std::memcpy(items.data(), Take(size), size);
+    return items;
+  }
+
+ private:
+  const char* Take(std::size_t n) {
+    if (n > size_ - pos_) throw std::runtime_error("journal: truncated record");
+    const char* p = data_ + pos_;
+    pos_ += n;
+    return p;
+  }
+
+  const char* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+};
+
+// --- Writer side (used by the kernel) --------------------------------------
+
+// One relaxed atomic load. The first call also starts the journal when the
+// L1_JOURNAL_PATH environment variable is set.
+bool IsEnabled();
+
+// Milliseconds since the journal was started.
+double NowMs();
+
+// Returns an ErrorCode. Starting while a journal is open closes it first.
+int  Start(const std::string& pathUtf8);
+void Stop();
+
+// Queues one record; the background writer appends it to the file. Blocks
+// only when the writer has fallen far behind.
+void Append(Call call, std::uint16_t flags, const void* kernel,
+            double startMs, double durationMs, int returnCode, std::string payload);
+
+}  // namespace journal
+}  // namespace l1
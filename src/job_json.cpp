@@ -0,0 +1,270 @@
+#include "job_json.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace l1 {
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : text_(text) {}
+
+  JsonValue ParseDocument() {
+    JsonValue value = ParseValue(0);
+    SkipSpace();
+    if (pos_ != text_.size()) Fail("trailing characters");
+    return value;
+  }
+
+ private:
+  static constexpr int kMaxDepth = 64;
+
+  [[noreturn]] void Fail(const char* what) const {
+    throw std::runtime_error(std::string("JSON parse error at offset ") +
+                             std::to_string(pos_) + ": " + what);
+  }
+
+  void SkipSpace() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+            text_[pos_] == '\n' || text_[pos_] == '\r'))
+      ++pos_;
+  }
+
+  bool Consume(char c) {
+    SkipSpace();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  void Expect(char c) {
+    if (!Consume(c)) Fail((std::string("expected '") + c + "'").c_str());
+  }
+
+  bool ConsumeWord(const char* word) {
+    const std::size_t n = std::char_traits<char>::length(word);
+    if (text_.compare(pos_, n, word) != 0) return false;
+    pos_ += n;
+    return true;
+  }
+
+  JsonValue ParseValue(int depth) {
+    if (depth > kMaxDepth) Fail("nesting too deep");
+    SkipSpace();
+    if (pos_ >= text_.size()) Fail("unexpected end of input");
+
+    JsonValue value;
+    const char c = text_[pos_];
+    if (c == '{') {
+      ++pos_;
+      value.type_ = JsonValue::Type::kObject;
+      if (Consume('}')) return value;
+      do {
+        SkipSpace();
+        std::string key = ParseString();
+        Expect(':');
+        value.members_.emplace_back(std::move(key), ParseValue(depth + 1));
+      } while (Consume(','));
+      Expect('}');
+    } else if (c == '[') {
+      ++pos_;
+      value.type_ = JsonValue::Type::kArray;
+      if (Consume(']')) return value;
+      do {
+        value.items_.push_back(ParseValue(depth + 1));
+      } while (Consume(','));
+      Expect(']');
+    } else if (c == '"') {
+      value.type_   = JsonValue::Type::kString;
+      value.string_ = ParseString();
+    } else if (ConsumeWord("true")) {
+      value.type_ = JsonValue::Type::kBool;
+      value.bool_ = true;
+    } else if (ConsumeWord("false")) {
+      value.type_ = JsonValue::Type::kBool;
+    } else if (ConsumeWord("null")) {
+      value.type_ = JsonValue::Type::kNull;
+    } else {
+      value.type_   = JsonValue::Type::kNumber;
+      value.number_ = ParseNumber();
+    }
+    return value;
+  }
+
+  double ParseNumber() {
+    const std::size_t begin = pos_;
+    if (pos_ < text_.size() && text_[pos_] == '-') ++pos_;
+    while (pos_ < text_.size() &&
+           (std::isdigit(static_cast<unsigned char>(text_[pos_])) ||
+            text_[pos_] == '.' || text_[pos_] == 'e' || text_[pos_] == 'E' ||
+            text_[pos_] == '+' || text_[pos_] == '-'))
+      ++pos_;
+    if (pos_ == begin) Fail("unexpected character");
+
+    const std::string token = text_.substr(begin, pos_ - begin);
+    char* end = nullptr;
+    const double number = std::strtod(token.c_str(), &end);
+    if (end != token.c_str() + token.size()) Fail("malformed number");
+    return number;
+  }
+
+  void AppendUtf8(std::string& out, unsigned code) {
+    if (code < 0x80) {
+      out += static_cast<char>(code);
+    } else if (code < 0x800) {
+      out += static_cast<char>(0xC0 | (code >> 6));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      out += static_cast<char>(0xE0 | (code >> 12));
+      out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (code >> 18));
+      out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  unsigned ParseHex4() {
+    if (pos_ + 4 > text_.size()) Fail("truncated \\u escape");
+    unsigned code = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char h = text_[pos_++];
+      code <<= 4;
+      if      (h >= '0' && h <= '9') code |= static_cast<unsigned>(h - '0');
+      else if (h >= 'a' && h <= 'f') code |= static_cast<unsigned>(h - 'a' + 10);
+      else if (h >= 'A' && h <= 'F') code |= static_cast<unsigned>(h - 'A' + 10);
+      else Fail("bad \\u escape");
+    }
+    return code;
+  }
+
+  std::string ParseString() {
+    if (pos_ >= text_.size() || text_[pos_] != '"') Fail("expected string");
+    ++pos_;
+    std::string out;
+    while (true) {
+      if (pos_ >= text_.size()) Fail("unterminated string");
+      const char c = text_[pos_++];
+      if (c == '"') return out;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) Fail("unterminated string");
+      const char e = text_[pos_++];
+      switch (e) {
+        case '"':  out += '"';  break;
+        case '\\': out += '\\'; break;
+        case '/':  out += '/';  break;
+        case 'b':  out += '\b'; break;
+        case 'f':  out += '\f'; break;
+        case 'n':  out += '\n'; break;
+        case 'r':  out += '\r'; break;
+        case 't':  out += '\t'; break;
+        case 'u': {
+          unsigned code = ParseHex4();
+          if (code >= 0xD800 && code < 0xDC00 && ConsumeWord("\\u")) {
+            const unsigned low = ParseHex4();
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          AppendUtf8(out, code);
+          break;
+        }
+        default: Fail("bad escape");
+      }
+    }
+  }
+
+  const std::string& text_;
+  std::size_t        pos_ = 0;
+};
+
+JsonValue JsonValue::Parse(const std::string& text) {
+  return JsonParser(text).ParseDocument();
+}
+
+namespace {
+
+[[noreturn]] void TypeError(const std::string& what, const char* expected) {
+  throw std::runtime_error(what + " must be " + expected);
+}
+
+}  // namespace
+
+bool JsonValue::AsBool(const std::string& what) const {
+  // The job files also use 0/1 for flags.
+  if (type_ == Type::kNumber) return number_ != 0.0;
+  if (type_ != Type::kBool) TypeError(what, "a boolean");
+  return bool_;
+}
+
+double JsonValue::AsNumber(const std::string& what) const {
+  if (type_ != Type::kNumber) TypeError(what, "a number");
+  return number_;
+}
+
+const std::string& JsonValue::AsString(const std::string& what) const {
+  if (type_ != Type::kString) TypeError(what, "a string");
+  return string_;
+}
+
+const std::vector<JsonValue>& JsonValue::AsArray(const std::string& what) const {
+  if (type_ != Type::kArray) TypeError(what, "an array");
+  return items_;
+}
+
+const JsonValue* JsonValue::Find(const std::string& key) const {
+  if (type_ != Type::kObject) return nullptr;
+  for (const Member& member : members_)
+    if (member.first == key) return &member.second;
+  return nullptr;
+}
+
+const JsonValue& JsonValue::Require(const std::string& key, const std::string& what) const {
+  if (type_ != Type::kObject) TypeError(what, "an object");
+  const JsonValue* value = Find(key);
+  if (!value) throw std::runtime_error(what + "." + key + " is required");
+  return *value;
+}
+
+void AppendJsonString(std::string& out, const std::string& text) {
+  out += '"';
+  for (const char c : text) {
+    switch (c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n";  break;
+      case '\r': out += "\\r";  break;
+      case '\t': out += "\\t";  break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+          out += buf;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+void AppendJsonNumber(std::string& out, double value, int decimals) {
+  if (!std::isfinite(value)) {
+    out += "null";
+    return;
+  }
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+  out += buf;
+}
+
+}  // namespace l1
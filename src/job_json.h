@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace l1 {
+
+// Minimal JSON DOM for the job files (samples/*_job.json). Parsing throws
+// std::runtime_error with the byte offset of the problem.
+class JsonValue {
+ public:
+  enum class Type { kNull, kBool, kNumber, kString, kArray, kObject };
+  using Member = std::pair<std::string, JsonValue>;
+
+  static JsonValue Parse(const std::string& text);
+
+  Type Kind() const { return type_; }
+  bool IsNull()   const { return type_ == Type::kNull; }
+  bool IsArray()  const { return type_ == Type::kArray; }
+  bool IsObject() const { return type_ == Type::kObject; }
+
+  // Typed accessors; `what` names the value in the error message.
+  bool               AsBool  (const std::string& what) const;
+  double             AsNumber(const std::string& what) const;
+  const std::string& AsString(const std::string& what) const;
+  const std::vector<JsonValue>& AsArray(const std::string& what) const;
+
+  // Object lookup; nullptr when absent (or when this is not an object).
+  const JsonValue* Find(const std::string& key) const;
+  const JsonValue& Require(const std::string& key, const std::string& what) const;
+
+ private:
+  friend class JsonParser;
+
+  Type                   type_   = Type::kNull;
+  bool                   bool_   = false;
+  double                 number_ = 0.0;
+  std::string            string_;
+  std::vector<JsonValue> items_;
+  std::vector<Member>    members_;
+};
+
+// Appends `text` as a quoted, escaped JSON string.
+void AppendJsonString(std::string& out, const std::string& text);
+
+// Appends a finite number with `decimals` fraction digits ("null" otherwise).
+void AppendJsonNumber(std::string& out, double value, int decimals);
+
+}  // namespace l1
@@ -0,0 +1,545 @@
+#include "job_runner.h"
+#include "job_json.h"
+#include "l1_error_codes.h"
+#include "parallel_for.h"
+#include "versioned_struct.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+namespace l1 {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(const Clock::time_point& begin, const Clock::time_point& end) {
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// ---------------------------------------------------------------------------
+// Job JSON -> DTOs (same rules as L1GeometryAdapter/JsonConverter.cs)
+// ---------------------------------------------------------------------------
+
+std::string ToUpper(std::string text) {
+  for (char& c : text) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  return text;
+}
+
+double OptionalNumber(const JsonValue& object, const std::string& key, double fallback,
+                      const std::string& what) {
+  const JsonValue* value = object.Find(key);
+  return (value && !value->IsNull()) ? value->AsNumber(what + "." + key) : fallback;
+}
+
+std::string OptionalString(const JsonValue& object, const std::string& key,
+                           const std::string& what) {
+  const JsonValue* value = object.Find(key);
+  return (value && !value->IsNull()) ? value->AsString(what + "." + key) : std::string();
+}
+
+void ParseVector3(const JsonValue& value, const std::string& what, double dst[3]) {
+  const std::vector<JsonValue>& items = value.AsArray(what);
+  if (items.size() != 3)
+    throw std::runtime_error(what + " must have exactly 3 elements");
+  for (int i = 0; i < 3; ++i) dst[i] = items[i].AsNumber(what);
+}
+
+AxisDto ParseAxis(const JsonValue& value, const std::string& what) {
+  AxisDto axis{};
+  ParseVector3(value.Require("origin", what), what + ".origin", axis.origin);
+  ParseVector3(value.Require("dir",    what), what + ".dir",    axis.dir);
+  ParseVector3(value.Require("xdir",   what), what + ".xdir",   axis.xdir);
+  return axis;
+}
+
+Path2DPointDto ParsePoint(const JsonValue& value, const std::string& what) {
+  return {value.Require("u", what).AsNumber(what + ".u"),
+          value.Require("v", what).AsNumber(what + ".v")};
+}
+
+void ParseProfile(const JsonValue& profile, const std::string& what,
+                  std::vector<Path2DSegmentDto>* outSegments, int* outClosed) {
+  const std::vector<JsonValue>& segments =
+      profile.Require("segments", what).AsArray(what + ".segments");
+  outSegments->clear();
+  outSegments->reserve(segments.size());
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    const JsonValue& s = segments[i];
+    const std::string sp = what + ".segments[" + std::to_string(i) + "]";
+
+    Path2DSegmentDto seg{};
+    const std::string type = ToUpper(s.Require("type", sp).AsString(sp + ".type"));
+    if      (type == "LINE") seg.type = PATH_SEGMENT_LINE;
+    else if (type == "ARC")  seg.type = PATH_SEGMENT_ARC;
+    else throw std::runtime_error("Unsupported segment type: " + type);
+
+    // LINE ignores the direction; CW matches the C# default.
+    const std::string arcDir = ToUpper(OptionalString(s, "arcDirection", sp));
+    if      (arcDir == "CW" || arcDir.empty()) seg.arcDirection = ARC_DIR_CW;
+    else if (arcDir == "CCW")                  seg.arcDirection = ARC_DIR_CCW;
+    else throw std::runtime_error("Unsupported arcDirection: " + arcDir);
+
+    if (const JsonValue* from   = s.Find("from"))   seg.from   = ParsePoint(*from,   sp + ".from");
+    if (const JsonValue* to     = s.Find("to"))     seg.to     = ParsePoint(*to,     sp + ".to");
+    if (const JsonValue* center = s.Find("center")) seg.center = ParsePoint(*center, sp + ".center");
+    outSegments->push_back(seg);
+  }
+
+  const JsonValue* closed = profile.Find("closed");
+  *outClosed = (closed && closed->AsBool(what + ".closed")) ? 1 : 0;
+}
+
+JobFeature ParseFeature(const JsonValue& value, const std::string& what) {
+  JobFeature feature;
+  feature.type = ToUpper(value.Require("type", what).AsString(what + ".type"));
+
+  if (feature.type == "MILL_HOLE") {
+    const std::string w = what + ".millHole";
+    const JsonValue& f = value.Require("millHole", what);
+    feature.millHole.radius = f.Require("radius", w).AsNumber(w + ".radius");
+    feature.millHole.depth  = f.Require("depth",  w).AsNumber(w + ".depth");
+    feature.millHole.axis   = ParseAxis(f.Require("axis", w), w + ".axis");
+
+  } else if (feature.type == "POCKET_RECT") {
+    const std::string w = what + ".pocketRect";
+    const JsonValue& f = value.Require("pocketRect", what);
+    feature.pocketRect.width  = f.Require("width",  w).AsNumber(w + ".width");
+    feature.pocketRect.height = f.Require("height", w).AsNumber(w + ".height");
+    feature.pocketRect.depth  = f.Require("depth",  w).AsNumber(w + ".depth");
+    feature.pocketRect.axis   = ParseAxis(f.Require("axis", w), w + ".axis");
+
+  } else if (feature.type == "TURN_OD" || feature.type == "TURN_ID" ||
+             feature.type == "MILL_CONTOUR") {
+    const char* key = feature.type == "TURN_OD" ? "turnOd"
+                    : feature.type == "TURN_ID" ? "turnId" : "millContour";
+    const std::string w = what + "." + key;
+    const JsonValue& f = value.Require(key, what);
+    ParseProfile(f.Require("profile", w), w + ".profile", &feature.segments, &feature.closed);
+    feature.axis = ParseAxis(f.Require("axis", w), w + ".axis");
+    if (feature.type == "MILL_CONTOUR")
+      feature.depth = f.Require("depth", w).AsNumber(w + ".depth");
+
+  } else if (feature.type == "MILL_SLOT") {
+    const std::string w = what + ".millSlot";
+    const JsonValue& f = value.Require("millSlot", what);
+    ParseProfile(f.Require("path", w), w + ".path", &feature.segments, &feature.closed);
+    if (feature.closed) throw std::runtime_error(w + ".path must be open");
+    feature.axis       = ParseAxis(f.Require("axis", w), w + ".axis");
+    feature.toolRadius = f.Require("toolRadius", w).AsNumber(w + ".toolRadius");
+    feature.depth      = f.Require("depth", w).AsNumber(w + ".depth");
+
+  } else {
+    throw std::runtime_error("Unsupported feature.type: " + feature.type);
+  }
+  return feature;
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+
+// Result / delta / removal of the latest stage; earlier stages are dropped as
+// soon as they are superseded so long jobs do not accumulate shapes.
+struct StageShapes {
+  void* kernel    = nullptr;
+  int   resultId  = 0;
+  int   deltaId   = 0;
+  int   removalId = 0;
+
+  void Replace(const OperationResult& next) {
+    Release();
+    resultId  = next.resultShapeId;
+    deltaId   = next.deltaShapeId;
+    removalId = next.removalShapeId;
+  }
+
+  void Release() {
+    for (int id : {resultId, deltaId, removalId})
+      if (id > 0) L1_DeleteShape(kernel, id);
+    resultId = deltaId = removalId = 0;
+  }
+};
+
+void Fail(JobOutcome* outcome, int errorCode, const char* stage, std::string message) {
+  outcome->errorCode = errorCode;
+  outcome->stage     = stage;
+  outcome->message   = std::move(message);
+}
+
+int ExportOutputs(void* kernel, const JobSpec& job, const StageShapes& stage,
+                  const JobRunSettings& settings, JobOutcome* outcome) {
+  const JobOutput& out = job.output;
+  const std::filesystem::path outDir = settings.baseDir / std::filesystem::u8path(out.dir);
+  std::error_code ec;
+  std::filesystem::create_directories(outDir, ec);
+
+  OutputOptions stepOpt = out.options;
+  stepOpt.format = OUT_STEP;
+  OutputOptions stlOpt = out.options;
+  stlOpt.format = OUT_STL;
+
+  struct Export { int shapeId; const OutputOptions* opt; const std::string* file; };
+  const Export exports[] = {
+      {stage.resultId,  &stepOpt, &out.stepFile},
+      {stage.resultId,  &stlOpt,  &out.stlFile},
+      {stage.deltaId,   &stepOpt, &out.deltaStepFile},
+      {stage.deltaId,   &stlOpt,  &out.deltaStlFile},
+      {stage.removalId, &stepOpt, &out.removalStepFile},
+      {stage.removalId, &stlOpt,  &out.removalStlFile},
+  };
+  for (const Export& e : exports) {
+    if (e.file->empty()) continue;
+    const std::string path = (outDir / std::filesystem::u8path(*e.file)).u8string();
+    const int rc = L1_ExportShape(kernel, e.shapeId, e.opt, path.c_str());
+    if (rc != ERROR_OK) {
+      Fail(outcome, rc, "export", "L1_ExportShape failed: " + path);
+      return rc;
+    }
+    outcome->outputs.push_back(path);
+  }
+
+  if (!out.combinedStepFile.empty()) {
+    const StepBodyDto candidates[] = {
+        {stage.resultId,  "result",  1, {0.75, 0.75, 0.75}},
+        {stage.deltaId,   "delta",   1, {0.90, 0.45, 0.20}},
+        {stage.removalId, "removal", 1, {0.25, 0.50, 0.90}},
+    };
+    std::vector<StepBodyDto> bodies;
+    for (const StepBodyDto& body : candidates)
+      if (body.shapeId > 0) bodies.push_back(body);
+    const std::string path = (outDir / std::filesystem::u8path(out.combinedStepFile)).u8string();
+    const std::string assemblyName = job.sessionId.empty() ? "job" : job.sessionId;
+    const int rc = L1_ExportStepBodies(kernel, bodies.data(), static_cast<int>(bodies.size()),
+                                       assemblyName.c_str(), path.c_str());
+    if (rc != ERROR_OK) {
+      Fail(outcome, rc, "export", "L1_ExportStepBodies failed: " + path);
+      return rc;
+    }
+    outcome->outputs.push_back(path);
+  }
+  return ERROR_OK;
+}
+
+void AppendField(std::string& out, const char* key) {
+  out += '"';
+  out += key;
+  out += "\":";
+}
+
+}  // namespace
+
+JobSpec ParseJob(const JsonValue& job) {
+  JobSpec spec;
+
+  const JsonValue& stock = job.Require("stock", "job");
+  const std::string stockType = ToUpper(stock.Require("type", "stock").AsString("stock.type"));
+  if      (stockType == "BOX")      spec.stock.type = STOCK_BOX;
+  else if (stockType == "CYLINDER") spec.stock.type = STOCK_CYLINDER;
+  else throw std::runtime_error("Unsupported stock.type: " + stockType);
+  spec.stock.p1   = OptionalNumber(stock, "p1", 0.0, "stock");
+  spec.stock.p2   = OptionalNumber(stock, "p2", 0.0, "stock");
+  spec.stock.p3   = OptionalNumber(stock, "p3", 0.0, "stock");
+  spec.stock.axis = ParseAxis(stock.Require("axis", "stock"), "stock.axis");
+
+  const std::vector<JsonValue>& features = job.Require("features", "job").AsArray("features");
+  if (features.empty())
+    throw std::runtime_error("features must contain at least one item");
+  for (std::size_t i = 0; i < features.size(); ++i)
+    spec.features.push_back(ParseFeature(features[i], "features[" + std::to_string(i) + "]"));
+
+  if (const JsonValue* output = job.Find("output")) {
+    JobOutput& out = spec.output;
+    out.options.linearDeflection  = OptionalNumber(*output, "linearDeflection",  0.0, "output");
+    out.options.angularDeflection = OptionalNumber(*output, "angularDeflection", 0.0, "output");
+    out.options.parallel          = static_cast<int>(OptionalNumber(*output, "parallel", 0.0, "output"));
+    out.dir             = OptionalString(*output, "dir",             "output");
+    out.stepFile        = OptionalString(*output, "stepFile",        "output");
+    out.stlFile         = OptionalString(*output, "stlFile",         "output");
+    out.deltaStepFile   = OptionalString(*output, "deltaStepFile",   "output");
+    out.deltaStlFile    = OptionalString(*output, "deltaStlFile",    "output");
+    out.removalStepFile = OptionalString(*output, "removalStepFile", "output");
+    out.removalStlFile  = OptionalString(*output, "removalStlFile",  "output");
+    out.combinedStepFile = OptionalString(*output, "combinedStepFile", "output");
+  }
+
+  if (const JsonValue* meta = job.Find("meta"))
+    spec.sessionId = OptionalString(*meta, "sessionId", "meta");
+  return spec;
+}
+
+std::vector<JobEntry> ParseJobList(const std::string& jsonUtf8) {
+  const JsonValue root = JsonValue::Parse(jsonUtf8);
+
+  const JsonValue* list = &root;
+  if (root.IsObject())
+    if (const JsonValue* jobs = root.Find("jobs")) list = jobs;
+
+  std::vector<JobEntry> entries;
+  auto add = [&entries](const JsonValue& job) {
+    JobEntry entry;
+    try {
+      entry.spec = ParseJob(job);
+    } catch (const std::exception& ex) {
+      entry.parseError = ex.what();
+    }
+    entries.push_back(std::move(entry));
+  };
+
+  if (list->IsArray()) {
+    for (const JsonValue& job : list->AsArray("jobs")) add(job);
+  } else {
+    add(*list);
+  }
+  return entries;
+}
+
+int ApplyFeature(void* kernel, int stockId, const JobFeature& f, OperationResult* result) {
+  const int segmentCount = static_cast<int>(f.segments.size());
+  if (f.type == "MILL_HOLE")
+    return L1_ApplyMillHole(kernel, stockId, &f.millHole, result);
+  if (f.type == "POCKET_RECT")
+    return L1_ApplyPocketRect(kernel, stockId, &f.pocketRect, result);
+  if (f.type == "TURN_OD")
+    return L1_ApplyTurnOd(kernel, stockId, &f.axis, f.segments.data(), segmentCount,
+                          f.closed, result);
+  if (f.type == "TURN_ID")
+    return L1_ApplyTurnId(kernel, stockId, &f.axis, f.segments.data(), segmentCount,
+                          f.closed, result);
+  if (f.type == "MILL_CONTOUR")
+    return L1_ApplyMillContour(kernel, stockId, &f.axis, f.segments.data(), segmentCount,
+                               f.closed, f.depth, result);
+  if (f.type == "MILL_SLOT")
+    return L1_ApplyMillSlot(kernel, stockId, &f.axis, f.segments.data(), segmentCount,
+                            f.toolRadius, f.depth, result);
+  return ERROR_FEATURE_NOT_SUPPORTED;
+}
+
+JobOutcome RunJob(void* kernel, const JobSpec& job, const JobRunSettings& settings) {
+  JobOutcome outcome;
+  const auto jobStart = Clock::now();
+
+  StageShapes stage;
+  stage.kernel = kernel;
+
+  const auto stockStart = Clock::now();
+  const int stockRc = L1_CreateStock(kernel, &job.stock, &stage.resultId);
+  outcome.stockMs = ElapsedMs(stockStart, Clock::now());
+  if (stockRc != ERROR_OK) {
+    Fail(&outcome, stockRc, "stock", "L1_CreateStock failed");
+    outcome.totalMs = ElapsedMs(jobStart, Clock::now());
+    return outcome;
+  }
+
+  // Pipelined: the tool of feature i + 1 is built while feature i's boolean
+  // runs. The boolean takes the very shape it would have built, so results
+  // do not change.
+  if (settings.pipelined && !job.features.empty())
+    PrefetchFeatureTool(kernel, stage.resultId, nullptr, job.features[0]);
+
+  outcome.features.reserve(job.features.size());
+  for (std::size_t i = 0; i < job.features.size(); ++i) {
+    if (settings.pipelined && i + 1 < job.features.size())
+      PrefetchFeatureTool(kernel, stage.resultId, &job.features[i], job.features[i + 1]);
+
+    OperationResult result{};
+    result.structSize = sizeof(result);
+    const auto featureStart = Clock::now();
+    const int rc = ApplyFeature(kernel, stage.resultId, job.features[i], &result);
+
+    FeatureRun run;
+    run.ms          = ElapsedMs(featureStart, Clock::now());
+    run.errorCode   = rc;
+    run.booleanPath = result.booleanPath;
+    outcome.features.push_back(run);
+    outcome.featuresMs += run.ms;
+
+    if (rc != ERROR_OK) {
+      outcome.failedFeature = static_cast<int>(i);
+      Fail(&outcome, rc, "feature", job.features[i].type + " failed");
+      break;
+    }
+    stage.Replace(result);
+  }
+
+  if (outcome.errorCode == ERROR_OK && settings.exportOutputs) {
+    const auto exportStart = Clock::now();
+    ExportOutputs(kernel, job, stage, settings, &outcome);
+    outcome.exportMs = ElapsedMs(exportStart, Clock::now());
+  }
+
+  stage.Release();
+  outcome.totalMs = ElapsedMs(jobStart, Clock::now());
+  return outcome;
+}
+
+std::vector<JobOutcome> RunJobs(const std::vector<JobEntry>& jobs,
+                                const JobRunSettings& settings, int* outThreadCount) {
+  const int jobCount = static_cast<int>(jobs.size());
+  std::vector<JobOutcome> outcomes(jobs.size());
+  auto run = [&](int i, void* kernel) {
+    JobOutcome& outcome = outcomes[i];
+    if (!jobs[i].parseError.empty()) {
+      Fail(&outcome, ERROR_INVALID_ARGUMENT, "parse", jobs[i].parseError);
+      return;
+    }
+    try {
+      outcome = RunJob(kernel, jobs[i].spec, settings);
+    } catch (const std::exception& ex) {
+      Fail(&outcome, ERROR_OCCT_EXCEPTION, "job", ex.what());
+    }
+  };
+
+  // The caller's kernel may hold shapes of its own, so it is never reset;
+  // RunJob deletes what each job created.
+  if (settings.kernel) {
+    if (outThreadCount) *outThreadCount = 1;
+    for (int i = 0; i < jobCount; ++i) run(i, settings.kernel);
+    return outcomes;
+  }
+
+  const int threads = ParallelThreadCount(jobCount, settings.threadCount);
+  if (outThreadCount) *outThreadCount = threads;
+
+  // Kernels are not shared: each worker owns one for its whole lifetime.
+  std::vector<void*> kernels(static_cast<std::size_t>(threads), nullptr);
+  ParallelFor(jobCount, settings.threadCount, [&](int i, int worker) {
+    if (!jobs[i].parseError.empty()) return run(i, nullptr);
+    void*& kernel = kernels[worker];
+    if (!kernel) kernel = L1_CreateKernel();
+    if (!kernel) {
+      Fail(&outcomes[i], ERROR_OCCT_EXCEPTION, "kernel", "L1_CreateKernel failed");
+      return;
+    }
+    run(i, kernel);
+    // Clean slate for the next job without giving up the warm kernel.
+    L1_ResetKernel(kernel);
+  });
+  for (void* kernel : kernels)
+    if (kernel) L1_DestroyKernel(kernel);
+  return outcomes;
+}
+
+char* CopyToCString(const std::string& text) {
+  char* buffer = static_cast<char*>(std::malloc(text.size() + 1));
+  if (!buffer) return nullptr;
+  std::memcpy(buffer, text.c_str(), text.size() + 1);
+  return buffer;
+}
+
+std::string FormatJobResults(const std::vector<JobEntry>& jobs,
+                             const std::vector<JobOutcome>& outcomes,
+                             int threadCount, double wallMs) {
+  int failed = 0;
+  for (const JobOutcome& outcome : outcomes)
+    if (outcome.errorCode != ERROR_OK) ++failed;
+
+  std::string out;
+  out.reserve(256 + outcomes.size() * 384);
+  out += '{';
+  AppendField(out, "jobCount");    out += std::to_string(outcomes.size());
+  out += ','; AppendField(out, "failedCount"); out += std::to_string(failed);
+  out += ','; AppendField(out, "threadCount"); out += std::to_string(threadCount);
+  out += ','; AppendField(out, "wallMs");      AppendJsonNumber(out, wallMs, 3);
+  out += ','; AppendField(out, "jobsPerSecond");
+  AppendJsonNumber(out, wallMs > 0.0 ? outcomes.size() * 1000.0 / wallMs : 0.0, 3);
+  out += ','; AppendField(out, "jobs"); out += '[';
+
+  for (std::size_t i = 0; i < outcomes.size(); ++i) {
+    const JobOutcome& o = outcomes[i];
+    if (i) out += ',';
+    out += '{';
+    AppendField(out, "index");     out += std::to_string(i);
+    out += ','; AppendField(out, "sessionId"); AppendJsonString(out, jobs[i].spec.sessionId);
+    out += ','; AppendField(out, "errorCode"); out += std::to_string(o.errorCode);
+    out += ','; AppendField(out, "stage");     AppendJsonString(out, o.stage);
+    out += ','; AppendField(out, "message");   AppendJsonString(out, o.message);
+    out += ','; AppendField(out, "failedFeature"); out += std::to_string(o.failedFeature);
+    out += ','; AppendField(out, "stockMs");    AppendJsonNumber(out, o.stockMs,    3);
+    out += ','; AppendField(out, "featuresMs"); AppendJsonNumber(out, o.featuresMs, 3);
+    out += ','; AppendField(out, "exportMs");   AppendJsonNumber(out, o.exportMs,   3);
+    out += ','; AppendField(out, "totalMs");    AppendJsonNumber(out, o.totalMs,    3);
+
+    out += ','; AppendField(out, "features"); out += '[';
+    for (std::size_t k = 0; k < o.features.size(); ++k) {
+      const FeatureRun& f = o.features[k];
+      if (k) out += ',';
+      out += '{';
+      AppendField(out, "type"); AppendJsonString(out, jobs[i].spec.features[k].type);
+      out += ','; AppendField(out, "ms");          AppendJsonNumber(out, f.ms, 3);
+      out += ','; AppendField(out, "errorCode");   out += std::to_string(f.errorCode);
+      out += ','; AppendField(out, "booleanPath"); out += std::to_string(f.booleanPath);
+      out += '}';
+    }
+    out += ']';
+
+    out += ','; AppendField(out, "outputs"); out += '[';
+    for (std::size_t k = 0; k < o.outputs.size(); ++k) {
+      if (k) out += ',';
+      AppendJsonString(out, o.outputs[k]);
+    }
+    out += "]}";
+  }
+  out += "]}";
+  return out;
+}
+
+}  // namespace l1
+
+// ===========================================================================
+// Public API
+// ===========================================================================
+
+int L1_RunJobs(const char* jobsJsonUtf8, const JobRunOptions* opt, char** outResultJson) {
+  if (!jobsJsonUtf8 || !outResultJson) return ERROR_INVALID_ARGUMENT;
+  *outResultJson = nullptr;
+  JobRunOptions options{};
+  options.structSize = sizeof(JobRunOptions);
+  if (opt) {
+    if (!l1::IsValidStructSize<JobRunOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+    l1::CopyStructFields(&options, opt, opt->structSize);
+  }
+  if (options.threadCount < 0) return ERROR_INVALID_ARGUMENT;
+
+  try {
+    l1::JobRunSettings settings;
+    settings.threadCount   = options.threadCount;
+    settings.exportOutputs = options.skipExport == 0;
+    settings.pipelined     = options.pipelined != 0;
+    settings.kernel        = options.kernel;
+    if (options.baseDirUtf8 && *options.baseDirUtf8)
+      settings.baseDir = std::filesystem::u8path(options.baseDirUtf8);
+    if (settings.baseDir.empty()) settings.baseDir = std::filesystem::current_path();
+
+    std::vector<l1::JobEntry> jobs;
+    try {
+      jobs = l1::ParseJobList(jobsJsonUtf8);
+    } catch (const std::exception& ex) {
+      std::string error = "{\"error\":";
+      l1::AppendJsonString(error, ex.what());
+      error += '}';
+      *outResultJson = l1::CopyToCString(error);
+      return ERROR_INVALID_ARGUMENT;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    int threadCount = 0;
+    const std::vector<l1::JobOutcome> outcomes = l1::RunJobs(jobs, settings, &threadCount);
+    const double wallMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    *outResultJson = l1::CopyToCString(l1::FormatJobResults(jobs, outcomes, threadCount, wallMs));
+    return *outResultJson ? ERROR_OK : ERROR_OCCT_EXCEPTION;
+  } catch (...) {
+    return ERROR_OCCT_EXCEPTION;
+  }
+}
+
+void L1_FreeString(char* text) {
+  std::free(text);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "l1_geometry_kernel.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace l1 {
+
+class JsonValue;
+
+// Native form of one job in the samples/*_job.json shape.
+struct JobFeature {
+  std::string                   type;  // MILL_HOLE / POCKET_RECT / TURN_OD / TURN_ID / MILL_CONTOUR / MILL_SLOT
+  MillHoleFeatureDto            millHole{};
+  PocketRectFeatureDto          pocketRect{};
+  AxisDto                       axis{};      // TURN_* / MILL_CONTOUR / MILL_SLOT
+  std::vector<Path2DSegmentDto> segments;    // TURN_* / MILL_CONTOUR / MILL_SLOT (open path)
+  int                           closed = 1;
+  double                        depth  = 0.0;  // MILL_CONTOUR / MILL_SLOT
+  double                        toolRadius = 0.0;  // MILL_SLOT
+};
+
+struct JobOutput {
+  OutputOptions options{};
+  std::string   dir;
+  std::string   stepFile;
+  std::string   stlFile;
+  std::string   deltaStepFile;
+  std::string   deltaStlFile;
+  std::string   removalStepFile;  // optional
+  std::string   removalStlFile;   // optional
+  std::string   combinedStepFile; // optional: result / delta / removal as one STEP assembly
+};
+
+struct JobSpec {
+  StockDto                stock{};
+  std::vector<JobFeature> features;
+  JobOutput               output;
+  std::string             sessionId;
+};
+
+// One job of a batch; `parseError` is set when the job could not be read and
+// the job is reported as failed without running.
+struct JobEntry {
+  JobSpec     spec;
+  std::string parseError;
+};
+
+// Throws std::runtime_error naming the offending field.
+JobSpec ParseJob(const JsonValue& job);
+
+// Accepts a single job object, an array of jobs or {"jobs": [...]}. Throws
+// only when the document itself is malformed.
+std::vector<JobEntry> ParseJobList(const std::string& jsonUtf8);
+
+struct FeatureRun {
+  double      ms          = 0.0;
+  int         errorCode   = 0;
+  BooleanPath booleanPath = BOOLEAN_PATH_FULL;
+};
+
+struct JobOutcome {
+  int                      errorCode = 0;
+  std::string              stage;     // where it failed: parse / stock / feature / export
+  std::string              message;
+  int                      failedFeature = -1;
+  double                   stockMs    = 0.0;
+  double                   featuresMs = 0.0;
+  double                   exportMs   = 0.0;
+  double                   totalMs    = 0.0;
+  std::vector<FeatureRun>  features;
+  std::vector<std::string> outputs;
+};
+
+struct JobRunSettings {
+  int                   threadCount   = 0;     // 0: hardware concurrency
+  bool                  exportOutputs = true;
+  bool                  pipelined     = false; // build the next feature's tool during each boolean
+  std::filesystem::path baseDir;               // output.dir is resolved against this
+  void*                 kernel        = nullptr; // non-null: run the jobs in order on it
+};
+
+// Queues the tool of `feature` on the kernel's prefetch thread; the
+// feature's L1_Apply* call on `kernel` then takes it instead of building it.
+// `feature` is applied to `stockId` after `previous` (null: directly).
+// Features whose tool is a single primitive, and turn features that will
+// take the half-section fast path, are ignored. Defined in
+// l1_geometry_kernel.cpp.
+void PrefetchFeatureTool(void* kernel, int stockId, const JobFeature* previous,
+                         const JobFeature& feature);
+
+// The L1_Apply* call for `feature.type` on `stockId`;
+// ERROR_FEATURE_NOT_SUPPORTED for an unknown type.
+int ApplyFeature(void* kernel, int stockId, const JobFeature& feature, OperationResult* result);
+
+// Runs one job on `kernel` and removes every shape it created.
+JobOutcome RunJob(void* kernel, const JobSpec& job, const JobRunSettings& settings);
+
+// Runs the jobs on a fixed pool with one kernel per worker, or in order on
+// settings.kernel when set. Outcomes are in job order.
+std::vector<JobOutcome> RunJobs(const std::vector<JobEntry>& jobs,
+                                const JobRunSettings& settings, int* outThreadCount);
+
+// malloc'd copy for the char** outputs of the C API (freed by L1_FreeString).
+char* CopyToCString(const std::string& text);
+
+std::string FormatJobResults(const std::vector<JobEntry>& jobs,
+                             const std::vector<JobOutcome>& outcomes,
+                             int threadCount, double wallMs);
+
+}  // namespace l1
@@ -0,0 +1,20 @@
+#pragma once
+
+// Return codes of the L1_* API. Shared by the kernel and the native job runner.
+enum ErrorCode {
+  ERROR_OK                    = 0,
+  ERROR_INVALID_ARGUMENT      = 1,
+  ERROR_SHAPE_NOT_FOUND       = 2,
+  ERROR_FEATURE_NOT_SUPPORTED = 3,
+  ERROR_OCCT_EXCEPTION        = 4,
+  ERROR_BOOLEAN_FAILED        = 5,
+  ERROR_DELTA_FAILED          = 6,
+  ERROR_EXPORT_FAILED         = 7,
+  ERROR_IMPORT_FAILED         = 8,
+  ERROR_CANCELLED             = 9,
+  ERROR_DEADLINE_EXCEEDED     = 10,
+  ERROR_OPERATION_PENDING     = 11,
+  ERROR_WORKER_UNAVAILABLE    = 12,  // l1_geometry_remote: no worker reachable or the connection dropped
+  ERROR_INVALID_RESULT        = 13,  // a boolean result failed KernelOptions.validateResults
+  ERROR_BUFFER_TOO_SMALL      = 14   // a caller-sized output array cannot hold the result
+};
@@ -1,83 +1,788 @@
 #include "l1_geometry_kernel.h"
+#include "call_journal.h"
+#include "job_json.h"
+#include "job_runner.h"
+#include "l1_error_codes.h"
+#include "mesh_deviation.h"
+#include "parallel_for.h"
+#include "quantized_mesh.h"
+#include "versioned_struct.h"
+#include "zmap_preview.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <BRep_Builder.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#include <BOPAlgo_PaveFiller.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepAlgoAPI_Common.hxx>
 #include <BRepAlgoAPI_Cut.hxx>
+#include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepAlgoAPI_Section.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakePolygon.hxx>
 #include <BRepBuilderAPI_MakeWire.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepCheck_Analyzer.hxx>
+#include <BRepGProp.hxx>
+#include <BRepClass3d_SolidClassifier.hxx>
+#include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <BRepPrimAPI_MakeBox.hxx>
 #include <BRepPrimAPI_MakeCylinder.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
 #include <BRepPrimAPI_MakeRevol.hxx>
+#include <BRepTools.hxx>
+#include <Bnd_Box.hxx>
+#include <Bnd_OBB.hxx>
 #include <GC_MakeArcOfCircle.hxx>
+#include <GCPnts_QuasiUniformDeflection.hxx>
+#include <GProp_GProps.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <Message_ProgressIndicator.hxx>
+#include <NCollection_IncAllocator.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <Quantity_Color.hxx>
+#include <Message_ProgressRange.hxx>
+#include <Message_ProgressScope.hxx>
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <gp.hxx>
 #include <gp_Ax2.hxx>
+#include <gp_Ax3.hxx>
 #include <gp_Ax1.hxx>
 #include <gp_Circ.hxx>
 #include <gp_Dir.hxx>
+#include <gp_Pln.hxx>
 #include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
 #include <gp_Vec.hxx>
+#include <STEPCAFControl_Writer.hxx>
 #include <STEPControl_Reader.hxx>
 #include <STEPControl_Writer.hxx>
+#include <ShapeFix_Shape.hxx>
+#include <ShapeFix_ShapeTolerance.hxx>
+#include <ShapeFix_Wireframe.hxx>
+#include <ShapeUpgrade_UnifySameDomain.hxx>
 #include <StlAPI_Writer.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDF_Label.hxx>
+#include <TDocStd_Document.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <XCAFDoc_ColorTool.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
 
-enum ErrorCode {
-  ERROR_OK                    = 0,
-  ERROR_INVALID_ARGUMENT      = 1,
-  ERROR_SHAPE_NOT_FOUND       = 2,
-  ERROR_FEATURE_NOT_SUPPORTED = 3,
-  ERROR_OCCT_EXCEPTION        = 4,
-  ERROR_BOOLEAN_FAILED        = 5,
-  ERROR_DELTA_FAILED          = 6,
-  ERROR_EXPORT_FAILED         = 7,
-  ERROR_IMPORT_FAILED         = 8
+namespace {
+
+// Axisymmetric part kept as its half-section in the stock's kTurnUv plane
+// (u along the stock axis, v radial, v >= 0). The solid is only revolved
+// when somebody asks for the 3D shape.
+struct TurnSection {
+  AxisDto      axis;
+  TopoDS_Shape face;
 };
 
-namespace {
+TopoDS_Shape RevolveTurnSection(const TurnSection& section);
+
+// Conservative bounds used to short-circuit booleans; cached per registry
+// entry because stocks are classified against many tools.
+struct ShapeBounds {
+  Bnd_Box aabb;
+  Bnd_OBB obb;
+};
+
+ShapeBounds ComputeShapeBounds(const TopoDS_Shape& shape);
 
+// Thread-safe: async operations add shapes while the caller keeps using the
+// kernel. Shapes are handed out by value (a handle copy), so a concurrent
+// Remove never invalidates what a running operation holds.
 class ShapeRegistry {
  public:
   int Add(const TopoDS_Shape& shape) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = ++next_id_;
+    shapes_[id].shape = shape;
+    return id;
+  }
+
+  // Shape whose bounds (and section) are already known: prepared imports,
+  // or a snapshot of another entry taken earlier.
+  int AddWithBounds(const TopoDS_Shape& shape, std::shared_ptr<const ShapeBounds> bounds,
+                    std::shared_ptr<const TurnSection> section = nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = ++next_id_;
+    Entry& entry  = shapes_[id];
+    entry.shape   = shape;
+    entry.bounds  = std::move(bounds);
+    entry.section = std::move(section);
+    return id;
+  }
+
+  int AddSection(std::shared_ptr<const TurnSection> section,
+                 const TopoDS_Shape& shape = TopoDS_Shape()) {
+    std::lock_guard<std::mutex> lock(mutex_);
     int id = ++next_id_;
-    shapes_[id] = shape;
+    Entry& entry  = shapes_[id];
+    entry.shape   = shape;
+    entry.section = std::move(section);
     return id;
   }
 
-  bool Remove(int id) { return shapes_.erase(id) > 0; }
+  bool Remove(int id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shapes_.erase(id) > 0;
+  }
+
+  // Lazily revolves section-only entries on first access. The revolve runs
+  // outside the lock.
+  bool Find(int id, TopoDS_Shape* outShape) {
+    std::shared_ptr<const TurnSection> section;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = shapes_.find(id);
+      if (it == shapes_.end()) return false;
+      if (!it->second.shape.IsNull()) {
+        *outShape = it->second.shape;
+        return true;
+      }
+      section = it->second.section;
+    }
+    if (!section) return false;
+
+    const TopoDS_Shape shape = RevolveTurnSection(*section);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = shapes_.find(id);
+    if (it != shapes_.end() && it->second.shape.IsNull()) it->second.shape = shape;
+    *outShape = (it != shapes_.end()) ? it->second.shape : shape;
+    return true;
+  }
+
+  // The shape and its bounds as one snapshot: once the shape is found the
+  // bounds are never null, even if the id is removed concurrently, because
+  // missing bounds are computed from the shape handed out.
+  bool FindWithBounds(int id, TopoDS_Shape* outShape,
+                      std::shared_ptr<const ShapeBounds>* outBounds) {
+    if (!Find(id, outShape)) return false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = shapes_.find(id);
+      if (it != shapes_.end() && it->second.bounds && it->second.shape.IsSame(*outShape)) {
+        *outBounds = it->second.bounds;
+        return true;
+      }
+    }
+
+    auto bounds = std::make_shared<const ShapeBounds>(ComputeShapeBounds(*outShape));
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = shapes_.find(id);
+    if (it != shapes_.end() && !it->second.bounds && it->second.shape.IsSame(*outShape))
+      it->second.bounds = bounds;
+    *outBounds = bounds;
+    return true;
+  }
+
+  // Mass properties of an earlier query that are at least as accurate as
+  // `tolerance` asks for (0: exact only).
+  std::shared_ptr<const MassProperties> FindMass(int id, double tolerance) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = shapes_.find(id);
+    if (it == shapes_.end() || !it->second.mass) return nullptr;
+    const double cached = it->second.mass->tolerance;
+    if (cached > 0.0 && (tolerance <= 0.0 || cached > tolerance)) return nullptr;
+    return it->second.mass;
+  }
+
+  // Keeps whichever of the cached and the new values is more accurate.
+  void StoreMass(int id, std::shared_ptr<const MassProperties> mass) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = shapes_.find(id);
+    if (it == shapes_.end()) return;
+    const std::shared_ptr<const MassProperties>& cached = it->second.mass;
+    if (!cached || (cached->tolerance > 0.0 &&
+                    (mass->tolerance <= 0.0 || mass->tolerance < cached->tolerance)))
+      it->second.mass = std::move(mass);
+  }
+
+  // Takes over every entry and the id counter of `other`. Entries hold
+  // handles, so both registries then reference the same TopoDS shapes.
+  void CopyFrom(const ShapeRegistry& other) {
+    std::scoped_lock lock(mutex_, other.mutex_);
+    shapes_  = other.shapes_;
+    next_id_ = other.next_id_;
+  }
+
+  // Drops every shape and restarts ids, as in a fresh registry.
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shapes_.clear();
+    next_id_ = 0;
+  }
 
-  const TopoDS_Shape* Find(int id) const {
+  std::shared_ptr<const TurnSection> FindSection(int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = shapes_.find(id);
     if (it == shapes_.end()) return nullptr;
-    return &it->second;
+    return it->second.section;
+  }
+
+ private:
+  struct Entry {
+    TopoDS_Shape                          shape;
+    std::shared_ptr<const TurnSection>    section;
+    std::shared_ptr<const ShapeBounds>    bounds;
+    std::shared_ptr<const MassProperties> mass;
+  };
+
+  mutable std::mutex   mutex_;
+  int                  next_id_ = 0;
+  std::map<int, Entry> shapes_;
+};
+
+// Thread-safe like ShapeRegistry. Each grid carries its own lock, held for
+// as long as a caller reads or cuts it, so concurrent calls on one preview
+// serialise and Remove never frees a grid that is still in use.
+class PreviewRegistry {
+ private:
+  struct Preview {
+    explicit Preview(std::unique_ptr<l1::ZMapGrid> g) : grid(std::move(g)) {}
+    std::mutex                     mutex;
+    std::unique_ptr<l1::ZMapGrid> grid;
+  };
+
+ public:
+  class LockedGrid {
+   public:
+    LockedGrid() = default;
+    explicit LockedGrid(std::shared_ptr<Preview> preview)
+        : preview_(std::move(preview)), lock_(preview_->mutex) {}
+
+    explicit operator bool() const { return preview_ != nullptr; }
+    l1::ZMapGrid& operator*() const { return *preview_->grid; }
+    l1::ZMapGrid* operator->() const { return preview_->grid.get(); }
+
+   private:
+    std::shared_ptr<Preview>     preview_;
+    std::unique_lock<std::mutex> lock_;
+  };
+
+  int Add(std::unique_ptr<l1::ZMapGrid> grid) {
+    auto preview = std::make_shared<Preview>(std::move(grid));
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = ++next_id_;
+    grids_[id] = std::move(preview);
+    return id;
+  }
+
+  bool Remove(int id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return grids_.erase(id) > 0;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    grids_.clear();
+    next_id_ = 0;
+  }
+
+  // Empty when `id` is unknown.
+  LockedGrid Lock(int id) const {
+    std::shared_ptr<Preview> preview;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = grids_.find(id);
+      if (it == grids_.end()) return LockedGrid();
+      preview = it->second;
+    }
+    return LockedGrid(std::move(preview));
+  }
+
+ private:
+  mutable std::mutex                         mutex_;
+  int                                        next_id_ = 0;
+  std::map<int, std::shared_ptr<Preview>>    grids_;
+};
+
+// State shared by an async worker thread, the caller and the OCCT progress
+// indicator driving that operation.
+struct AsyncOperation {
+  using Work = std::function<int(OperationResult*, const Message_ProgressRange&)>;
+  using Clock = std::chrono::steady_clock;
+
+  std::atomic<bool>     cancelRequested{false};
+  std::atomic<double>   progress{0.0};
+  bool                  hasDeadline = false;
+  Clock::time_point     deadline;
+  L1_CompletionCallback onComplete = nullptr;
+  void*                 userData   = nullptr;
+
+  std::mutex              mutex;
+  std::condition_variable doneCv;
+  bool                    done      = false;
+  int                     errorCode = ERROR_OK;
+  OperationResult         result{};
+
+  bool DeadlineExpired() const { return hasDeadline && Clock::now() >= deadline; }
+  bool ShouldStop() const { return cancelRequested.load() || DeadlineExpired(); }
+
+  void WaitDone() {
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [this] { return done; });
+  }
+};
+
+// Lets booleans, meshing and STEP transfer poll for cancellation / deadline
+// and publishes their progress to the operation.
+class OperationProgress : public Message_ProgressIndicator {
+ public:
+  explicit OperationProgress(AsyncOperation* op) : op_(op) {}
+
+ protected:
+  Standard_Boolean UserBreak() override { return op_->ShouldStop(); }
+
+  void Show(const Message_ProgressScope&, const Standard_Boolean) override {
+    op_->progress.store(GetPosition());
+  }
+
+ private:
+  AsyncOperation* op_;
+};
+
+// Operations run on a per-kernel pool of worker threads, started on demand
+// up to the hardware concurrency and kept for later operations; further
+// operations queue. A queued operation that is cancelled or past its
+// deadline when a worker picks it up finishes without running.
+class AsyncOperationTable {
+ public:
+  ~AsyncOperationTable() {
+    CancelAll();
+    {
+      std::lock_guard<std::mutex> lock(queue_->mutex);
+      queue_->stopping = true;
+    }
+    queue_->cv.notify_all();
+    for (std::thread& worker : workers_) {
+      // A completion callback may destroy the kernel on a pool thread; that
+      // thread leaves the loop on its own and keeps the queue alive.
+      if (worker.get_id() == std::this_thread::get_id()) worker.detach();
+      else worker.join();
+    }
+  }
+
+  // Cancels every operation, waits for them and forgets the handles.
+  void CancelAll() {
+    std::map<int, std::shared_ptr<AsyncOperation>> operations;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      operations.swap(operations_);
+    }
+    for (auto& entry : operations) entry.second->cancelRequested = true;
+    for (auto& entry : operations) entry.second->WaitDone();
+  }
+
+  int Start(const AsyncOptions* options, AsyncOperation::Work work) {
+    auto op = std::make_shared<AsyncOperation>();
+    if (options) {
+      op->onComplete = options->onComplete;
+      op->userData   = options->userData;
+      if (options->timeoutMs > 0.0) {
+        op->hasDeadline = true;
+        op->deadline    = AsyncOperation::Clock::now() +
+            std::chrono::duration_cast<AsyncOperation::Clock::duration>(
+                std::chrono::duration<double, std::milli>(options->timeoutMs));
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int id = ++next_id_;
+    operations_[id] = op;
+    bool needWorker = false;
+    {
+      std::lock_guard<std::mutex> queueLock(queue_->mutex);
+      queue_->tasks.push_back(Task{id, op, std::move(work)});
+      needWorker = queue_->tasks.size() > queue_->idle;
+    }
+    try {
+      if (needWorker && workers_.size() < MaxWorkers()) workers_.emplace_back(WorkerLoop, queue_);
+    } catch (...) {
+      if (workers_.empty()) {
+        // No thread to run it on: withdraw the operation.
+        std::lock_guard<std::mutex> queueLock(queue_->mutex);
+        queue_->tasks.pop_back();
+        operations_.erase(id);
+        throw;
+      }
+      // Otherwise an existing worker picks it up later.
+    }
+    queue_->cv.notify_one();
+    return id;
+  }
+
+  std::shared_ptr<AsyncOperation> Find(int id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = operations_.find(id);
+    return it == operations_.end() ? nullptr : it->second;
+  }
+
+  std::shared_ptr<AsyncOperation> Take(int id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = operations_.find(id);
+    if (it == operations_.end()) return nullptr;
+    auto op = it->second;
+    operations_.erase(it);
+    return op;
+  }
+
+ private:
+  struct Task {
+    int                             id = 0;
+    std::shared_ptr<AsyncOperation> op;
+    AsyncOperation::Work            work;
+  };
+
+  // Shared with the workers, so a detached worker never touches a
+  // destroyed table.
+  struct Queue {
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::deque<Task>        tasks;
+    std::size_t             idle     = 0;
+    bool                    stopping = false;
+  };
+
+  static std::size_t MaxWorkers() {
+    return std::max(2u, std::thread::hardware_concurrency());
+  }
+
+  static void WorkerLoop(std::shared_ptr<Queue> queue) {
+    for (;;) {
+      Task task;
+      {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        ++queue->idle;
+        queue->cv.wait(lock, [&queue] { return queue->stopping || !queue->tasks.empty(); });
+        --queue->idle;
+        if (queue->tasks.empty()) return;
+        task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+      }
+      Run(task.id, task.op, std::move(task.work));
+    }
+  }
+
+  static void Run(int id, std::shared_ptr<AsyncOperation> op, AsyncOperation::Work work) {
+    OperationResult result{};
+    int errorCode = ERROR_OCCT_EXCEPTION;
+    if (!op->ShouldStop()) {
+      Handle(OperationProgress) progress = new OperationProgress(op.get());
+      try {
+        errorCode = work(&result, progress->Start());
+      } catch (...) {
+        errorCode = ERROR_OCCT_EXCEPTION;
+      }
+    }
+
+    if (errorCode != ERROR_OK) {
+      if (op->cancelRequested.load())  errorCode = ERROR_CANCELLED;
+      else if (op->DeadlineExpired())  errorCode = ERROR_DEADLINE_EXCEEDED;
+      result.errorCode = errorCode;
+    } else {
+      op->progress.store(1.0);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(op->mutex);
+      op->result    = result;
+      op->errorCode = errorCode;
+      op->done      = true;
+    }
+    op->doneCv.notify_all();
+    if (op->onComplete) op->onComplete(id, errorCode, op->userData);
+  }
+
+  mutable std::mutex                              mutex_;
+  int                                             next_id_ = 0;
+  std::map<int, std::shared_ptr<AsyncOperation>> operations_;
+  std::vector<std::thread>                        workers_;
+  std::shared_ptr<Queue>                          queue_ = std::make_shared<Queue>();
+};
+
+// Incremental allocators for boolean temporaries. Each operation takes one,
+// allocates its whole pave filler / builder state from it and hands it back;
+// Reset keeps the blocks, so later operations reuse warm memory instead of
+// going through the global allocator object by object.
+class AllocatorPool {
+ public:
+  Handle(NCollection_IncAllocator) Acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        Handle(NCollection_IncAllocator) allocator = free_.back();
+        free_.pop_back();
+        return allocator;
+      }
+    }
+    return new NCollection_IncAllocator(kBlockSize);
+  }
+
+  // Everything allocated from `allocator` must already be destroyed.
+  void Release(const Handle(NCollection_IncAllocator)& allocator) {
+    allocator->Reset(false);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() < kMaxPooled) free_.push_back(allocator);
+  }
+
+ private:
+  static constexpr std::size_t kBlockSize = 4 * 1024 * 1024;
+  static constexpr std::size_t kMaxPooled = 8;
+
+  std::mutex                                    mutex_;
+  std::vector<Handle(NCollection_IncAllocator)> free_;
+};
+
+class PooledAllocator {
+ public:
+  explicit PooledAllocator(AllocatorPool& pool) : pool_(pool), allocator_(pool.Acquire()) {}
+  ~PooledAllocator() { pool_.Release(allocator_); }
+  PooledAllocator(const PooledAllocator&) = delete;
+  PooledAllocator& operator=(const PooledAllocator&) = delete;
+
+  const Handle(NCollection_IncAllocator)& Get() const { return allocator_; }
+
+ private:
+  AllocatorPool&                   pool_;
+  Handle(NCollection_IncAllocator) allocator_;
+};
+
+// Tools built ahead of the boolean that consumes them (pipelined jobs), on
+// one prefetch thread per kernel that is started on first use. Keys cover
+// every input byte of the build, so a hit is exactly the shape the
+// consuming call would have built itself.
+class ToolCache {
+ public:
+  struct Build {
+    TopoDS_Shape tool;
+    int          errorCode = ERROR_OK;
+  };
+  using Builder = std::function<Build()>;
+
+  ToolCache() = default;
+  ToolCache(const ToolCache&) = delete;
+  ToolCache& operator=(const ToolCache&) = delete;
+
+  ~ToolCache() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+  }
+
+  // Ignored when the key is already pending or too many builds are waiting
+  // to be consumed; the call then builds inline as usual.
+  void Prefetch(const std::string& key, Builder builder) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_ || pending_.size() >= kMaxPending || pending_.count(key)) return;
+    if (!thread_.joinable()) {
+      try {
+        thread_ = std::thread([this] { WorkerLoop(); });
+      } catch (const std::system_error&) {
+        return;
+      }
+    }
+    auto slot     = std::make_shared<Slot>();
+    slot->builder = std::move(builder);
+    slot->future  = slot->promise.get_future();
+    pending_.emplace(key, slot);
+    queue_.push_back(std::move(slot));
+    cv_.notify_all();
+  }
+
+  // The prefetched build of `key` (waiting for it if it is running),
+  // otherwise `builder` run on the calling thread. A prefetch that has not
+  // started yet is dropped in favour of the inline build.
+  Build Take(const std::string& key, const Builder& builder) {
+    std::shared_ptr<Slot> slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = pending_.find(key);
+      if (it != pending_.end()) {
+        slot = std::move(it->second);
+        pending_.erase(it);
+        if (!slot->claimed) {
+          slot->claimed = true;
+          slot.reset();
+        }
+      }
+    }
+    return slot ? slot->future.get() : builder();
+  }
+
+  // Drops a build the call turned out not to need. Does not wait: a build
+  // that is already running finishes on the prefetch thread and is thrown
+  // away.
+  void Discard(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(key);
+    if (it == pending_.end()) return;
+    it->second->claimed = true;
+    pending_.erase(it);
+  }
+
+  // Forgets every pending build and waits for the one that is running.
+  void Clear() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& entry : pending_) entry.second->claimed = true;
+    pending_.clear();
+    queue_.clear();
+    cv_.wait(lock, [this] { return !busy_; });
   }
 
  private:
-  int next_id_ = 0;
-  std::map<int, TopoDS_Shape> shapes_;
+  struct Slot {
+    Builder             builder;
+    std::promise<Build> promise;
+    std::future<Build>  future;
+    bool                claimed = false;  // started, taken or dropped
+  };
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) return;
+      std::shared_ptr<Slot> slot = std::move(queue_.front());
+      queue_.pop_front();
+      if (slot->claimed) continue;
+      slot->claimed = true;
+      busy_ = true;
+      lock.unlock();
+      try {
+        slot->promise.set_value(slot->builder());
+      } catch (...) {
+        slot->promise.set_exception(std::current_exception());
+      }
+      lock.lock();
+      busy_ = false;
+      cv_.notify_all();
+    }
+  }
+
+  static constexpr std::size_t kMaxPending = 8;
+
+  std::mutex                                   mutex_;
+  std::condition_variable                      cv_;
+  std::map<std::string, std::shared_ptr<Slot>> pending_;
+  std::deque<std::shared_ptr<Slot>>            queue_;
+  bool                                         busy_     = false;
+  bool                                         stopping_ = false;
+  std::thread                                  thread_;
 };
 
+using l1::CopyStructFields;
+using l1::IsValidStructSize;
+
+KernelOptions DefaultKernelOptions() {
+  KernelOptions options{};
+  options.structSize = sizeof(KernelOptions);
+  options.glueMode   = BOOLEAN_GLUE_OFF;
+  return options;
+}
+
 class OcctKernelImpl {
  public:
-  ShapeRegistry& Registry() { return registry_; }
+  ShapeRegistry&       Registry()   { return registry_; }
+  PreviewRegistry&     Previews()   { return previews_; }
+  AsyncOperationTable& Operations() { return operations_; }
+  AllocatorPool&       Allocators() { return allocators_; }
+  ToolCache&           Tools()      { return tools_; }
+
+  // Snapshot taken by each operation when it starts.
+  KernelOptions Options() const {
+    std::lock_guard<std::mutex> lock(optionsMutex_);
+    return options_;
+  }
+
+  void SetOptions(const KernelOptions& options) {
+    std::lock_guard<std::mutex> lock(optionsMutex_);
+    options_ = options;
+  }
+
+  // Back to the state of a fresh kernel, keeping options and pooled
+  // allocator memory.
+  void Reset() {
+    operations_.CancelAll();
+    tools_.Clear();
+    previews_.Clear();
+    registry_.Clear();
+  }
+
+  // New kernel with this kernel's options and shapes under the same ids.
+  // Shapes are immutable once registered, so the fork holds handles to
+  // them rather than copies; previews and async operations stay here.
+  std::unique_ptr<OcctKernelImpl> Fork() {
+    auto fork = std::make_unique<OcctKernelImpl>();
+    fork->SetOptions(Options());
+    fork->registry_.CopyFrom(registry_);
+    return fork;
+  }
 
  private:
-  ShapeRegistry registry_;
+  mutable std::mutex  optionsMutex_;
+  KernelOptions       options_ = DefaultKernelOptions();
+  AllocatorPool       allocators_;
+  ShapeRegistry       registry_;
+  PreviewRegistry     previews_;
+  ToolCache           tools_;
+  // Declared last: its destructor joins workers that still use the registry.
+  AsyncOperationTable operations_;
 };
 
+// OCCT's STEP translators share static session parameters, so concurrent
+// reader / writer sessions (async exports, parallel kernels) are serialised.
+std::mutex gStepSessionMutex;
+
 int MapExceptionToError() { return ERROR_OCCT_EXCEPTION; }
 
 constexpr double kGeomTol = 1.0e-7;
@@ -92,7 +797,20 @@ enum class PathFrameMode { kTurnUv, kPlanarUv };
 // ---------------------------------------------------------------------------
 
 const char* kDebugPath2dDirEnv      = "L1_DEBUG_PATH2D_DIR";
-int         gDebugPath2dDumpCounter = 0;
+std::atomic<int> gDebugPath2dDumpCounter{0};
+
+// Read once; the setting is process-wide and every profile build asks.
+const std::filesystem::path& DebugPath2dDir() {
+  static const std::filesystem::path dir = []() -> std::filesystem::path {
+    const char* rawDir = std::getenv(kDebugPath2dDirEnv);
+    if (!rawDir || *rawDir == '\0') return {};
+    try {
+      std::filesystem::create_directories(rawDir);
+    } catch (...) {}
+    return rawDir;
+  }();
+  return dir;
+}
 
 const char* PathFrameModeName(PathFrameMode mode) {
   return mode == PathFrameMode::kTurnUv ? "turn_uv" : "planar_uv";
@@ -100,13 +818,10 @@ const char* PathFrameModeName(PathFrameMode mode) {
 
 void DumpPath2dSegmentsForDebug(const Path2DSegmentDto* segments, int segmentCount,
                                 PathFrameMode mode) {
-  const char* rawDir = std::getenv(kDebugPath2dDirEnv);
-  if (!rawDir || *rawDir == '\0') return;
+  const std::filesystem::path& outDir = DebugPath2dDir();
+  if (outDir.empty()) return;
 
   try {
-    std::filesystem::path outDir(rawDir);
-    std::filesystem::create_directories(outDir);
-
     const int dumpIndex = ++gDebugPath2dDumpCounter;
     const std::string fileName =
         std::string("path2d_") + PathFrameModeName(mode) + "_" +
@@ -140,6 +855,17 @@ bool NearlyEqual(const UvPoint& a, const UvPoint& b) {
   return Distance2D(a, b) <= kGeomTol;
 }
 
+// Start angle and signed sweep (positive CCW) of an arc in its (u,v) frame.
+void ComputeArcSweep(const Path2DSegmentDto& seg, double* outStart, double* outSweep) {
+  const double a0 = std::atan2(seg.from.v - seg.center.v, seg.from.u - seg.center.u);
+  const double a1 = std::atan2(seg.to.v   - seg.center.v, seg.to.u   - seg.center.u);
+  double sweep = std::fmod(a1 - a0, kFullRevolutionRadians);
+  if (sweep < 0.0) sweep += kFullRevolutionRadians;
+  if (seg.arcDirection == ARC_DIR_CW) sweep -= kFullRevolutionRadians;
+  *outStart = a0;
+  *outSweep = sweep;
+}
+
 gp_Pnt To3DPoint(const UvPoint& uv, const AxisDto& axis, PathFrameMode mode) {
   gp_Pnt origin(axis.origin[0], axis.origin[1], axis.origin[2]);
   gp_Vec offset;
@@ -354,6 +1080,272 @@ bool BuildFaceFromSegments(const Path2DSegmentDto* segments, int segmentCount,
   return true;
 }
 
+// ---------------------------------------------------------------------------
+// Slot outline
+// ---------------------------------------------------------------------------
+
+// Piece of an offset curve: a line from `from` to `to`, or an arc about
+// `center` starting at angle `a0` with signed `sweep`. Only the parameter
+// range [t0, t1] is kept, so trimming never rebuilds the curve.
+struct OffsetPiece {
+  bool    arc = false;
+  UvPoint from{}, to{};
+  UvPoint center{};
+  double  radius = 0.0, a0 = 0.0, sweep = 0.0;
+  double  t0 = 0.0, t1 = 1.0;
+};
+
+// Below this sine two tangents count as parallel.
+constexpr double kTangentTol = 1.0e-9;
+
+UvPoint PieceAt(const OffsetPiece& p, double t) {
+  if (!p.arc) return {p.from.u + (p.to.u - p.from.u) * t, p.from.v + (p.to.v - p.from.v) * t};
+  const double a = p.a0 + p.sweep * t;
+  return {p.center.u + p.radius * std::cos(a), p.center.v + p.radius * std::sin(a)};
+}
+
+// Parameter of a point known to lie on the piece's full line / circle.
+double PieceParam(const OffsetPiece& p, const UvPoint& q) {
+  if (!p.arc) {
+    const double du = p.to.u - p.from.u, dv = p.to.v - p.from.v;
+    return ((q.u - p.from.u) * du + (q.v - p.from.v) * dv) / (du * du + dv * dv);
+  }
+  const double a = std::atan2(q.v - p.center.v, q.u - p.center.u);
+  double d = std::fmod(p.sweep > 0.0 ? a - p.a0 : p.a0 - a, kFullRevolutionRadians);
+  if (d < 0.0) d += kFullRevolutionRadians;
+  // Just before the start wraps to a full turn; keep it near zero instead.
+  if (d > 0.5 * (kFullRevolutionRadians + std::fabs(p.sweep))) d -= kFullRevolutionRadians;
+  return d / std::fabs(p.sweep);
+}
+
+OffsetPiece LinePiece(const UvPoint& from, const UvPoint& to) {
+  OffsetPiece p;
+  p.from = from;
+  p.to   = to;
+  return p;
+}
+
+OffsetPiece ArcPiece(const UvPoint& center, double radius, double a0, double sweep) {
+  OffsetPiece p;
+  p.arc    = true;
+  p.center = center;
+  p.radius = radius;
+  p.a0     = a0;
+  p.sweep  = sweep;
+  return p;
+}
+
+// Arc about `center` from `from` to `to`, turning the short way in `ccw`.
+OffsetPiece JoinArc(const UvPoint& center, double radius, const UvPoint& from,
+                    const UvPoint& to, bool ccw) {
+  const double a0 = std::atan2(from.v - center.v, from.u - center.u);
+  const double a1 = std::atan2(to.v - center.v, to.u - center.u);
+  double sweep = std::fmod(a1 - a0, kFullRevolutionRadians);
+  if (ccw && sweep < 0.0) sweep += kFullRevolutionRadians;
+  if (!ccw && sweep > 0.0) sweep -= kFullRevolutionRadians;
+  return ArcPiece(center, radius, a0, sweep);
+}
+
+OffsetPiece Reversed(OffsetPiece p) {
+  if (p.arc) {
+    p.a0   += p.sweep;
+    p.sweep = -p.sweep;
+  } else {
+    std::swap(p.from, p.to);
+  }
+  const double t0 = p.t0;
+  p.t0 = 1.0 - p.t1;
+  p.t1 = 1.0 - t0;
+  return p;
+}
+
+// Unit tangent of a validated path segment at its start (t = 0) or end (t = 1).
+UvPoint SegmentTangent(const Path2DSegmentDto& seg, double t) {
+  if (seg.type == PATH_SEGMENT_LINE) {
+    const UvPoint from{seg.from.u, seg.from.v}, to{seg.to.u, seg.to.v};
+    const double length = Distance2D(from, to);
+    return {(to.u - from.u) / length, (to.v - from.v) / length};
+  }
+  double a0 = 0.0, sweep = 0.0;
+  ComputeArcSweep(seg, &a0, &sweep);
+  const double a = a0 + sweep * t, s = sweep > 0.0 ? 1.0 : -1.0;
+  return {-std::sin(a) * s, std::cos(a) * s};
+}
+
+// Offset of one segment to its left (side = +1) or right (side = -1).
+// Fails when an arc offset towards its centre collapses.
+bool OffsetSegment(const Path2DSegmentDto& seg, double offset, int side, OffsetPiece* out) {
+  const UvPoint from{seg.from.u, seg.from.v}, to{seg.to.u, seg.to.v};
+  if (seg.type == PATH_SEGMENT_LINE) {
+    const UvPoint t = SegmentTangent(seg, 0.0);
+    const UvPoint n{-t.v * side * offset, t.u * side * offset};
+    *out = LinePiece({from.u + n.u, from.v + n.v}, {to.u + n.u, to.v + n.v});
+    return true;
+  }
+  double a0 = 0.0, sweep = 0.0;
+  ComputeArcSweep(seg, &a0, &sweep);
+  const UvPoint center{seg.center.u, seg.center.v};
+  // The centre is on the left of a CCW arc and on the right of a CW one.
+  const double radius = Distance2D(from, center) - (sweep > 0.0 ? side : -side) * offset;
+  if (radius <= kGeomTol) return false;
+  *out = ArcPiece(center, radius, a0, sweep);
+  return true;
+}
+
+// Intersections of the full lines / circles carrying two pieces.
+std::vector<UvPoint> IntersectCarriers(const OffsetPiece& a, const OffsetPiece& b) {
+  std::vector<UvPoint> points;
+  if (!a.arc && !b.arc) {
+    const double du1 = a.to.u - a.from.u, dv1 = a.to.v - a.from.v;
+    const double du2 = b.to.u - b.from.u, dv2 = b.to.v - b.from.v;
+    const double det = du1 * dv2 - dv1 * du2;
+    if (std::fabs(det) <= kTangentTol * std::hypot(du1, dv1) * std::hypot(du2, dv2))
+      return points;
+    const double s = ((b.from.u - a.from.u) * dv2 - (b.from.v - a.from.v) * du2) / det;
+    points.push_back({a.from.u + du1 * s, a.from.v + dv1 * s});
+  } else if (a.arc != b.arc) {
+    const OffsetPiece& line = a.arc ? b : a;
+    const OffsetPiece& arc  = a.arc ? a : b;
+    const double du = line.to.u - line.from.u, dv = line.to.v - line.from.v;
+    const double fu = line.from.u - arc.center.u, fv = line.from.v - arc.center.v;
+    const double qa = du * du + dv * dv, qb = 2.0 * (fu * du + fv * dv);
+    const double qc = fu * fu + fv * fv - arc.radius * arc.radius;
+    const double disc = qb * qb - 4.0 * qa * qc;
+    if (disc < 0.0) return points;
+    for (const double sign : {-1.0, 1.0}) {
+      const double s = (-qb + sign * std::sqrt(disc)) / (2.0 * qa);
+      points.push_back({line.from.u + du * s, line.from.v + dv * s});
+    }
+  } else {
+    const double du = b.center.u - a.center.u, dv = b.center.v - a.center.v;
+    const double d = std::hypot(du, dv);
+    if (d <= kGeomTol || d > a.radius + b.radius || d < std::fabs(a.radius - b.radius))
+      return points;
+    const double along = (a.radius * a.radius - b.radius * b.radius + d * d) / (2.0 * d);
+    const double h = std::sqrt(std::max(0.0, a.radius * a.radius - along * along));
+    const UvPoint m{a.center.u + du * along / d, a.center.v + dv * along / d};
+    points.push_back({m.u - dv * h / d, m.v + du * h / d});
+    points.push_back({m.u + dv * h / d, m.v - du * h / d});
+  }
+  return points;
+}
+
+// Cuts the inner side of a corner at `corner`: `a` is shortened to end and
+// `b` to start at the intersection nearest the corner. Fails when the
+// offsets do not meet inside both pieces (the tool cannot follow the corner
+// locally).
+bool TrimInnerCorner(OffsetPiece* a, OffsetPiece* b, const UvPoint& corner) {
+  constexpr double kParamTol = 1.0e-9;
+  bool   found = false;
+  double bestDistance = 0.0, ta = 0.0, tb = 0.0;
+  for (const UvPoint& q : IntersectCarriers(*a, *b)) {
+    const double qa = PieceParam(*a, q), qb = PieceParam(*b, q);
+    if (qa < a->t0 - kParamTol || qa > 1.0 + kParamTol ||
+        qb < -kParamTol || qb > b->t1 + kParamTol)
+      continue;
+    const double distance = Distance2D(q, corner);
+    if (!found || distance < bestDistance) {
+      found = true;
+      bestDistance = distance;
+      ta = std::min(qa, 1.0);
+      tb = std::max(qb, 0.0);
+    }
+  }
+  if (!found || ta <= a->t0 + kParamTol || tb >= b->t1 - kParamTol) return false;
+  a->t1 = ta;
+  b->t0 = tb;
+  return true;
+}
+
+void AppendPiece(const OffsetPiece& p, std::vector<Path2DSegmentDto>* out) {
+  UvPoint from = PieceAt(p, p.t0);
+  if (!out->empty()) from = {out->back().to.u, out->back().to.v};
+  const UvPoint to = PieceAt(p, p.t1);
+  if (Distance2D(from, to) <= 10.0 * kGeomTol) return;
+
+  Path2DSegmentDto seg{};
+  seg.type   = p.arc ? PATH_SEGMENT_ARC : PATH_SEGMENT_LINE;
+  seg.from.u = from.u;
+  seg.from.v = from.v;
+  seg.to.u   = to.u;
+  seg.to.v   = to.v;
+  if (p.arc) {
+    seg.center.u     = p.center.u;
+    seg.center.v     = p.center.v;
+    seg.arcDirection = p.sweep > 0.0 ? ARC_DIR_CCW : ARC_DIR_CW;
+  }
+  out->push_back(seg);
+}
+
+// Closed line/arc outline of the region an end mill of `toolRadius` sweeps
+// along an open, validated path: both side offsets, round joins on the
+// outside of every corner, the inside trimmed to the offsets' intersection,
+// and half-circle caps at both ends. Counter-clockwise. Fails (and the
+// caller unions per-segment regions instead) on a reversal, a corner whose
+// inner offsets miss each other, or an arc tighter than the tool; overlaps
+// between distant parts of the path are left to the caller's face check.
+bool BuildSlotOutline(const Path2DSegmentDto* segments, int segmentCount, double toolRadius,
+                      std::vector<Path2DSegmentDto>* outOutline) {
+  std::vector<OffsetPiece> right(segmentCount), left(segmentCount);
+  for (int i = 0; i < segmentCount; ++i)
+    if (!OffsetSegment(segments[i], toolRadius, -1, &right[i]) ||
+        !OffsetSegment(segments[i], toolRadius, +1, &left[i]))
+      return false;
+
+  // joins[i]: round join after segment i on the outer side, if any.
+  std::vector<OffsetPiece> joins(segmentCount);
+  std::vector<int>         joinSide(segmentCount, 0);
+  for (int i = 0; i + 1 < segmentCount; ++i) {
+    const UvPoint corner{segments[i].to.u, segments[i].to.v};
+    const UvPoint tin  = SegmentTangent(segments[i], 1.0);
+    const UvPoint tout = SegmentTangent(segments[i + 1], 0.0);
+    const double cross = tin.u * tout.v - tin.v * tout.u;
+    const double dot   = tin.u * tout.u + tin.v * tout.v;
+    if (std::fabs(cross) <= kTangentTol) {
+      if (dot < 0.0) return false;
+      continue;
+    }
+    const int outer = cross > 0.0 ? -1 : +1;  // a left turn opens the right side
+    const UvPoint nin {-tin.v  * outer * toolRadius, tin.u  * outer * toolRadius};
+    const UvPoint nout{-tout.v * outer * toolRadius, tout.u * outer * toolRadius};
+    joins[i]    = JoinArc(corner, toolRadius, {corner.u + nin.u, corner.v + nin.v},
+                          {corner.u + nout.u, corner.v + nout.v}, cross > 0.0);
+    joinSide[i] = outer;
+    std::vector<OffsetPiece>& inner = outer < 0 ? left : right;
+    if (!TrimInnerCorner(&inner[i], &inner[i + 1], corner)) return false;
+  }
+
+  const UvPoint start{segments[0].from.u, segments[0].from.v};
+  const UvPoint end  {segments[segmentCount - 1].to.u, segments[segmentCount - 1].to.v};
+  const OffsetPiece endCap   = JoinArc(end, toolRadius, PieceAt(right.back(), 1.0),
+                                       PieceAt(left.back(), 1.0), true);
+  const OffsetPiece startCap = JoinArc(start, toolRadius, PieceAt(left.front(), 0.0),
+                                       PieceAt(right.front(), 0.0), true);
+  // Half circles: JoinArc cannot tell which way round, so force the sweep.
+  auto halfTurn = [](OffsetPiece cap) {
+    cap.sweep = kFullRevolutionRadians / 2.0;
+    return cap;
+  };
+
+  std::vector<Path2DSegmentDto> outline;
+  for (int i = 0; i < segmentCount; ++i) {
+    AppendPiece(right[i], &outline);
+    if (joinSide[i] < 0) AppendPiece(joins[i], &outline);
+  }
+  AppendPiece(halfTurn(endCap), &outline);
+  for (int i = segmentCount - 1; i >= 0; --i) {
+    if (i + 1 < segmentCount && joinSide[i] > 0) AppendPiece(Reversed(joins[i]), &outline);
+    AppendPiece(Reversed(left[i]), &outline);
+  }
+  AppendPiece(halfTurn(startCap), &outline);
+  if (outline.size() < 2) return false;
+
+  // Close exactly: the last piece ends where the first began.
+  outline.back().to = outline.front().from;
+  *outOutline = std::move(outline);
+  return true;
+}
+
 // ---------------------------------------------------------------------------
 // Tool builders
 // ---------------------------------------------------------------------------
@@ -379,6 +1371,21 @@ bool BuildTurnTool(const Path2DSegmentDto* segments, int segmentCount, int close
   return true;
 }
 
+// Prism of a planar profile along axis.dir.
+bool ExtrudeAlongAxis(const TopoDS_Shape& profile, double depth, const AxisDto& axis,
+                      TopoDS_Shape* outTool, int* outErrorCode) {
+  gp_Dir dir(axis.dir[0], axis.dir[1], axis.dir[2]);
+  BRepPrimAPI_MakePrism prism(profile, gp_Vec(dir) * depth, true, true);
+  if (!prism.IsDone()) {
+    *outErrorCode = ERROR_BOOLEAN_FAILED;
+    return false;
+  }
+
+  *outTool      = prism.Shape();
+  *outErrorCode = ERROR_OK;
+  return true;
+}
+
 bool BuildMillContourTool(const Path2DSegmentDto* segments, int segmentCount, int closed,
                           double depth, const AxisDto& axis,
                           TopoDS_Shape* outTool, int* outErrorCode) {
@@ -391,288 +1398,3443 @@ bool BuildMillContourTool(const Path2DSegmentDto* segments, int segmentCount, in
   if (!BuildFaceFromSegments(segments, segmentCount, closed, axis,
                              PathFrameMode::kPlanarUv, &face, outErrorCode))
     return false;
+  return ExtrudeAlongAxis(face, depth, axis, outTool, outErrorCode);
+}
 
-  gp_Dir dir(axis.dir[0], axis.dir[1], axis.dir[2]);
-  BRepPrimAPI_MakePrism prism(face, gp_Vec(dir) * depth, true, true);
-  if (!prism.IsDone()) {
+// Region one segment sweeps between its end discs: a band between the two
+// side offsets, or a pie when the arc is tighter than the tool.
+bool BuildSegmentBandFace(const Path2DSegmentDto& seg, double toolRadius, const AxisDto& axis,
+                          TopoDS_Face* outFace, int* outErrorCode) {
+  OffsetPiece right, left;
+  const bool hasRight = OffsetSegment(seg, toolRadius, -1, &right);
+  const bool hasLeft  = OffsetSegment(seg, toolRadius, +1, &left);
+  const UvPoint center{seg.center.u, seg.center.v};
+
+  std::vector<Path2DSegmentDto> band;
+  auto lineTo = [&band](const UvPoint& to) {
+    AppendPiece(LinePiece({band.back().to.u, band.back().to.v}, to), &band);
+  };
+  if (hasRight && hasLeft) {
+    AppendPiece(right, &band);
+    lineTo(PieceAt(left, 1.0));
+    AppendPiece(Reversed(left), &band);
+  } else {
+    AppendPiece(hasRight ? right : Reversed(left), &band);
+    lineTo(center);
+  }
+  lineTo({band.front().from.u, band.front().from.v});
+  return BuildFaceFromSegments(band.data(), static_cast<int>(band.size()), 1, axis,
+                               PathFrameMode::kPlanarUv, outFace, outErrorCode);
+}
+
+bool BuildDiscFace(const UvPoint& center, double radius, const AxisDto& axis,
+                   TopoDS_Face* outFace, int* outErrorCode) {
+  std::vector<Path2DSegmentDto> disc;
+  const double half = kFullRevolutionRadians / 2.0;
+  AppendPiece(ArcPiece(center, radius, 0.0, half), &disc);
+  AppendPiece(ArcPiece(center, radius, half, half), &disc);
+  disc.back().to = disc.front().from;
+  return BuildFaceFromSegments(disc.data(), static_cast<int>(disc.size()), 1, axis,
+                               PathFrameMode::kPlanarUv, outFace, outErrorCode);
+}
+
+// Slower but general slot region: the union of every segment band and a
+// disc at every path vertex, fused in the sketch plane.
+bool BuildSlotRegionByUnion(const Path2DSegmentDto* segments, int segmentCount,
+                            double toolRadius, const AxisDto& axis,
+                            TopoDS_Shape* outRegion, int* outErrorCode) {
+  TopTools_ListOfShape pieces;
+  for (int i = 0; i <= segmentCount; ++i) {
+    TopoDS_Face face;
+    const UvPoint vertex = i < segmentCount
+        ? UvPoint{segments[i].from.u, segments[i].from.v}
+        : UvPoint{segments[i - 1].to.u, segments[i - 1].to.v};
+    if (!BuildDiscFace(vertex, toolRadius, axis, &face, outErrorCode)) return false;
+    pieces.Append(face);
+    if (i == segmentCount) break;
+    if (!BuildSegmentBandFace(segments[i], toolRadius, axis, &face, outErrorCode)) return false;
+    pieces.Append(face);
+  }
+
+  TopTools_ListOfShape arguments;
+  arguments.Append(pieces.First());
+  pieces.RemoveFirst();
+  BRepAlgoAPI_Fuse fuse;
+  fuse.SetArguments(arguments);
+  fuse.SetTools(pieces);
+  fuse.SetRunParallel(Standard_True);
+  fuse.Build();
+  if (!fuse.IsDone() || fuse.HasErrors()) {
     *outErrorCode = ERROR_BOOLEAN_FAILED;
     return false;
   }
 
-  *outTool      = prism.Shape();
+  ShapeUpgrade_UnifySameDomain unify(fuse.Shape(), Standard_True, Standard_True, Standard_False);
+  unify.Build();
+  *outRegion    = unify.Shape();
   *outErrorCode = ERROR_OK;
   return true;
 }
 
+// Slot along an open path: the swept region is built in 2D and extruded
+// once, so the cost follows the path's segment count. The exact offset
+// outline is used whenever it forms a valid face; otherwise the region is
+// the union of per-segment pieces.
+bool BuildMillSlotTool(const Path2DSegmentDto* segments, int segmentCount, double toolRadius,
+                       double depth, const AxisDto& axis,
+                       TopoDS_Shape* outTool, int* outErrorCode) {
+  if (depth <= 0.0 || toolRadius <= kGeomTol) {
+    *outErrorCode = ERROR_INVALID_ARGUMENT;
+    return false;
+  }
+  if (!ValidateSegments(segments, segmentCount, 0, axis, PathFrameMode::kPlanarUv, outErrorCode))
+    return false;
+
+  std::vector<Path2DSegmentDto> outline;
+  TopoDS_Face face;
+  int outlineError = ERROR_OK;
+  if (BuildSlotOutline(segments, segmentCount, toolRadius, &outline) &&
+      BuildFaceFromSegments(outline.data(), static_cast<int>(outline.size()), 1, axis,
+                            PathFrameMode::kPlanarUv, &face, &outlineError) &&
+      BRepCheck_Analyzer(face).IsValid())
+    return ExtrudeAlongAxis(face, depth, axis, outTool, outErrorCode);
+
+  TopoDS_Shape region;
+  if (!BuildSlotRegionByUnion(segments, segmentCount, toolRadius, axis, &region, outErrorCode))
+    return false;
+  return ExtrudeAlongAxis(region, depth, axis, outTool, outErrorCode);
+}
+
+// Path-based tools, the ones worth building ahead of their boolean. Hole
+// and pocket tools are single primitives and always built inline.
+enum class PathTool : char { kTurn = 'T', kMillContour = 'C', kMillSlot = 'S' };
+
+struct PathToolInput {
+  PathTool                kind;
+  AxisDto                 axis;
+  const Path2DSegmentDto* segments;
+  int                     segmentCount;
+  int                     closed;
+  double                  depth;
+  double                  toolRadius;
+};
+
+std::string PathToolKey(const PathToolInput& in) {
+  std::string key(1, static_cast<char>(in.kind));
+  auto append = [&key](const void* data, std::size_t size) {
+    key.append(static_cast<const char*>(data), size);
+  };
+  append(&in.axis, sizeof(AxisDto));
+  append(&in.closed, sizeof(in.closed));
+  append(&in.depth, sizeof(in.depth));
+  append(&in.toolRadius, sizeof(in.toolRadius));
+  if (in.segments && in.segmentCount > 0)
+    append(in.segments, sizeof(Path2DSegmentDto) * static_cast<std::size_t>(in.segmentCount));
+  return key;
+}
+
+ToolCache::Build BuildPathTool(const PathToolInput& in) {
+  ToolCache::Build build;
+  switch (in.kind) {
+    case PathTool::kTurn:
+      BuildTurnTool(in.segments, in.segmentCount, in.closed, in.axis,
+                    &build.tool, &build.errorCode);
+      break;
+    case PathTool::kMillContour:
+      BuildMillContourTool(in.segments, in.segmentCount, in.closed, in.depth, in.axis,
+                           &build.tool, &build.errorCode);
+      break;
+    case PathTool::kMillSlot:
+      BuildMillSlotTool(in.segments, in.segmentCount, in.toolRadius, in.depth, in.axis,
+                        &build.tool, &build.errorCode);
+      break;
+  }
+  return build;
+}
+
+// The tool a prefetch already built for these inputs, or a fresh build.
+ToolCache::Build TakePathTool(OcctKernelImpl* impl, const PathToolInput& in) {
+  return impl->Tools().Take(PathToolKey(in), [&in] { return BuildPathTool(in); });
+}
+
+TopoDS_Compound MakeEmptyCompound() {
+  BRep_Builder builder;
+  TopoDS_Compound empty;
+  builder.MakeCompound(empty);
+  return empty;
+}
+
+void ResetOperationResult(OperationResult* result) {
+  result->resultShapeId = result->deltaShapeId = result->removalShapeId = 0;
+  result->errorCode   = ERROR_INVALID_ARGUMENT;
+  result->booleanPath = BOOLEAN_PATH_FULL;
+  result->faceCountBefore = result->faceCountAfter = 0;
+}
+
+// Full-size result the operations fill; callers get their structSize worth.
+OperationResult NewOperationResult() {
+  OperationResult result{};
+  result.structSize = sizeof(OperationResult);
+  ResetOperationResult(&result);
+  return result;
+}
+
+// ---------------------------------------------------------------------------
+// Pooled boolean
+// ---------------------------------------------------------------------------
+
+int CountFaces(const TopoDS_Shape& shape) {
+  TopTools_IndexedMapOfShape faces;
+  TopExp::MapShapes(shape, TopAbs_FACE, faces);
+  return faces.Extent();
+}
+
+// Cut (and optionally Common) of one object/tool pair. Both share a single
+// pave filler, so the intersection is computed once, and all of its state is
+// allocated from a pooled incremental allocator released in one go. With
+// `glue` the filler skips face/face intersection and only matches coinciding
+// faces, which is only correct when nothing else touches. With
+// `outUnmergedFaces` the cut is compacted by the builder itself
+// (SimplifyResult), so the unifier's history becomes part of the boolean's,
+// and the face count before compaction is returned.
+int RunPooledBoolean(OcctKernelImpl* impl, const TopoDS_Shape& object, const TopoDS_Shape& tool,
+                     bool withCommon, bool glue, TopoDS_Shape* outCut, TopoDS_Shape* outCommon,
+                     const Message_ProgressRange& range, int* outUnmergedFaces = nullptr) {
+  // Declared first so the filler and builders are destroyed before the
+  // allocator goes back to the pool.
+  PooledAllocator allocator(impl->Allocators());
+
+  Message_ProgressScope scope(range, "Boolean", withCommon ? 3 : 2);
+  BOPAlgo_PaveFiller filler(allocator.Get());
+  TopTools_ListOfShape arguments;
+  arguments.Append(object);
+  arguments.Append(tool);
+  filler.SetArguments(arguments);
+  // Registry shapes are shared between concurrent operations; never let the
+  // intersection touch their tolerances.
+  filler.SetNonDestructive(Standard_True);
+  if (glue) filler.SetGlue(BOPAlgo_GlueShift);
+  filler.Perform(scope.Next());
+  if (filler.HasErrors()) return ERROR_BOOLEAN_FAILED;
+  // A glue filler that had to give up on a pair (failed or skipped
+  // intersection, unsplittable edge) may have missed a contact; let the
+  // caller redo it without glue.
+  if (glue && filler.HasWarnings()) return ERROR_BOOLEAN_FAILED;
+
+  {
+    BRepAlgoAPI_Cut cut(object, tool, filler, Standard_True, scope.Next());
+    if (!cut.IsDone()) return ERROR_BOOLEAN_FAILED;
+    if (outUnmergedFaces) {
+      *outUnmergedFaces = CountFaces(cut.Shape());
+      cut.SimplifyResult(Standard_True, Standard_True);
+    }
+    *outCut = cut.Shape();
+  }
+
+  if (withCommon) {
+    BRepAlgoAPI_Common common(object, tool, filler, scope.Next());
+    if (!common.IsDone()) return ERROR_DELTA_FAILED;
+    *outCommon = common.Shape();
+  }
+  return ERROR_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Topology compaction
+// ---------------------------------------------------------------------------
+
+// Every cut splits the faces it touches (e.g. the top face around each flush
+// hole), and the fragments are carried into every later boolean and mesh.
+// Merging faces on the same surface and edges on the same curve keeps the
+// face count of a long feature chain near that of the finished part. Faces
+// the unifier does not merge are kept as they are. Boolean results are
+// compacted inside RunPooledBoolean so the history stays intact; this is for
+// shapes without one, such as imports.
+TopoDS_Shape CompactTopology(const TopoDS_Shape& shape) {
+  ShapeUpgrade_UnifySameDomain unify(shape, Standard_True, Standard_True, Standard_False);
+  unify.AllowInternalEdges(Standard_False);
+  unify.Build();
+  const TopoDS_Shape& compacted = unify.Shape();
+  return compacted.IsNull() ? shape : compacted;
+}
+
+// ---------------------------------------------------------------------------
+// Lathe half-section fast path
+// ---------------------------------------------------------------------------
+
+constexpr double kAxisAngularTol = 1.0e-9;
+constexpr double kAxisLinearTol  = 1.0e-6;
+
+TopoDS_Shape RevolveTurnSection(const TurnSection& section) {
+  if (!TopExp_Explorer(section.face, TopAbs_FACE).More()) return MakeEmptyCompound();
+
+  gp_Pnt origin(section.axis.origin[0], section.axis.origin[1], section.axis.origin[2]);
+  gp_Dir dir   (section.axis.dir[0],    section.axis.dir[1],    section.axis.dir[2]);
+  BRepPrimAPI_MakeRevol revol(section.face, gp_Ax1(origin, dir), kFullRevolutionRadians, true);
+  if (!revol.IsDone())
+    throw std::runtime_error("Failed to revolve turn section");
+  return revol.Shape();
+}
+
+std::shared_ptr<const TurnSection> MakeStockTurnSection(const gp_Ax2& axis,
+                                                        double radius, double height) {
+  auto section = std::make_shared<TurnSection>();
+  const gp_Pnt& origin = axis.Location();
+  const gp_Dir& dir    = axis.Direction();
+  const gp_Dir& xdir   = axis.XDirection();
+  for (int i = 0; i < 3; ++i) {
+    section->axis.origin[i] = origin.Coord(i + 1);
+    section->axis.dir[i]    = dir.Coord(i + 1);
+    section->axis.xdir[i]   = xdir.Coord(i + 1);
+  }
+
+  const PathFrameMode mode = PathFrameMode::kTurnUv;
+  BRepBuilderAPI_MakePolygon polygon(To3DPoint({0.0,    0.0},    section->axis, mode),
+                                     To3DPoint({height, 0.0},    section->axis, mode),
+                                     To3DPoint({height, radius}, section->axis, mode),
+                                     To3DPoint({0.0,    radius}, section->axis, mode),
+                                     Standard_True);
+  BRepBuilderAPI_MakeFace faceBuilder(polygon.Wire(), Standard_True);
+  if (!faceBuilder.IsDone()) return nullptr;
+
+  section->face = faceBuilder.Face();
+  return section;
+}
+
+bool IsOnTurnSectionAxis(const TurnSection& section, const AxisDto& axis) {
+  const gp_Vec sectionDir(gp_Dir(section.axis.dir[0], section.axis.dir[1], section.axis.dir[2]));
+  const gp_Vec toolDir   (gp_Dir(axis.dir[0],         axis.dir[1],         axis.dir[2]));
+  if (sectionDir.Crossed(toolDir).Magnitude() > kAxisAngularTol) return false;
+
+  const gp_Vec offset(gp_Pnt(section.axis.origin[0], section.axis.origin[1], section.axis.origin[2]),
+                      gp_Pnt(axis.origin[0],         axis.origin[1],         axis.origin[2]));
+  return offset.Crossed(sectionDir).Magnitude() <= kAxisLinearTol;
+}
+
+bool ArcDipsBelowTurnAxis(const Path2DSegmentDto& seg) {
+  const UvPoint from  {seg.from.u,   seg.from.v};
+  const UvPoint center{seg.center.u, seg.center.v};
+  const double radius = Distance2D(center, from);
+  if (center.v - radius >= -kGeomTol) return false;
+
+  double start = 0.0, sweep = 0.0;
+  ComputeArcSweep(seg, &start, &sweep);
+  double lowest = -0.25 * kFullRevolutionRadians - (sweep < 0.0 ? start + sweep : start);
+  lowest = std::fmod(lowest, kFullRevolutionRadians);
+  if (lowest < 0.0) lowest += kFullRevolutionRadians;
+  return lowest < std::fabs(sweep);
+}
+
+bool IsInTurnHalfPlane(const Path2DSegmentDto* segments, int segmentCount) {
+  for (int i = 0; i < segmentCount; ++i) {
+    const Path2DSegmentDto& seg = segments[i];
+    if (seg.from.v < -kGeomTol || seg.to.v < -kGeomTol) return false;
+    if (seg.type == PATH_SEGMENT_ARC && ArcDipsBelowTurnAxis(seg)) return false;
+  }
+  return true;
+}
+
+// Subtracts a turn profile from a stock that is still held as a half-section.
+// Returns false when the fast path does not apply (no section, profile off the
+// stock axis or crossing it); the caller then falls back to the 3D path.
+bool TryApplyTurnSection(OcctKernelImpl* impl, int stockId, const AxisDto& axis,
+                         const Path2DSegmentDto* segments, int segmentCount, int closed,
+                         OperationResult* outResult, int* outErrorCode,
+                         const Message_ProgressRange& range) {
+  const std::shared_ptr<const TurnSection> stock = impl->Registry().FindSection(stockId);
+  if (!stock || segmentCount <= 0) return false;
+  if (!IsOnTurnSectionAxis(*stock, axis) || !IsInTurnHalfPlane(segments, segmentCount))
+    return false;
+
+  // Rotating the profile plane about the axis does not change the revolved
+  // tool, so lay the profile into the stock's section plane.
+  AxisDto toolAxis = axis;
+  std::copy(stock->axis.xdir, stock->axis.xdir + 3, toolAxis.xdir);
+
+  TopoDS_Face toolFace;
+  if (!BuildFaceFromSegments(segments, segmentCount, closed, toolAxis,
+                             PathFrameMode::kTurnUv, &toolFace, outErrorCode)) {
+    outResult->errorCode = *outErrorCode;
+    return true;
+  }
+
+  TopoDS_Shape cutFace, commonFace;
+  const int booleanError = RunPooledBoolean(impl, stock->face, toolFace, true, false,
+                                            &cutFace, &commonFace, range);
+  if (booleanError != ERROR_OK) {
+    *outErrorCode = outResult->errorCode = booleanError;
+    return true;
+  }
+
+  auto makeSection = [stock](const TopoDS_Shape& face) {
+    auto section  = std::make_shared<TurnSection>();
+    section->axis = stock->axis;
+    section->face = face;
+    return section;
+  };
+
+  outResult->resultShapeId  = impl->Registry().AddSection(makeSection(cutFace));
+  outResult->deltaShapeId   = impl->Registry().AddSection(makeSection(commonFace));
+  outResult->removalShapeId = impl->Registry().AddSection(makeSection(toolFace));
+  outResult->booleanPath    = BOOLEAN_PATH_TURN_SECTION;
+  *outErrorCode = outResult->errorCode = ERROR_OK;
+  return true;
+}
+
+// When a prefetched build ran, for the pipeline's overlap report.
+struct ToolBuildWindow {
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  bool                                  ran = false;
+};
+
+// Whether RunApplyTurn takes the half-section fast path for `f` on a stock
+// held as `section` (null: a 3D stock); its result is then a section again.
+bool TakesTurnSectionPath(const TurnSection* section, const l1::JobFeature& f) {
+  if (!section || f.segments.empty() || (f.type != "TURN_OD" && f.type != "TURN_ID"))
+    return false;
+  return IsOnTurnSectionAxis(*section, f.axis) &&
+         IsInTurnHalfPlane(f.segments.data(), static_cast<int>(f.segments.size()));
+}
+
+// Queues the tool of a job feature on the kernel's prefetch thread; the
+// feature's L1_Apply* call then picks it up instead of building it. `f` is
+// applied to `stockId` after `previous` (null: directly). Turn features that
+// will take the half-section fast path are skipped, as the 3D tool would be
+// thrown away. `window` (optional) is filled by the build and may be read
+// once the build was taken or the cache cleared.
+void PrefetchJobTool(OcctKernelImpl* impl, int stockId, const l1::JobFeature* previous,
+                     const l1::JobFeature& f, ToolBuildWindow* window = nullptr) {
+  std::shared_ptr<const TurnSection> section = impl->Registry().FindSection(stockId);
+  if (previous && !TakesTurnSectionPath(section.get(), *previous)) section.reset();
+  if (TakesTurnSectionPath(section.get(), f)) return;
+
+  // Same inputs, field for field, as the matching RunApply* passes.
+  PathToolInput in{PathTool::kTurn, f.axis, f.segments.data(),
+                   static_cast<int>(f.segments.size()), f.closed, 0.0, 0.0};
+  if (f.type == "MILL_CONTOUR") {
+    in.kind  = PathTool::kMillContour;
+    in.depth = f.depth;
+  } else if (f.type == "MILL_SLOT") {
+    in.kind       = PathTool::kMillSlot;
+    in.closed     = 0;
+    in.depth      = f.depth;
+    in.toolRadius = f.toolRadius;
+  } else if (f.type != "TURN_OD" && f.type != "TURN_ID") {
+    return;
+  }
+  auto segments = std::make_shared<const std::vector<Path2DSegmentDto>>(f.segments);
+  impl->Tools().Prefetch(PathToolKey(in), [in, segments, window]() {
+    if (window) window->start = std::chrono::steady_clock::now();
+    PathToolInput own = in;
+    own.segments = segments->data();
+    ToolCache::Build build;
+    try {
+      build = BuildPathTool(own);
+    } catch (...) {
+      build.errorCode = MapExceptionToError();
+    }
+    if (window) {
+      window->end = std::chrono::steady_clock::now();
+      window->ran = true;
+    }
+    return build;
+  });
+}
+
+// ---------------------------------------------------------------------------
+// Z-map preview helpers
+// ---------------------------------------------------------------------------
+
+constexpr double kPreviewMaxCells = 64.0 * 1024.0 * 1024.0;
+
+// Maps a tool that starts at axis.origin and extends `depth` along axis.dir
+// into the grid frame. Only tools along the stock normal can be rasterised.
+bool ToPreviewToolFrame(const l1::ZMapGrid& grid, const AxisDto& axis, double depth,
+                        double outOrigin[3], double* outZBottom, double* outZTop) {
+  const gp_Dir dir(axis.dir[0], axis.dir[1], axis.dir[2]);
+  const double world[3] = {dir.X(), dir.Y(), dir.Z()};
+  double local[3];
+  grid.ToLocalVector(world, local);
+  if (std::hypot(local[0], local[1]) > kAxisAngularTol) return false;
+
+  grid.ToLocalPoint(axis.origin, outOrigin);
+  const double zEnd = outOrigin[2] + (local[2] > 0.0 ? depth : -depth);
+  *outZBottom = std::min(outOrigin[2], zEnd);
+  *outZTop    = std::max(outOrigin[2], zEnd);
+  return true;
+}
+
+void AppendPreviewPoint(const l1::ZMapGrid& grid, const gp_Pnt& p, l1::ZMapGrid::Loop* loop) {
+  const double world[3] = {p.X(), p.Y(), p.Z()};
+  double local[3];
+  grid.ToLocalPoint(world, local);
+  loop->push_back({local[0], local[1]});
+}
+
+// Flattens a validated closed planar profile into a polygon in the grid frame,
+// with arcs split finely enough for the grid resolution.
+l1::ZMapGrid::Loop FlattenPreviewProfile(const l1::ZMapGrid& grid, const AxisDto& axis,
+                                         const Path2DSegmentDto* segments, int segmentCount) {
+  const double chordTol = 0.25 * grid.CellSize();
+  l1::ZMapGrid::Loop loop;
+  for (int i = 0; i < segmentCount; ++i) {
+    const Path2DSegmentDto& seg = segments[i];
+    const UvPoint from{seg.from.u, seg.from.v};
+    AppendPreviewPoint(grid, To3DPoint(from, axis, PathFrameMode::kPlanarUv), &loop);
+    if (seg.type != PATH_SEGMENT_ARC) continue;
+
+    const UvPoint center{seg.center.u, seg.center.v};
+    const double radius = Distance2D(center, from);
+    double start = 0.0, sweep = 0.0;
+    ComputeArcSweep(seg, &start, &sweep);
+    const double maxStep = radius > chordTol
+        ? 2.0 * std::acos(1.0 - chordTol / radius)
+        : kFullRevolutionRadians / 8.0;
+    const int steps = std::max(2, static_cast<int>(std::ceil(std::fabs(sweep) / maxStep)));
+    for (int k = 1; k < steps; ++k) {
+      const double a = start + sweep * k / steps;
+      const UvPoint p{center.u + radius * std::cos(a), center.v + radius * std::sin(a)};
+      AppendPreviewPoint(grid, To3DPoint(p, axis, PathFrameMode::kPlanarUv), &loop);
+    }
+  }
+  return loop;
+}
+
+// ---------------------------------------------------------------------------
+// Boolean prefilter
+// ---------------------------------------------------------------------------
+
+// Minimum gap between tool and stock boundaries for the tool to count as
+// strictly inside the stock.
+constexpr double kContainmentGap = 1.0e-5;
+
+ShapeBounds ComputeShapeBounds(const TopoDS_Shape& shape) {
+  ShapeBounds bounds;
+  BRepBndLib::Add(shape, bounds.aabb, Standard_False);
+  BRepBndLib::AddOBB(shape, bounds.obb, Standard_False, Standard_False, Standard_True);
+  return bounds;
+}
+
+bool IsBoxInside(const Bnd_Box& inner, const Bnd_Box& outer) {
+  if (inner.IsVoid() || outer.IsVoid()) return false;
+  double ixmin, iymin, izmin, ixmax, iymax, izmax;
+  double oxmin, oymin, ozmin, oxmax, oymax, ozmax;
+  inner.Get(ixmin, iymin, izmin, ixmax, iymax, izmax);
+  outer.Get(oxmin, oymin, ozmin, oxmax, oymax, ozmax);
+  return ixmin > oxmin && iymin > oymin && izmin > ozmin &&
+         ixmax < oxmax && iymax < oymax && izmax < ozmax;
+}
+
+TopoDS_Compound CollectFaces(const TopoDS_Shape& shape) {
+  BRep_Builder builder;
+  TopoDS_Compound faces;
+  builder.MakeCompound(faces);
+  for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next())
+    builder.Add(faces, exp.Current());
+  return faces;
+}
+
+// A tool is strictly inside the stock when their boundaries keep a gap and
+// one tool vertex classifies IN. Only worth asking once the boxes nest.
+// Stock faces whose box stays clear of the tool's box cannot meet the tool,
+// so usually no face pair is measured at all: the vertex probe alone
+// decides. Only faces reaching into the tool's box get a B-rep distance.
+bool IsToolContained(const TopoDS_Shape& stock, const TopoDS_Shape& tool, const Bnd_Box& toolBox) {
+  TopExp_Explorer vertexExp(tool, TopAbs_VERTEX);
+  if (!vertexExp.More()) return false;
+
+  Bnd_Box reach = toolBox;
+  reach.Enlarge(kContainmentGap);
+  BRep_Builder builder;
+  TopoDS_Compound nearFaces;
+  builder.MakeCompound(nearFaces);
+  bool anyNear = false;
+  for (TopExp_Explorer exp(stock, TopAbs_FACE); exp.More(); exp.Next()) {
+    Bnd_Box faceBox;
+    BRepBndLib::Add(exp.Current(), faceBox, Standard_False);
+    if (faceBox.IsOut(reach)) continue;
+    builder.Add(nearFaces, exp.Current());
+    anyNear = true;
+  }
+  if (anyNear) {
+    BRepExtrema_DistShapeShape distance(nearFaces, CollectFaces(tool));
+    if (!distance.IsDone() || distance.Value() <= kContainmentGap) return false;
+  }
+
+  const gp_Pnt probe = BRep_Tool::Pnt(TopoDS::Vertex(vertexExp.Current()));
+  BRepClass3d_SolidClassifier classifier(stock, probe, kGeomTol);
+  return classifier.State() == TopAbs_IN;
+}
+
+// How far a flush tool's box is nudged into the stock's box; well above the
+// tolerance gap BRepBndLib adds to both.
+constexpr double kGlueProbeShift = 1.0e-4;
+
+bool PlanarOutwardNormal(const TopoDS_Face& face, gp_Pln* outPlane) {
+  BRepAdaptor_Surface surface(face, Standard_False);
+  if (surface.GetType() != GeomAbs_Plane) return false;
+  gp_Pln plane = surface.Plane();
+  if (face.Orientation() == TopAbs_REVERSED) plane.SetAxis(plane.Axis().Reversed());
+  *outPlane = plane;
+  return true;
+}
+
+bool IsFaceOnPlane(const TopoDS_Face& face, const gp_Pln& plane) {
+  gp_Pln facePlane;
+  return PlanarOutwardNormal(face, &facePlane) &&
+         facePlane.Axis().Direction().IsParallel(plane.Axis().Direction(), kGeomTol) &&
+         plane.Distance(facePlane.Location()) <= kGeomTol;
+}
+
+bool IsFaceOnAnyPlane(const TopoDS_Face& face, const std::vector<gp_Pln>& planes) {
+  return std::any_of(planes.begin(), planes.end(),
+                     [&](const gp_Pln& plane) { return IsFaceOnPlane(face, plane); });
+}
+
+// Stock face planes that a tool face lies flush against (same plane, same
+// outward side, i.e. the tool sits inside the stock there).
+std::vector<gp_Pln> FindFlushPlanes(const TopoDS_Shape& stock, const TopoDS_Shape& tool) {
+  std::vector<gp_Pln> toolPlanes;
+  for (TopExp_Explorer exp(tool, TopAbs_FACE); exp.More(); exp.Next()) {
+    gp_Pln plane;
+    if (PlanarOutwardNormal(TopoDS::Face(exp.Current()), &plane)) toolPlanes.push_back(plane);
+  }
+
+  std::vector<gp_Pln> planes;
+  if (toolPlanes.empty()) return planes;
+  for (TopExp_Explorer exp(stock, TopAbs_FACE); exp.More(); exp.Next()) {
+    gp_Pln stockPlane;
+    if (!PlanarOutwardNormal(TopoDS::Face(exp.Current()), &stockPlane)) continue;
+    const gp_Dir normal = stockPlane.Axis().Direction();
+    for (const gp_Pln& toolPlane : toolPlanes) {
+      if (!normal.IsEqual(toolPlane.Axis().Direction(), kGeomTol) ||
+          stockPlane.Distance(toolPlane.Location()) > kGeomTol)
+        continue;
+      const bool seen = std::any_of(planes.begin(), planes.end(), [&](const gp_Pln& p) {
+        return p.Axis().Direction().IsEqual(normal, kGeomTol) &&
+               p.Distance(stockPlane.Location()) <= kGeomTol;
+      });
+      if (!seen) planes.push_back(stockPlane);
+    }
+  }
+  return planes;
+}
+
+// IsToolContained with the flush planes left out: apart from its faces on
+// those planes, the tool keeps a gap to every stock face not on them, and a
+// tool vertex off the planes classifies IN. This is what glue relies on, and
+// it catches what boxes cannot see (overlaps with earlier pockets,
+// break-outs through inner walls, tools over an earlier opening).
+bool IsToolInsideBelowFlush(const TopoDS_Shape& stock, const TopoDS_Shape& tool,
+                            const Bnd_Box& toolBox, const std::vector<gp_Pln>& planes) {
+  BRep_Builder builder;
+  TopoDS_Compound toolFaces;
+  builder.MakeCompound(toolFaces);
+  bool anyToolFace = false;
+  for (TopExp_Explorer exp(tool, TopAbs_FACE); exp.More(); exp.Next()) {
+    if (IsFaceOnAnyPlane(TopoDS::Face(exp.Current()), planes)) continue;
+    builder.Add(toolFaces, exp.Current());
+    anyToolFace = true;
+  }
+
+  Bnd_Box reach = toolBox;
+  reach.Enlarge(kContainmentGap);
+  TopoDS_Compound nearFaces;
+  builder.MakeCompound(nearFaces);
+  bool anyNear = false;
+  for (TopExp_Explorer exp(stock, TopAbs_FACE); exp.More(); exp.Next()) {
+    Bnd_Box faceBox;
+    BRepBndLib::Add(exp.Current(), faceBox, Standard_False);
+    if (faceBox.IsOut(reach) || IsFaceOnAnyPlane(TopoDS::Face(exp.Current()), planes)) continue;
+    builder.Add(nearFaces, exp.Current());
+    anyNear = true;
+  }
+  if (anyToolFace && anyNear) {
+    BRepExtrema_DistShapeShape distance(nearFaces, toolFaces);
+    if (!distance.IsDone() || distance.Value() <= kContainmentGap) return false;
+  }
+
+  for (TopExp_Explorer exp(tool, TopAbs_VERTEX); exp.More(); exp.Next()) {
+    const gp_Pnt probe = BRep_Tool::Pnt(TopoDS::Vertex(exp.Current()));
+    const bool offPlanes = std::all_of(planes.begin(), planes.end(), [&](const gp_Pln& plane) {
+      return plane.Distance(probe) > kGlueProbeShift;
+    });
+    if (!offPlanes) continue;
+    BRepClass3d_SolidClassifier classifier(stock, probe, kGeomTol);
+    return classifier.State() == TopAbs_IN;
+  }
+  return false;
+}
+
+// Holes, pockets and contours normally start exactly on a stock face. Glue
+// is safe when that coinciding face is the only contact. The tool's box,
+// moved slightly inward across the flush face, must lie inside the stock's
+// box; then IsToolInsideBelowFlush checks the faces near the tool.
+bool IsFlushTool(const TopoDS_Shape& stock, const ShapeBounds& stockBounds,
+                 const TopoDS_Shape& tool, const ShapeBounds& toolBounds) {
+  if (toolBounds.aabb.IsVoid() || stockBounds.aabb.IsOut(toolBounds.aabb)) return false;
+  const std::vector<gp_Pln> planes = FindFlushPlanes(stock, tool);
+  const bool nested = std::any_of(planes.begin(), planes.end(), [&](const gp_Pln& plane) {
+    gp_Trsf shift;
+    shift.SetTranslation(gp_Vec(plane.Axis().Direction()) * -kGlueProbeShift);
+    return IsBoxInside(toolBounds.aabb.Transformed(shift), stockBounds.aabb);
+  });
+  return nested && IsToolInsideBelowFlush(stock, tool, toolBounds.aabb, planes);
+}
+
+bool ShouldGlue(BooleanGlueMode mode, const TopoDS_Shape& stock, const ShapeBounds& stockBounds,
+                const TopoDS_Shape& tool, const ShapeBounds& toolBounds) {
+  switch (mode) {
+    case BOOLEAN_GLUE_ON:   return true;
+    case BOOLEAN_GLUE_AUTO: return IsFlushTool(stock, stockBounds, tool, toolBounds);
+    default:                return false;
+  }
+}
+
+BooleanPath ClassifyTool(const TopoDS_Shape& stock, const ShapeBounds& stockBounds,
+                         const TopoDS_Shape& tool, const ShapeBounds& toolBounds) {
+  if (stockBounds.aabb.IsOut(toolBounds.aabb)) return BOOLEAN_PATH_MISS;
+  if (!stockBounds.obb.IsVoid() && !toolBounds.obb.IsVoid() &&
+      stockBounds.obb.IsOut(toolBounds.obb))
+    return BOOLEAN_PATH_MISS;
+  if (IsBoxInside(toolBounds.aabb, stockBounds.aabb) &&
+      IsToolContained(stock, tool, toolBounds.aabb))
+    return BOOLEAN_PATH_CONTAINED;
+  return BOOLEAN_PATH_FULL;
+}
+
+// ---------------------------------------------------------------------------
+// Result validation
+// ---------------------------------------------------------------------------
+
+constexpr double kDefaultToleranceLimit = 1.0e-3;
+
+// Topology walk only; no curve or surface is evaluated.
+bool CheckStructure(const TopoDS_Shape& shape, ValidationReport* report) {
+  TopTools_IndexedMapOfShape solids, shells, faces, edges;
+  TopExp::MapShapes(shape, TopAbs_SOLID, solids);
+  TopExp::MapShapes(shape, TopAbs_SHELL, shells);
+  TopExp::MapShapes(shape, TopAbs_FACE,  faces);
+  TopExp::MapShapes(shape, TopAbs_EDGE,  edges);
+  report->solidCount = solids.Extent();
+  report->shellCount = shells.Extent();
+  report->faceCount  = faces.Extent();
+  report->edgeCount  = edges.Extent();
+  if (faces.IsEmpty()) return false;
+
+  for (int i = 1; i <= faces.Extent(); ++i) {
+    const TopoDS_Face& face = TopoDS::Face(faces(i));
+    if (BRep_Tool::Surface(face).IsNull() || !TopExp_Explorer(face, TopAbs_WIRE).More())
+      return false;
+  }
+  for (int i = 1; i <= edges.Extent(); ++i) {
+    const TopoDS_Edge& edge = TopoDS::Edge(edges(i));
+    double first = 0.0, last = 0.0;
+    if (!BRep_Tool::Degenerated(edge) && BRep_Tool::Curve(edge, first, last).IsNull())
+      return false;
+  }
+  return true;
+}
+
+bool CheckClosed(const TopoDS_Shape& shape, double toleranceLimit, ValidationReport* report) {
+  TopTools_IndexedDataMapOfShapeListOfShape edgeFaces;
+  TopExp::MapShapesAndUniqueAncestors(shape, TopAbs_EDGE, TopAbs_FACE, edgeFaces);
+  report->freeEdgeCount = 0;
+  for (int i = 1; i <= edgeFaces.Extent(); ++i) {
+    const TopoDS_Edge& edge = TopoDS::Edge(edgeFaces.FindKey(i));
+    const TopTools_ListOfShape& faces = edgeFaces(i);
+    if (BRep_Tool::Degenerated(edge) || faces.Extent() != 1) continue;
+    if (!BRep_Tool::IsClosed(edge, TopoDS::Face(faces.First()))) ++report->freeEdgeCount;  // seams are closed
+  }
+
+  report->openShellCount = 0;
+  for (TopExp_Explorer exp(shape, TopAbs_SHELL); exp.More(); exp.Next())
+    if (!BRep_Tool::IsClosed(exp.Current())) ++report->openShellCount;
+
+  double maxTolerance = 0.0;
+  for (TopExp_Explorer exp(shape, TopAbs_VERTEX); exp.More(); exp.Next())
+    maxTolerance = std::max(maxTolerance, BRep_Tool::Tolerance(TopoDS::Vertex(exp.Current())));
+  for (int i = 1; i <= edgeFaces.Extent(); ++i)
+    maxTolerance = std::max(maxTolerance, BRep_Tool::Tolerance(TopoDS::Edge(edgeFaces.FindKey(i))));
+  for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next())
+    maxTolerance = std::max(maxTolerance, BRep_Tool::Tolerance(TopoDS::Face(exp.Current())));
+  report->maxTolerance = maxTolerance;
+
+  return report->freeEdgeCount == 0 && report->openShellCount == 0 &&
+         maxTolerance <= toleranceLimit;
+}
+
+// BRepCheck_Analyzer runs its face checks on OCCT's thread pool.
+bool CheckFull(const TopoDS_Shape& shape, ValidationReport* report) {
+  BRepCheck_Analyzer analyzer(shape, Standard_True, Standard_True);
+  report->invalidSubShapeCount = 0;
+  if (analyzer.IsValid()) return true;
+
+  for (TopAbs_ShapeEnum type : {TopAbs_VERTEX, TopAbs_EDGE, TopAbs_WIRE, TopAbs_FACE,
+                                TopAbs_SHELL, TopAbs_SOLID}) {
+    TopTools_IndexedMapOfShape subShapes;
+    TopExp::MapShapes(shape, type, subShapes);
+    for (int i = 1; i <= subShapes.Extent(); ++i)
+      if (!analyzer.IsValid(subShapes(i))) ++report->invalidSubShapeCount;
+  }
+  return false;
+}
+
+// Runs the levels in order up to `level` and stops at the first failure, so
+// a broken shape never pays for the expensive checks.
+bool ValidateShape(const TopoDS_Shape& shape, ValidationLevel level, double toleranceLimit,
+                   ValidationReport* report) {
+  using Clock = std::chrono::steady_clock;
+  auto timed = [](double* ms, auto&& check) {
+    const auto start = Clock::now();
+    const bool ok = check();
+    *ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return ok;
+  };
+
+  report->valid       = 0;
+  report->failedLevel = VALIDATE_OFF;
+  if (level >= VALIDATE_STRUCTURE &&
+      !timed(&report->structureMs, [&] { return CheckStructure(shape, report); })) {
+    report->failedLevel = VALIDATE_STRUCTURE;
+    return false;
+  }
+  if (level >= VALIDATE_CLOSED &&
+      !timed(&report->closedMs, [&] { return CheckClosed(shape, toleranceLimit, report); })) {
+    report->failedLevel = VALIDATE_CLOSED;
+    return false;
+  }
+  if (level >= VALIDATE_FULL &&
+      !timed(&report->fullMs, [&] { return CheckFull(shape, report); })) {
+    report->failedLevel = VALIDATE_FULL;
+    return false;
+  }
+  report->valid = 1;
+  return true;
+}
+
+// KernelOptions.validateResults on a boolean result.
+bool IsAcceptedResult(const KernelOptions& options, const TopoDS_Shape& result) {
+  if (options.validateResults == VALIDATE_OFF) return true;
+  ValidationReport report{};
+  return ValidateShape(result, options.validateResults, kDefaultToleranceLimit, &report);
+}
+
 // ---------------------------------------------------------------------------
 // Common boolean cut + common helper
 // ---------------------------------------------------------------------------
 
 int ApplyBooleanOp(OcctKernelImpl* impl, int stockId, const TopoDS_Shape& tool,
-                   OperationResult* outResult) {
-  const TopoDS_Shape* stock = impl->Registry().Find(stockId);
-  if (!stock) {
+                   OperationResult* outResult, const Message_ProgressRange& range) {
+  TopoDS_Shape stock;
+  std::shared_ptr<const ShapeBounds> stockBounds;
+  if (!impl->Registry().FindWithBounds(stockId, &stock, &stockBounds)) {
     outResult->errorCode = ERROR_SHAPE_NOT_FOUND;
     return ERROR_SHAPE_NOT_FOUND;
   }
 
-  BRepAlgoAPI_Cut cut(*stock, tool);
-  if (!cut.IsDone()) {
-    outResult->errorCode = ERROR_BOOLEAN_FAILED;
-    return ERROR_BOOLEAN_FAILED;
+  const KernelOptions options = impl->Options();
+  const ShapeBounds toolBounds = ComputeShapeBounds(tool);
+  BooleanPath path = ClassifyTool(stock, *stockBounds, tool, toolBounds);
+  if (path == BOOLEAN_PATH_MISS) {
+    if (options.unifySameDomain)
+      outResult->faceCountBefore = outResult->faceCountAfter = CountFaces(stock);
+    // The snapshot in hand, not the id: a concurrent L1_DeleteShape may have
+    // removed it since. Ids are never reused, so a section found is this
+    // shape's; a missing one only loses the turning fast path.
+    outResult->resultShapeId  = impl->Registry().AddWithBounds(
+        stock, stockBounds, impl->Registry().FindSection(stockId));
+    outResult->deltaShapeId   = impl->Registry().Add(MakeEmptyCompound());
+    outResult->removalShapeId = impl->Registry().Add(tool);
+    outResult->booleanPath    = path;
+    outResult->errorCode      = ERROR_OK;
+    return ERROR_OK;
+  }
+
+  // A contained tool is removed whole, so the delta is the tool itself.
+  const bool withCommon = path != BOOLEAN_PATH_CONTAINED;
+  TopoDS_Shape result, delta = tool;
+  int* unmergedFaces = options.unifySameDomain ? &outResult->faceCountBefore : nullptr;
+
+  // Every attempt is validated once, on the compacted shape it would
+  // register; a glue result that fails falls back to the general boolean.
+  auto attempt = [&](bool glue) {
+    int rc = RunPooledBoolean(impl, stock, tool, withCommon, glue, &result,
+                              withCommon ? &delta : nullptr, range, unmergedFaces);
+    if (rc == ERROR_OK && !IsAcceptedResult(options, result)) rc = ERROR_INVALID_RESULT;
+    return rc;
+  };
+
+  int booleanError = ERROR_BOOLEAN_FAILED;
+  if (path == BOOLEAN_PATH_FULL &&
+      ShouldGlue(options.glueMode, stock, *stockBounds, tool, toolBounds)) {
+    booleanError = attempt(true);
+    if (booleanError == ERROR_OK) path = BOOLEAN_PATH_GLUE;
+  }
+  if (booleanError != ERROR_OK) booleanError = attempt(false);
+  if (booleanError != ERROR_OK) {
+    outResult->errorCode = booleanError;
+    return booleanError;
+  }
+
+  if (options.unifySameDomain) outResult->faceCountAfter = CountFaces(result);
+
+  outResult->resultShapeId = impl->Registry().Add(result);
+  outResult->deltaShapeId  = impl->Registry().Add(delta);
+  outResult->removalShapeId = impl->Registry().Add(tool);
+  outResult->booleanPath   = path;
+  outResult->errorCode     = ERROR_OK;
+  return ERROR_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Tessellation
+// ---------------------------------------------------------------------------
+
+constexpr int kMaxMeshPasses = 4;
+
+MeshOptions DefaultMeshOptions() {
+  MeshOptions options{};
+  options.structSize        = sizeof(MeshOptions);
+  options.linearDeflection  = 0.1;
+  options.angularDeflection = 0.5;
+  options.algorithm         = MESH_ALGO_DEFAULT;
+  return options;
+}
+
+// OutputOptions as the exporter read it before MeshOptions existed:
+// `parallel` went into BRepMesh_IncrementalMesh's isRelative slot and faces
+// were always meshed in parallel. Existing jobs are tuned to that (the
+// sample's 0.1 with parallel 1 is a tenth of each edge, not 0.1 mm), so the
+// OutputOptions path keeps it; pass IsEdgeRelative(opt) to MeshShape.
+MeshOptions ToMeshOptions(const OutputOptions& opt) {
+  MeshOptions options = DefaultMeshOptions();
+  options.linearDeflection  = opt.linearDeflection;
+  options.angularDeflection = opt.angularDeflection;
+  options.parallel          = 1;
+  return options;
+}
+
+bool IsEdgeRelative(const OutputOptions& opt) { return opt.parallel != 0; }
+
+IMeshTools_MeshAlgoType ToMeshAlgoType(MeshAlgorithm algorithm) {
+  switch (algorithm) {
+    case MESH_ALGO_WATSON:    return IMeshTools_MeshAlgoType_Watson;
+    case MESH_ALGO_DELABELLA: return IMeshTools_MeshAlgoType_Delabella;
+    default:                  return IMeshTools_MeshAlgoType_DEFAULT;
+  }
+}
+
+void CountTriangles(const TopoDS_Shape& shape, MeshStats* stats) {
+  stats->triangleCount = stats->nodeCount = 0;
+  for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+    TopLoc_Location location;
+    const Handle(Poly_Triangulation)& triangulation =
+        BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), location);
+    if (triangulation.IsNull()) continue;
+    stats->triangleCount += triangulation->NbTriangles();
+    stats->nodeCount     += triangulation->NbNodes();
+  }
+}
+
+// Meshes `shape` in place and returns it. Callers pass a topology copy
+// (BRepBuilderAPI_Copy without geometry), never a registry shape: registry
+// faces are shared with other operations, and budgeted meshing cleans the
+// triangulation between passes since a mesher never coarsens one.
+// edgeRelative: the deflection is a fraction of each edge's size (OCCT's
+// Relative mode), for the legacy OutputOptions path only.
+int MeshShape(const TopoDS_Shape& shape, const Bnd_Box& bounds, const MeshOptions& opt,
+              TopoDS_Shape* outMeshed, MeshStats* outStats, const Message_ProgressRange& range,
+              bool edgeRelative = false) {
+  double deflection = opt.linearDeflection;
+  if (opt.relativeDeflection > 0.0) {
+    if (bounds.IsVoid()) return ERROR_INVALID_ARGUMENT;
+    deflection = opt.relativeDeflection * std::sqrt(bounds.SquareExtent());
+  }
+  if (deflection <= 0.0 || opt.angularDeflection <= 0.0) return ERROR_INVALID_ARGUMENT;
+
+  const auto start = std::chrono::steady_clock::now();
+  const bool budgeted = opt.triangleBudget > 0;
+  TopoDS_Shape target = shape;
+
+  Message_ProgressScope scope(range, "Mesh", budgeted ? kMaxMeshPasses : 1);
+  MeshStats stats{};
+  for (int pass = 1;; ++pass) {
+    IMeshTools_Parameters params;
+    params.Deflection = deflection;
+    params.Angle      = opt.angularDeflection;
+    params.Relative   = edgeRelative;
+    params.InParallel = opt.parallel != 0;
+    params.MeshAlgo   = ToMeshAlgoType(opt.algorithm);
+    if (opt.minSize > 0.0) params.MinSize = opt.minSize;
+
+    BRepMesh_IncrementalMesh mesher(target, params, scope.Next());
+    if (!mesher.IsDone() || scope.UserBreak()) return ERROR_EXPORT_FAILED;
+
+    CountTriangles(target, &stats);
+    stats.passes           = pass;
+    stats.linearDeflection = deflection;
+    if (!budgeted || stats.triangleCount <= opt.triangleBudget || pass == kMaxMeshPasses) break;
+
+    // Triangle counts scale with deflection^-1/2 on cylinders up to
+    // deflection^-1 on doubly curved faces; ratio^2 reaches the budget in one
+    // more pass for the cylinder-heavy parts we mill and turn.
+    const double ratio = static_cast<double>(stats.triangleCount) / opt.triangleBudget;
+    deflection *= std::clamp(ratio * ratio, 1.5, 16.0);
+    BRepTools::Clean(target);
   }
 
-  BRepAlgoAPI_Common common(*stock, tool);
-  if (!common.IsDone()) {
-    outResult->errorCode = ERROR_DELTA_FAILED;
-    return ERROR_DELTA_FAILED;
+  stats.meshMs = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+  if (outStats) CopyStructFields(outStats, &stats, outStats->structSize);
+  *outMeshed = target;
+  return ERROR_OK;
+}
+
+// Triangles of every face in model space. Faces keep their own vertices, so
+// normals (area-weighted over the face's triangles) stay sharp at edges.
+void CollectMeshBuffers(const TopoDS_Shape& meshed, bool withNormals,
+                        l1::qmesh::MeshBuffers* out) {
+  std::vector<gp_Pnt> nodes;
+  std::vector<gp_Vec> normals;
+  for (TopExp_Explorer exp(meshed, TopAbs_FACE); exp.More(); exp.Next()) {
+    const TopoDS_Face& face = TopoDS::Face(exp.Current());
+    TopLoc_Location location;
+    const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, location);
+    if (triangulation.IsNull()) continue;
+
+    const gp_Trsf       trsf     = location.Transformation();
+    const bool          reversed = face.Orientation() == TopAbs_REVERSED;
+    const std::uint32_t base     = static_cast<std::uint32_t>(out->positions.size() / 3);
+    nodes.resize(static_cast<std::size_t>(triangulation->NbNodes()));
+    for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+      const gp_Pnt p = triangulation->Node(i).Transformed(trsf);
+      nodes[i - 1] = p;
+      out->positions.insert(out->positions.end(), {static_cast<float>(p.X()),
+                                                   static_cast<float>(p.Y()),
+                                                   static_cast<float>(p.Z())});
+    }
+
+    if (withNormals) normals.assign(nodes.size(), gp_Vec(0.0, 0.0, 0.0));
+    for (int t = 1; t <= triangulation->NbTriangles(); ++t) {
+      int n1 = 0, n2 = 0, n3 = 0;
+      triangulation->Triangle(t).Get(n1, n2, n3);
+      if (reversed) std::swap(n2, n3);
+      out->indices.insert(out->indices.end(), {base + static_cast<std::uint32_t>(n1 - 1),
+                                               base + static_cast<std::uint32_t>(n2 - 1),
+                                               base + static_cast<std::uint32_t>(n3 - 1)});
+      if (withNormals) {
+        const gp_Pnt& a = nodes[n1 - 1];
+        const gp_Vec  n = gp_Vec(a, nodes[n2 - 1]).Crossed(gp_Vec(a, nodes[n3 - 1]));
+        for (int k : {n1, n2, n3}) normals[k - 1] += n;
+      }
+    }
+    for (gp_Vec& n : normals) {
+      const double length = n.Magnitude();
+      if (length > gp::Resolution()) n /= length;
+      out->normals.insert(out->normals.end(), {static_cast<float>(n.X()),
+                                               static_cast<float>(n.Y()),
+                                               static_cast<float>(n.Z())});
+    }
+  }
+}
+
+// Writes the triangulation `meshed` carries as OUT_STL or OUT_QMESH.
+int WriteMeshFile(const TopoDS_Shape& meshed, OutputFormat format, const MeshOptions& opt,
+                  const std::string& filePathUtf8, const Message_ProgressRange& range) {
+  if (format == OUT_STL) {
+    StlAPI_Writer writer;
+    return writer.Write(meshed, filePathUtf8.c_str(), range) ? ERROR_OK : ERROR_EXPORT_FAILED;
+  }
+
+  l1::qmesh::MeshBuffers buffers;
+  CollectMeshBuffers(meshed, opt.octNormals != 0, &buffers);
+  const std::string encoded = l1::qmesh::Encode(buffers, opt.positionBits, opt.octNormals != 0);
+  std::ofstream ofs(std::filesystem::u8path(filePathUtf8), std::ios::binary | std::ios::trunc);
+  if (!ofs.write(encoded.data(), static_cast<std::streamsize>(encoded.size())))
+    return ERROR_EXPORT_FAILED;
+  return ERROR_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Deviation analysis
+// ---------------------------------------------------------------------------
+
+constexpr double kDefaultCompareDeflection = 1.0e-3;  // of the bounding-box diagonal
+
+// Surface sample pitch, in linear deflections, and the sample budget per
+// direction: a finer pitch only resolves the chords the deflection allows.
+constexpr double      kCompareSampleSpacing = 4.0;
+constexpr std::size_t kMaxCompareSamples    = std::size_t{1} << 21;
+
+void SummarizeDeviations(const std::vector<float>& deviations, double histogramRange,
+                         CompareReport* report) {
+  report->sampleCount = static_cast<int>(deviations.size());
+  if (deviations.empty()) return;
+
+  double sum = 0.0, sumAbs = 0.0, sumSq = 0.0;
+  report->minDeviation = std::numeric_limits<double>::max();
+  report->maxDeviation = std::numeric_limits<double>::lowest();
+  for (const float d : deviations) {
+    report->minDeviation = std::min(report->minDeviation, static_cast<double>(d));
+    report->maxDeviation = std::max(report->maxDeviation, static_cast<double>(d));
+    sum    += d;
+    sumAbs += std::fabs(d);
+    sumSq  += static_cast<double>(d) * d;
+  }
+  const double n = static_cast<double>(deviations.size());
+  report->meanDeviation    = sum / n;
+  report->meanAbsDeviation = sumAbs / n;
+  report->rmsDeviation     = std::sqrt(sumSq / n);
+
+  const double range = histogramRange > 0.0
+      ? histogramRange
+      : std::max(std::fabs(report->minDeviation), std::fabs(report->maxDeviation));
+  report->histogramRange = range;
+  constexpr int kBins = L1_DEVIATION_HISTOGRAM_BINS;
+  for (const float d : deviations) {
+    const int bin = range > 0.0 ? static_cast<int>(std::floor((d + range) / (2.0 * range) * kBins))
+                                : kBins / 2;
+    ++report->histogram[std::clamp(bin, 0, kBins - 1)];
+  }
+}
+
+// Both shapes are meshed from topology copies, as in MeshStageShape: the
+// reference may be a cached import other kernels are meshing too.
+int RunCompareShapes(OcctKernelImpl* impl, int shapeId, int referenceId,
+                     const CompareOptions& opt, const char* deviationMeshFileUtf8,
+                     CompareReport* report) {
+  try {
+    TopoDS_Shape shape, reference;
+    std::shared_ptr<const ShapeBounds> shapeBounds;
+    if (!impl->Registry().FindWithBounds(shapeId, &shape, &shapeBounds) ||
+        !impl->Registry().Find(referenceId, &reference))
+      return ERROR_SHAPE_NOT_FOUND;
+
+    MeshOptions mesh = DefaultMeshOptions();
+    mesh.parallel          = 1;
+    mesh.angularDeflection = opt.angularDeflection > 0.0 ? opt.angularDeflection
+                                                         : mesh.angularDeflection;
+    mesh.linearDeflection  = opt.linearDeflection;
+    if (mesh.linearDeflection <= 0.0) {
+      const Bnd_Box& bounds = shapeBounds->aabb;
+      if (bounds.IsVoid()) return ERROR_INVALID_ARGUMENT;
+      mesh.linearDeflection = kDefaultCompareDeflection * std::sqrt(bounds.SquareExtent());
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point start) {
+      return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    auto start = Clock::now();
+    TopoDS_Shape meshedShape, meshedReference;
+    int meshError = MeshShape(BRepBuilderAPI_Copy(shape, Standard_False, Standard_False).Shape(),
+                              Bnd_Box(), mesh, &meshedShape, nullptr, Message_ProgressRange());
+    if (meshError == ERROR_OK)
+      meshError = MeshShape(BRepBuilderAPI_Copy(reference, Standard_False, Standard_False).Shape(),
+                            Bnd_Box(), mesh, &meshedReference, nullptr, Message_ProgressRange());
+    if (meshError != ERROR_OK) return meshError;
+
+    const bool writeMesh = deviationMeshFileUtf8 && *deviationMeshFileUtf8;
+    l1::qmesh::MeshBuffers shapeMesh, referenceMesh;
+    CollectMeshBuffers(meshedShape, writeMesh, &shapeMesh);
+    CollectMeshBuffers(meshedReference, false, &referenceMesh);
+    report->meshMs = msSince(start);
+
+    start = Clock::now();
+    const double spacing = kCompareSampleSpacing * mesh.linearDeflection;
+    const std::vector<float> shapeSamples =
+        l1::SampleSurface(shapeMesh.positions, shapeMesh.indices, spacing, kMaxCompareSamples);
+    const std::vector<float> referenceSamples = l1::SampleSurface(
+        referenceMesh.positions, referenceMesh.indices, spacing, kMaxCompareSamples);
+    const l1::TriangleBvh referenceBvh(referenceMesh.positions, referenceMesh.indices,
+                                       opt.threadCount);
+    const l1::TriangleBvh shapeBvh(shapeMesh.positions, shapeMesh.indices, opt.threadCount);
+    referenceMesh = l1::qmesh::MeshBuffers();
+    report->referenceTriangleCount = referenceBvh.TriangleCount();
+    report->bvhMs = msSince(start);
+    if (referenceBvh.TriangleCount() == 0 || shapeBvh.TriangleCount() == 0)
+      return ERROR_INVALID_ARGUMENT;
+
+    start = Clock::now();
+    const std::vector<float> deviations =
+        l1::ComputeDeviations(referenceBvh, shapeSamples, opt.threadCount);
+    const std::vector<float> reverse =
+        l1::ComputeDeviations(shapeBvh, referenceSamples, opt.threadCount);
+    report->queryMs = msSince(start);
+    SummarizeDeviations(deviations, opt.histogramRange, report);
+
+    // The reverse direction catches reference features the compared shape
+    // lacks altogether, e.g. a boss milled off, which no sample on the
+    // compared surface lands near.
+    report->reverseSampleCount = static_cast<int>(reverse.size());
+    for (const float d : reverse)
+      report->reverseMaxAbsDeviation =
+          std::max(report->reverseMaxAbsDeviation, static_cast<double>(std::fabs(d)));
+    report->hausdorffDistance =
+        std::max({std::fabs(report->minDeviation), std::fabs(report->maxDeviation),
+                  report->reverseMaxAbsDeviation});
+
+    if (writeMesh) {
+      // Samples start with the mesh vertices, in vertex order.
+      shapeMesh.scalars.assign(deviations.begin(),
+                               deviations.begin() + shapeMesh.positions.size() / 3);
+      const std::string encoded =
+          l1::qmesh::Encode(shapeMesh, l1::qmesh::kDefaultPositionBits, true);
+      std::ofstream ofs(std::filesystem::u8path(deviationMeshFileUtf8),
+                        std::ios::binary | std::ios::trunc);
+      if (!ofs.write(encoded.data(), static_cast<std::streamsize>(encoded.size())))
+        return ERROR_EXPORT_FAILED;
+    }
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Mass properties
+// ---------------------------------------------------------------------------
+
+constexpr double kDefaultMassTolerance = 1.0e-3;
+
+// `tolerance` 0 integrates the B-rep faces exactly. Otherwise a topology
+// copy (the registry shape may be meshed or read concurrently) is meshed
+// with deflection tolerance x diagonal and the triangles are integrated;
+// a chord never strays further than the deflection from its face, which
+// bounds the volume error by about deflection x area.
+int ComputeMassProperties(OcctKernelImpl* impl, int shapeId, double tolerance, bool parallelMesh,
+                          MassProperties* out) {
+  TopoDS_Shape shape;
+  std::shared_ptr<const ShapeBounds> shapeBounds;
+  if (!impl->Registry().FindWithBounds(shapeId, &shape, &shapeBounds))
+    return ERROR_SHAPE_NOT_FOUND;
+
+  const bool fast = tolerance > 0.0;
+  if (fast) {
+    MeshOptions mesh = DefaultMeshOptions();
+    mesh.relativeDeflection = tolerance;
+    mesh.parallel           = parallelMesh ? 1 : 0;
+    const Bnd_Box& bounds = shapeBounds->aabb;
+    if (bounds.IsVoid()) {
+      *out = MassProperties{};  // nothing to integrate, e.g. an empty delta
+      out->tolerance = tolerance;
+      return ERROR_OK;
+    }
+    TopoDS_Shape meshed;
+    const int meshError =
+        MeshShape(BRepBuilderAPI_Copy(shape, Standard_False, Standard_False).Shape(), bounds,
+                  mesh, &meshed, nullptr, Message_ProgressRange());
+    if (meshError != ERROR_OK) return meshError;
+    shape = meshed;
+  }
+
+  GProp_GProps volume;
+  GProp_GProps surface;
+  BRepGProp::VolumeProperties(shape, volume, Standard_False, Standard_False, fast);
+  BRepGProp::SurfaceProperties(shape, surface, Standard_False, fast);
+
+  *out = MassProperties{};
+  out->volume    = volume.Mass();
+  out->area      = surface.Mass();
+  out->tolerance = tolerance;
+  const GProp_GProps& centre = std::fabs(out->volume) > 0.0 ? volume : surface;
+  if (centre.Mass() != 0.0) {
+    const gp_Pnt c = centre.CentreOfMass();
+    out->centroid[0] = c.X();
+    out->centroid[1] = c.Y();
+    out->centroid[2] = c.Z();
+  }
+  return ERROR_OK;
+}
+
+// One shape per ParallelFor item; with a single thread the faces of each
+// shape are meshed in parallel instead. Each result is cached on its
+// registry entry.
+void RunComputeMassProperties(OcctKernelImpl* impl, const int* shapeIds, int shapeCount,
+                              const MassPropertiesOptions& opt, MassProperties* outProps) {
+  const double tolerance =
+      opt.mode == MASS_FAST ? (opt.tolerance > 0.0 ? opt.tolerance : kDefaultMassTolerance) : 0.0;
+  const bool parallelMesh = l1::ParallelThreadCount(shapeCount, opt.threadCount) == 1;
+
+  l1::ParallelFor(shapeCount, opt.threadCount, [&](int i, int) {
+    MassProperties& props = outProps[i];
+    if (auto cached = impl->Registry().FindMass(shapeIds[i], tolerance)) {
+      props         = *cached;
+      props.shapeId = shapeIds[i];
+      props.cached  = 1;
+      return;
+    }
+    int errorCode = ERROR_OK;
+    try {
+      errorCode = ComputeMassProperties(impl, shapeIds[i], tolerance, parallelMesh, &props);
+    } catch (...) {
+      errorCode = MapExceptionToError();
+    }
+    if (errorCode == ERROR_OK) impl->Registry().StoreMass(
+        shapeIds[i], std::make_shared<const MassProperties>(props));
+    else props = MassProperties{};
+    props.shapeId   = shapeIds[i];
+    props.errorCode = errorCode;
+  });
+}
+
+// ---------------------------------------------------------------------------
+// Planar sections
+// ---------------------------------------------------------------------------
+
+constexpr double kDefaultSectionChordTolerance = 0.01;
+
+// One section edge in its plane's (u,v) frame, in curve parameter order
+// between the vertices v0 and v1 (indices into the plane's vertex map).
+struct SectionEdge {
+  int                           v0 = 0;
+  int                           v1 = 0;
+  std::vector<Path2DSegmentDto> segments;
+  bool                          used = false;
+};
+
+Path2DPointDto ToSectionUv(const gp_Pnt& p, const gp_Ax3& frame) {
+  const gp_Vec d(frame.Location(), p);
+  return Path2DPointDto{d.Dot(gp_Vec(frame.XDirection())), d.Dot(gp_Vec(frame.YDirection()))};
+}
+
+Path2DSegmentDto MakeSectionLine(const Path2DPointDto& from, const Path2DPointDto& to) {
+  Path2DSegmentDto seg{};
+  seg.from = from;
+  seg.to   = to;
+  seg.type = PATH_SEGMENT_LINE;
+  return seg;
+}
+
+void ReverseSectionSegments(std::vector<Path2DSegmentDto>* segments) {
+  std::reverse(segments->begin(), segments->end());
+  for (Path2DSegmentDto& seg : *segments) {
+    std::swap(seg.from, seg.to);
+    if (seg.type == PATH_SEGMENT_ARC)
+      seg.arcDirection = seg.arcDirection == ARC_DIR_CW ? ARC_DIR_CCW : ARC_DIR_CW;
+  }
+}
+
+// Lines and circles in the plane map to one LINE / ARC (a full circle to
+// two arcs, as from == to is not a valid arc); anything else becomes LINE
+// chords within `chordTolerance`. Ends are the vertex points, so edges
+// sharing a vertex meet exactly in (u,v).
+bool ConvertSectionEdge(const TopoDS_Edge& edge, const gp_Ax3& frame, double chordTolerance,
+                        TopTools_IndexedMapOfShape* vertices, SectionEdge* out) {
+  TopoDS_Vertex first, last;
+  TopExp::Vertices(edge, first, last);
+  if (first.IsNull() || last.IsNull()) return false;
+  out->v0 = vertices->Add(first) - 1;
+  out->v1 = vertices->Add(last) - 1;
+
+  BRepAdaptor_Curve curve(edge);
+  const double t0 = curve.FirstParameter();
+  const double t1 = curve.LastParameter();
+  const Path2DPointDto from = ToSectionUv(BRep_Tool::Pnt(first), frame);
+  const Path2DPointDto to   = ToSectionUv(BRep_Tool::Pnt(last), frame);
+
+  switch (curve.GetType()) {
+    case GeomAbs_Line:
+      out->segments.push_back(MakeSectionLine(from, to));
+      return true;
+    case GeomAbs_Circle: {
+      const gp_Circ circle = curve.Circle();
+      if (circle.Axis().Direction().IsParallel(frame.Direction(), Precision::Angular())) {
+        Path2DSegmentDto arc{};
+        arc.center       = ToSectionUv(circle.Location(), frame);
+        arc.type         = PATH_SEGMENT_ARC;
+        arc.arcDirection = circle.Axis().Direction().Dot(frame.Direction()) > 0.0 ? ARC_DIR_CCW
+                                                                                  : ARC_DIR_CW;
+        if (first.IsSame(last)) {
+          const Path2DPointDto mid = ToSectionUv(curve.Value(0.5 * (t0 + t1)), frame);
+          arc.from = from;
+          arc.to   = mid;
+          out->segments.push_back(arc);
+          arc.from = mid;
+          arc.to   = to;
+        } else {
+          arc.from = from;
+          arc.to   = to;
+        }
+        out->segments.push_back(arc);
+        return true;
+      }
+      break;  // tilted circle: only possible within tolerance; chord it
+    }
+    default:
+      break;
+  }
+
+  GCPnts_QuasiUniformDeflection points(curve, chordTolerance, t0, t1);
+  if (!points.IsDone() || points.NbPoints() < 2) {
+    out->segments.push_back(MakeSectionLine(from, to));
+    return true;
+  }
+  Path2DPointDto previous = from;
+  for (int i = 2; i <= points.NbPoints(); ++i) {
+    const Path2DPointDto next =
+        i == points.NbPoints() ? to : ToSectionUv(points.Value(i), frame);
+    out->segments.push_back(MakeSectionLine(previous, next));
+    previous = next;
+  }
+  return true;
+}
+
+// Orders the edges into chains through shared vertices, flipping edges as
+// needed. Open chains are walked from an end so they come out in one piece.
+void ChainSectionEdges(std::vector<SectionEdge>& edges, int vertexCount,
+                       std::vector<Path2DSegmentDto>* outSegments, SectionPlane* outPlane) {
+  std::vector<std::vector<int>> incident(static_cast<std::size_t>(vertexCount));
+  for (int e = 0; e < static_cast<int>(edges.size()); ++e) {
+    incident[edges[e].v0].push_back(e);
+    if (edges[e].v1 != edges[e].v0) incident[edges[e].v1].push_back(e);
+  }
+
+  auto nextEdge = [&](int vertex) {
+    for (int e : incident[vertex])
+      if (!edges[e].used) return e;
+    return -1;
+  };
+  auto walk = [&](int start) {
+    int vertex = start;
+    for (int e = nextEdge(vertex); e >= 0; e = nextEdge(vertex)) {
+      SectionEdge& edge = edges[e];
+      edge.used = true;
+      if (edge.v0 != vertex) ReverseSectionSegments(&edge.segments);
+      vertex = edge.v0 == vertex ? edge.v1 : edge.v0;
+      outSegments->insert(outSegments->end(), edge.segments.begin(), edge.segments.end());
+    }
+    ++outPlane->chainCount;
+    if (vertex != start) outPlane->closed = 0;
+  };
+
+  outPlane->closed = edges.empty() ? 0 : 1;
+  for (int v = 0; v < vertexCount; ++v)
+    if (incident[v].size() % 2 == 1 && nextEdge(v) >= 0) walk(v);
+  for (int v = 0; v < vertexCount; ++v)
+    while (nextEdge(v) >= 0) walk(v);
+}
+
+// `frame` is the plane's axis system. Planes outside the shape's bounds
+// skip the intersection entirely. The section leaves the registry shape
+// untouched, so planes can be cut concurrently.
+int SectionAtPlane(const TopoDS_Shape& shape, const Bnd_Box& bounds, const gp_Ax3& frame,
+                   double chordTolerance, bool parallel,
+                   std::vector<Path2DSegmentDto>* outSegments, SectionPlane* outPlane) {
+  const gp_Pln plane(frame);
+  if (bounds.IsVoid() || bounds.IsOut(plane)) return ERROR_OK;
+
+  BRepAlgoAPI_Section section(shape, plane, Standard_False);
+  section.SetNonDestructive(Standard_True);
+  section.SetRunParallel(parallel ? Standard_True : Standard_False);
+  section.Approximation(Standard_False);
+  section.ComputePCurveOn1(Standard_False);
+  section.Build();
+  if (!section.IsDone() || section.HasErrors()) return ERROR_BOOLEAN_FAILED;
+
+  TopTools_IndexedMapOfShape vertices;
+  std::vector<SectionEdge> edges;
+  for (TopExp_Explorer it(section.Shape(), TopAbs_EDGE); it.More(); it.Next()) {
+    const TopoDS_Edge& edge = TopoDS::Edge(it.Current());
+    if (BRep_Tool::Degenerated(edge)) continue;
+    SectionEdge converted;
+    if (ConvertSectionEdge(edge, frame, chordTolerance, &vertices, &converted))
+      edges.push_back(std::move(converted));
+  }
+  ChainSectionEdges(edges, vertices.Extent(), outSegments, outPlane);
+  return ERROR_OK;
+}
+
+// One plane per ParallelFor item; the segments are then concatenated in
+// plane order.
+int RunSectionShape(OcctKernelImpl* impl, int shapeId, const SectionOptions& opt,
+                    SectionPlane* outPlanes, std::vector<Path2DSegmentDto>* outSegments) {
+  TopoDS_Shape shape;
+  std::shared_ptr<const ShapeBounds> shapeBounds;
+  if (!impl->Registry().FindWithBounds(shapeId, &shape, &shapeBounds))
+    return ERROR_SHAPE_NOT_FOUND;
+  const Bnd_Box& bounds = shapeBounds->aabb;
+
+  const double chordTolerance =
+      opt.chordTolerance > 0.0 ? opt.chordTolerance : kDefaultSectionChordTolerance;
+  const gp_Ax3 base(gp_Pnt(opt.axis.origin[0], opt.axis.origin[1], opt.axis.origin[2]),
+                    gp_Dir(opt.axis.dir[0], opt.axis.dir[1], opt.axis.dir[2]),
+                    gp_Dir(opt.axis.xdir[0], opt.axis.xdir[1], opt.axis.xdir[2]));
+  const int planeCount = opt.planeCount;
+  const bool parallelSection = l1::ParallelThreadCount(planeCount, opt.threadCount) == 1;
+
+  std::vector<std::vector<Path2DSegmentDto>> perPlane(static_cast<std::size_t>(planeCount));
+  l1::ParallelFor(planeCount, opt.threadCount, [&](int k, int) {
+    SectionPlane& plane = outPlanes[k];
+    plane        = SectionPlane{};
+    plane.offset = k * opt.spacing;
+    const gp_Ax3 frame = base.Translated(gp_Vec(base.Direction()) * plane.offset);
+    int errorCode = ERROR_OK;
+    try {
+      errorCode = SectionAtPlane(shape, bounds, frame, chordTolerance, parallelSection,
+                                 &perPlane[k], &plane);
+    } catch (...) {
+      errorCode = MapExceptionToError();
+    }
+    if (errorCode != ERROR_OK) {
+      perPlane[k].clear();
+      plane.chainCount = 0;
+      plane.closed     = 0;
+    }
+    plane.errorCode    = errorCode;
+    plane.segmentCount = static_cast<int>(perPlane[k].size());
+  });
+
+  outSegments->clear();
+  for (int k = 0; k < planeCount; ++k) {
+    outPlanes[k].firstSegment = static_cast<int>(outSegments->size());
+    outSegments->insert(outSegments->end(), perPlane[k].begin(), perPlane[k].end());
+  }
+  return ERROR_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Clearance
+// ---------------------------------------------------------------------------
+
+// Boundaries closer than this count as touching, unless the shapes' own
+// edge/vertex tolerances are wider.
+constexpr double kMinContactGap = 1.0e-7;
+
+ShapeBounds TranslateBounds(const ShapeBounds& bounds, const gp_Vec& offset) {
+  gp_Trsf shift;
+  shift.SetTranslation(offset);
+  ShapeBounds moved;
+  moved.aabb = bounds.aabb.IsVoid() ? bounds.aabb : bounds.aabb.Transformed(shift);
+  moved.obb  = bounds.obb;
+  if (!moved.obb.IsVoid()) moved.obb.SetCenter(gp_Pnt(bounds.obb.Center()).Translated(offset));
+  return moved;
+}
+
+double MaxBoundaryTolerance(const TopoDS_Shape& shape) {
+  double tolerance = 0.0;
+  for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next())
+    tolerance = std::max(tolerance, BRep_Tool::Tolerance(TopoDS::Edge(exp.Current())));
+  for (TopExp_Explorer exp(shape, TopAbs_VERTEX); exp.More(); exp.Next())
+    tolerance = std::max(tolerance, BRep_Tool::Tolerance(TopoDS::Vertex(exp.Current())));
+  return tolerance;
+}
+
+// Axis-aligned box as plain numbers, so a placement shifts it with three
+// additions instead of a Bnd_Box transform.
+struct PlainBox {
+  double lo[3];
+  double hi[3];
+};
+
+// Gap between `a` and `b` shifted by `shift` (0 when they overlap).
+double BoxGap(const PlainBox& a, const PlainBox& b, const double shift[3]) {
+  double squared = 0.0;
+  for (int k = 0; k < 3; ++k) {
+    const double d = std::max(a.lo[k] - (b.hi[k] + shift[k]), (b.lo[k] + shift[k]) - a.hi[k]);
+    if (d > 0.0) squared += d * d;
+  }
+  return std::sqrt(squared);
+}
+
+// Box tree over the faces of one shape with one face per leaf. Built once
+// per L1_QueryClearance call and only read by the placements.
+class FaceBoxTree {
+ public:
+  struct Node {
+    PlainBox box;
+    int      left  = -1;
+    int      right = -1;
+    int      face  = -1;  // leaf: index into the face list
+  };
+
+  explicit FaceBoxTree(const std::vector<PlainBox>& faceBoxes) : boxes_(faceBoxes) {
+    if (boxes_.empty()) return;
+    std::vector<int> order(boxes_.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    nodes_.reserve(2 * order.size());
+    Build(order, 0, static_cast<int>(order.size()));
+  }
+
+  static constexpr int kRoot = 0;
+
+  bool        Empty() const { return nodes_.empty(); }
+  const Node& At(int node) const { return nodes_[node]; }
+
+ private:
+  // Splits at the median of the box centres along the widest axis.
+  int Build(std::vector<int>& order, int begin, int end) {
+    const int index = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    PlainBox box = boxes_[order[begin]];
+    for (int i = begin + 1; i < end; ++i)
+      for (int k = 0; k < 3; ++k) {
+        box.lo[k] = std::min(box.lo[k], boxes_[order[i]].lo[k]);
+        box.hi[k] = std::max(box.hi[k], boxes_[order[i]].hi[k]);
+      }
+    nodes_[index].box = box;
+    if (end - begin == 1) {
+      nodes_[index].face = order[begin];
+      return index;
+    }
+
+    int axis = 0;
+    for (int k = 1; k < 3; ++k)
+      if (box.hi[k] - box.lo[k] > box.hi[axis] - box.lo[axis]) axis = k;
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                     [this, axis](int a, int b) {
+                       return boxes_[a].lo[axis] + boxes_[a].hi[axis] <
+                              boxes_[b].lo[axis] + boxes_[b].hi[axis];
+                     });
+    const int left  = Build(order, begin, mid);
+    const int right = Build(order, mid, end);
+    nodes_[index].left  = left;
+    nodes_[index].right = right;
+    return index;
+  }
+
+  std::vector<PlainBox> boxes_;
+  std::vector<Node>     nodes_;
+};
+
+// The faces of one clearance operand with their tree.
+struct ClearanceFaces {
+  std::vector<TopoDS_Face> faces;
+  FaceBoxTree              tree;
+
+  explicit ClearanceFaces(const TopoDS_Shape& shape) : tree(CollectBoxes(shape, &faces)) {}
+
+ private:
+  // Boxes from the exact geometry (not a triangulation, which may lie
+  // inside it) enlarged by the face tolerance, so pruning never drops the
+  // closest pair.
+  static std::vector<PlainBox> CollectBoxes(const TopoDS_Shape& shape,
+                                            std::vector<TopoDS_Face>* faces) {
+    std::vector<PlainBox> boxes;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+      Bnd_Box box;
+      BRepBndLib::Add(exp.Current(), box, Standard_False);
+      if (box.IsVoid()) continue;
+      PlainBox plain;
+      box.Get(plain.lo[0], plain.lo[1], plain.lo[2], plain.hi[0], plain.hi[1], plain.hi[2]);
+      boxes.push_back(plain);
+      faces->push_back(TopoDS::Face(exp.Current()));
+    }
+    return boxes;
+  }
+};
+
+// Inputs of one L1_QueryClearance call shared by every placement.
+struct ClearanceInputs {
+  TopoDS_Shape                    shape;
+  ShapeBounds                     shapeBounds;
+  std::unique_ptr<ClearanceFaces> shapeFaces;
+  TopoDS_Shape                    other;
+  ShapeBounds                     otherBounds;
+  std::unique_ptr<ClearanceFaces> otherFaces;
+  double                          maxDistance = 0.0;  // 0: always measure
+  double                          contactGap  = kMinContactGap;
+};
+
+// True when `inner` (bounds innerBounds) lies inside the solid `outer`.
+// Callers have already established that the boundaries do not touch, so
+// one vertex classifies the whole shape.
+bool IsInsideSolid(const TopoDS_Shape& outer, const ShapeBounds& outerBounds,
+                   const TopoDS_Shape& inner, const ShapeBounds& innerBounds) {
+  if (!IsBoxInside(innerBounds.aabb, outerBounds.aabb)) return false;
+  TopExp_Explorer vertexExp(inner, TopAbs_VERTEX);
+  if (!vertexExp.More()) return false;
+  BRepClass3d_SolidClassifier classifier(outer, BRep_Tool::Pnt(TopoDS::Vertex(vertexExp.Current())),
+                                         kGeomTol);
+  return classifier.State() == TopAbs_IN;
+}
+
+// Cheapest test first: the cached boxes answer placements that are far
+// apart in microseconds. The rest walks both face trees nearest pair first,
+// with only the other shape's boxes shifted; exact face/face distances are
+// taken for leaf pairs whose boxes are closer than the best distance so far,
+// and the walk stops at the first pair within the contact gap.
+void QueryPlacementClearance(const ClearanceInputs& in, const gp_Vec& offset,
+                             ClearanceResult* out) {
+  const ShapeBounds otherBounds = TranslateBounds(in.otherBounds, offset);
+  if (in.shapeBounds.aabb.IsVoid() || otherBounds.aabb.IsVoid() ||
+      in.shapeFaces->tree.Empty() || in.otherFaces->tree.Empty()) {
+    out->state = CLEARANCE_FAR;  // an empty shape touches nothing
+    return;
+  }
+
+  const double boxGap = in.shapeBounds.aabb.Distance(otherBounds.aabb);
+  if (in.maxDistance > 0.0) {
+    bool far = boxGap > in.maxDistance;
+    if (!far && !in.shapeBounds.obb.IsVoid() && !otherBounds.obb.IsVoid()) {
+      Bnd_OBB reach = in.shapeBounds.obb;
+      reach.Enlarge(in.maxDistance);
+      far = reach.IsOut(otherBounds.obb);
+    }
+    if (far) {
+      out->state    = CLEARANCE_FAR;
+      out->distance = boxGap;
+      return;
+    }
+  }
+
+  const FaceBoxTree& treeA = in.shapeFaces->tree;
+  const FaceBoxTree& treeB = in.otherFaces->tree;
+  const double shift[3] = {offset.X(), offset.Y(), offset.Z()};
+  gp_Trsf moveTrsf;
+  moveTrsf.SetTranslation(offset);
+  const TopLoc_Location location(moveTrsf);
+
+  struct Pair {
+    double gap;
+    int    a;
+    int    b;
+    bool operator<(const Pair& other) const { return gap > other.gap; }  // nearest on top
+  };
+  std::priority_queue<Pair> queue;
+  queue.push({BoxGap(treeA.At(FaceBoxTree::kRoot).box, treeB.At(FaceBoxTree::kRoot).box, shift),
+              FaceBoxTree::kRoot, FaceBoxTree::kRoot});
+  const double limit = in.maxDistance > 0.0 ? in.maxDistance
+                                            : std::numeric_limits<double>::infinity();
+  double best = std::numeric_limits<double>::infinity();
+  gp_Pnt bestA, bestB;
+  while (!queue.empty()) {
+    const Pair pair = queue.top();
+    if (pair.gap >= best || pair.gap > limit) break;
+    queue.pop();
+
+    const FaceBoxTree::Node& a = treeA.At(pair.a);
+    const FaceBoxTree::Node& b = treeB.At(pair.b);
+    if (a.face >= 0 && b.face >= 0) {
+      BRepExtrema_DistShapeShape distance(in.shapeFaces->faces[a.face],
+                                          in.otherFaces->faces[b.face].Moved(location));
+      if (!distance.IsDone() || distance.NbSolution() < 1) {
+        out->errorCode = ERROR_OCCT_EXCEPTION;
+        return;
+      }
+      if (distance.Value() < best) {
+        best  = distance.Value();
+        bestA = distance.PointOnShape1(1);
+        bestB = distance.PointOnShape2(1);
+      }
+      if (best <= in.contactGap) break;
+      continue;
+    }
+
+    // Descend into the larger box, or the only inner node.
+    auto extent = [](const PlainBox& box) {
+      return (box.hi[0] - box.lo[0]) + (box.hi[1] - box.lo[1]) + (box.hi[2] - box.lo[2]);
+    };
+    const bool splitA = b.face >= 0 || (a.face < 0 && extent(a.box) >= extent(b.box));
+    if (splitA) {
+      for (int child : {a.left, a.right})
+        queue.push({BoxGap(treeA.At(child).box, b.box, shift), child, pair.b});
+    } else {
+      for (int child : {b.left, b.right})
+        queue.push({BoxGap(a.box, treeB.At(child).box, shift), pair.a, child});
+    }
+  }
+
+  if (best <= in.contactGap) {
+    out->state = CLEARANCE_CONTACT;
+    out->pointA[0] = bestA.X(); out->pointA[1] = bestA.Y(); out->pointA[2] = bestA.Z();
+    out->pointB[0] = bestB.X(); out->pointB[1] = bestB.Y(); out->pointB[2] = bestB.Z();
+    return;
+  }
+
+  const TopoDS_Shape moved = in.other.Moved(location);
+  if (IsInsideSolid(in.shape, in.shapeBounds, moved, otherBounds) ||
+      IsInsideSolid(moved, otherBounds, in.shape, in.shapeBounds)) {
+    out->state = CLEARANCE_CONTAINED;
+    return;
+  }
+  if (best > limit) {
+    out->state    = CLEARANCE_FAR;  // no face pair within maxDistance
+    out->distance = std::max(boxGap, queue.empty() ? best : std::min(best, queue.top().gap));
+    return;
+  }
+  out->state    = CLEARANCE_CLEAR;
+  out->distance = best;
+  out->pointA[0] = bestA.X(); out->pointA[1] = bestA.Y(); out->pointA[2] = bestA.Z();
+  out->pointB[0] = bestB.X(); out->pointB[1] = bestB.Y(); out->pointB[2] = bestB.Z();
+}
+
+// One placement per ParallelFor item. Every placement reads the same two
+// registry shapes and face trees; only the offset differs.
+int RunQueryClearance(OcctKernelImpl* impl, int shapeId, int otherId, const double* offsets,
+                      int placementCount, const ClearanceOptions& opt,
+                      ClearanceResult* outResults) {
+  ClearanceInputs in;
+  std::shared_ptr<const ShapeBounds> shapeBounds, otherBounds;
+  if (!impl->Registry().FindWithBounds(shapeId, &in.shape, &shapeBounds) ||
+      !impl->Registry().FindWithBounds(otherId, &in.other, &otherBounds))
+    return ERROR_SHAPE_NOT_FOUND;
+  in.shapeBounds = *shapeBounds;
+  in.otherBounds = *otherBounds;
+  in.shapeFaces  = std::make_unique<ClearanceFaces>(in.shape);
+  in.otherFaces  = std::make_unique<ClearanceFaces>(in.other);
+  in.maxDistance = std::max(opt.maxDistance, 0.0);
+  in.contactGap  = std::max(kMinContactGap,
+                            MaxBoundaryTolerance(in.shape) + MaxBoundaryTolerance(in.other));
+
+  using Clock = std::chrono::steady_clock;
+  l1::ParallelFor(placementCount, opt.threadCount, [&](int i, int) {
+    const auto start = Clock::now();
+    ClearanceResult& result = outResults[i];
+    result = ClearanceResult{};
+    const gp_Vec offset = offsets ? gp_Vec(offsets[i * 3], offsets[i * 3 + 1], offsets[i * 3 + 2])
+                                  : gp_Vec(0.0, 0.0, 0.0);
+    try {
+      QueryPlacementClearance(in, offset, &result);
+    } catch (...) {
+      result = ClearanceResult{};
+      result.errorCode = MapExceptionToError();
+    }
+    result.queryMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  });
+  return ERROR_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Operation bodies shared by the blocking and async entry points
+// ---------------------------------------------------------------------------
+
+int RunCreateStock(OcctKernelImpl* impl, const StockDto* dto, int* outStockId) {
+  try {
+    gp_Pnt origin(dto->axis.origin[0], dto->axis.origin[1], dto->axis.origin[2]);
+    gp_Dir dir   (dto->axis.dir[0],    dto->axis.dir[1],    dto->axis.dir[2]);
+    gp_Dir xdir  (dto->axis.xdir[0],   dto->axis.xdir[1],   dto->axis.xdir[2]);
+    gp_Ax2 axis(origin, dir, xdir);
+
+    TopoDS_Shape shape;
+    std::shared_ptr<const TurnSection> section;
+    switch (dto->type) {
+      case STOCK_BOX:
+        shape = BRepPrimAPI_MakeBox(axis, dto->p1, dto->p2, dto->p3).Shape();
+        break;
+      case STOCK_CYLINDER:
+        shape   = BRepPrimAPI_MakeCylinder(axis, dto->p1, dto->p2).Shape();
+        section = MakeStockTurnSection(axis, dto->p1, dto->p2);
+        break;
+      default:
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    *outStockId = section ? impl->Registry().AddSection(section, shape)
+                          : impl->Registry().Add(shape);
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int RunApplyMillHole(OcctKernelImpl* impl, int stockId, const MillHoleFeatureDto& dto,
+                     OperationResult* outResult, const Message_ProgressRange& range) {
+  try {
+    gp_Pnt origin(dto.axis.origin[0], dto.axis.origin[1], dto.axis.origin[2]);
+    gp_Dir dir   (dto.axis.dir[0],    dto.axis.dir[1],    dto.axis.dir[2]);
+    const TopoDS_Shape tool =
+        BRepPrimAPI_MakeCylinder(gp_Ax2(origin, dir), dto.radius, dto.depth).Shape();
+    return ApplyBooleanOp(impl, stockId, tool, outResult, range);
+  } catch (...) {
+    outResult->errorCode = ERROR_OCCT_EXCEPTION;
+    return MapExceptionToError();
+  }
+}
+
+int RunApplyPocketRect(OcctKernelImpl* impl, int stockId, const PocketRectFeatureDto& dto,
+                       OperationResult* outResult, const Message_ProgressRange& range) {
+  try {
+    gp_Pnt origin(dto.axis.origin[0], dto.axis.origin[1], dto.axis.origin[2]);
+    gp_Dir dir   (dto.axis.dir[0],    dto.axis.dir[1],    dto.axis.dir[2]);
+    gp_Dir xdir  (dto.axis.xdir[0],   dto.axis.xdir[1],   dto.axis.xdir[2]);
+    gp_Dir ydir = dir.Crossed(xdir);
+    gp_Pnt corner = origin.Translated(
+        gp_Vec(xdir) * (-0.5 * dto.width) + gp_Vec(ydir) * (-0.5 * dto.height));
+    const TopoDS_Shape tool =
+        BRepPrimAPI_MakeBox(gp_Ax2(corner, dir, xdir),
+                            dto.width, dto.height, dto.depth).Shape();
+    return ApplyBooleanOp(impl, stockId, tool, outResult, range);
+  } catch (...) {
+    outResult->errorCode = ERROR_OCCT_EXCEPTION;
+    return MapExceptionToError();
+  }
+}
+
+// Shared by TURN_OD and TURN_ID: both revolve the profile about `axis`.
+int RunApplyTurn(OcctKernelImpl* impl, int stockId, const AxisDto& axis,
+                 const Path2DSegmentDto* segments, int segmentCount, int closed,
+                 OperationResult* outResult, const Message_ProgressRange& range) {
+  try {
+    const PathToolInput in{PathTool::kTurn, axis, segments, segmentCount, closed, 0.0, 0.0};
+    int sectionError = ERROR_OK;
+    if (TryApplyTurnSection(impl, stockId, axis, segments, segmentCount, closed,
+                            outResult, &sectionError, range)) {
+      impl->Tools().Discard(PathToolKey(in));  // a pipelined job may have built the 3D tool
+      return sectionError;
+    }
+
+    const ToolCache::Build build = TakePathTool(impl, in);
+    if (build.errorCode != ERROR_OK) {
+      outResult->errorCode = build.errorCode;
+      return build.errorCode;
+    }
+    return ApplyBooleanOp(impl, stockId, build.tool, outResult, range);
+  } catch (...) {
+    outResult->errorCode = ERROR_OCCT_EXCEPTION;
+    return MapExceptionToError();
+  }
+}
+
+int RunApplyMillContour(OcctKernelImpl* impl, int stockId, const AxisDto& axis,
+                        const Path2DSegmentDto* segments, int segmentCount, int closed,
+                        double depth,
+                        OperationResult* outResult, const Message_ProgressRange& range) {
+  try {
+    const ToolCache::Build build = TakePathTool(
+        impl, {PathTool::kMillContour, axis, segments, segmentCount, closed, depth, 0.0});
+    if (build.errorCode != ERROR_OK) {
+      outResult->errorCode = build.errorCode;
+      return build.errorCode;
+    }
+    return ApplyBooleanOp(impl, stockId, build.tool, outResult, range);
+  } catch (...) {
+    outResult->errorCode = ERROR_OCCT_EXCEPTION;
+    return MapExceptionToError();
+  }
+}
+
+int RunApplyMillSlot(OcctKernelImpl* impl, int stockId, const AxisDto& axis,
+                     const Path2DSegmentDto* segments, int segmentCount,
+                     double toolRadius, double depth,
+                     OperationResult* outResult, const Message_ProgressRange& range) {
+  try {
+    const ToolCache::Build build = TakePathTool(
+        impl, {PathTool::kMillSlot, axis, segments, segmentCount, 0, depth, toolRadius});
+    if (build.errorCode != ERROR_OK) {
+      outResult->errorCode = build.errorCode;
+      return build.errorCode;
+    }
+    return ApplyBooleanOp(impl, stockId, build.tool, outResult, range);
+  } catch (...) {
+    outResult->errorCode = ERROR_OCCT_EXCEPTION;
+    return MapExceptionToError();
+  }
+}
+
+int ReadStepShape(const char* filePathUtf8, TopoDS_Shape* outShape) {
+  std::lock_guard<std::mutex> stepLock(gStepSessionMutex);
+  STEPControl_Reader reader;
+  if (reader.ReadFile(filePathUtf8) != IFSelect_RetDone)
+    return ERROR_IMPORT_FAILED;
+
+  if (!reader.TransferRoots())
+    return ERROR_IMPORT_FAILED;
+
+  *outShape = reader.OneShape();
+  return outShape->IsNull() ? ERROR_IMPORT_FAILED : ERROR_OK;
+}
+
+int RunImportStep(OcctKernelImpl* impl, const char* filePathUtf8, int* outShapeId) {
+  try {
+    TopoDS_Shape shape;
+    const int readError = ReadStepShape(filePathUtf8, &shape);
+    if (readError != ERROR_OK) return readError;
+
+    *outShapeId = impl->Registry().Add(shape);
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+// Customer STEP files carry loose tolerances, sliver edges and split faces
+// that every later boolean would otherwise pay for; this runs the requested
+// repairs once, on a shape nobody else holds yet.
+int PrepareImportedShape(const ImportOptions& opt, TopoDS_Shape* shape) {
+  const double precision = opt.tolerance > 0.0 ? opt.tolerance : Precision::Confusion();
+  if (opt.heal) {
+    Handle(ShapeFix_Shape) fixer = new ShapeFix_Shape(*shape);
+    fixer->SetPrecision(precision);
+    if (opt.tolerance > 0.0) fixer->SetMaxTolerance(opt.tolerance);
+    fixer->Perform();
+
+    ShapeFix_Wireframe wireframe(fixer->Shape());
+    wireframe.SetPrecision(precision);
+    wireframe.ModeDropSmallEdges() = Standard_True;
+    wireframe.FixSmallEdges();
+    wireframe.FixWireGaps();
+    *shape = wireframe.Shape();
+  }
+
+  if (opt.extractSolids) {
+    TopTools_IndexedMapOfShape solids;
+    TopExp::MapShapes(*shape, TopAbs_SOLID, solids);
+    if (solids.IsEmpty()) return ERROR_IMPORT_FAILED;
+    if (solids.Extent() == 1) {
+      *shape = solids(1);
+    } else {
+      TopoDS_Compound compound = MakeEmptyCompound();
+      BRep_Builder builder;
+      for (int i = 1; i <= solids.Extent(); ++i) builder.Add(compound, solids(i));
+      *shape = compound;
+    }
+  }
+
+  if (opt.tolerance > 0.0)
+    ShapeFix_ShapeTolerance().LimitTolerance(*shape, Precision::Confusion(), opt.tolerance);
+  if (opt.unifySameDomain) *shape = CompactTopology(*shape);
+  return shape->IsNull() ? ERROR_IMPORT_FAILED : ERROR_OK;
+}
+
+// Prepared STEP imports shared by every kernel of the process, most recently
+// used first. Entries are never handed out directly: each import registers a
+// topology copy, so meshing one kernel's shape cannot write triangulations
+// onto faces another kernel is cutting.
+class ImportCache {
+ public:
+  struct Prepared {
+    TopoDS_Shape                       shape;
+    std::shared_ptr<const ShapeBounds> bounds;
+  };
+
+  // Returns the entry for `key`, calling load(Prepared*) -> ErrorCode when
+  // it is missing. A caller that misses while another one is loading the
+  // same key waits for that load instead of reading the file again. Failed
+  // loads are reported to everyone waiting on them but not kept.
+  template <typename Load>
+  int Get(const std::string& key, Load&& load, Prepared* out) {
+    std::shared_ptr<Slot> slot;
+    bool loading = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::find_if(entries_.begin(), entries_.end(),
+                             [&](const auto& entry) { return entry.first == key; });
+      if (it != entries_.end()) {
+        entries_.splice(entries_.begin(), entries_, it);
+        slot = entries_.front().second;
+      } else {
+        slot = std::make_shared<Slot>();
+        slot->future = slot->promise.get_future().share();
+        entries_.emplace_front(key, slot);
+        while (entries_.size() > kMaxEntries) entries_.pop_back();
+        loading = true;
+      }
+    }
+
+    if (loading) {
+      Outcome outcome;
+      try {
+        outcome.errorCode = load(&outcome.prepared);
+      } catch (...) {
+        outcome.errorCode = MapExceptionToError();
+      }
+      if (outcome.errorCode != ERROR_OK) Forget(key, slot);
+      slot->promise.set_value(std::move(outcome));
+    }
+
+    const Outcome& outcome = slot->future.get();
+    if (outcome.errorCode == ERROR_OK) *out = outcome.prepared;
+    return outcome.errorCode;
+  }
+
+ private:
+  static constexpr std::size_t kMaxEntries = 16;
+
+  struct Outcome {
+    int      errorCode = ERROR_OK;
+    Prepared prepared;
+  };
+
+  struct Slot {
+    std::promise<Outcome>       promise;
+    std::shared_future<Outcome> future;
+  };
+
+  void Forget(const std::string& key, const std::shared_ptr<Slot>& slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.remove_if([&](const auto& entry) {
+      return entry.first == key && entry.second == slot;
+    });
+  }
+
+  std::mutex                                                mutex_;
+  std::list<std::pair<std::string, std::shared_ptr<Slot>>> entries_;
+};
+
+ImportCache& SharedImportCache() {
+  static ImportCache cache;
+  return cache;
+}
+
+// Empty when the file cannot be stat'ed (the read then reports the error).
+// Size and modification time make an edited file miss the cache.
+std::string ImportCacheKey(const char* filePathUtf8, const ImportOptions& opt) {
+  std::error_code ec;
+  const std::filesystem::path path = std::filesystem::canonical(std::filesystem::u8path(filePathUtf8), ec);
+  if (ec) return std::string();
+  const auto size  = std::filesystem::file_size(path, ec);
+  if (ec) return std::string();
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) return std::string();
+
+  char options[128];
+  std::snprintf(options, sizeof(options), "|%d|%.17g|%d|%d", opt.heal, opt.tolerance,
+                opt.unifySameDomain, opt.extractSolids);
+  return path.u8string() + "|" + std::to_string(size) + "|" +
+         std::to_string(mtime.time_since_epoch().count()) + options;
+}
+
+int RunImportStepEx(OcctKernelImpl* impl, const char* filePathUtf8, const ImportOptions& opt,
+                    int* outShapeId) {
+  try {
+    auto load = [&](ImportCache::Prepared* out) {
+      TopoDS_Shape shape;
+      int rc = ReadStepShape(filePathUtf8, &shape);
+      if (rc == ERROR_OK) rc = PrepareImportedShape(opt, &shape);
+      if (rc != ERROR_OK) return rc;
+      out->shape  = shape;
+      out->bounds = std::make_shared<const ShapeBounds>(ComputeShapeBounds(shape));
+      return ERROR_OK;
+    };
+
+    const std::string key = opt.noCache ? std::string() : ImportCacheKey(filePathUtf8, opt);
+    ImportCache::Prepared prepared;
+    if (key.empty()) {
+      const int rc = load(&prepared);
+      if (rc != ERROR_OK) return rc;
+      *outShapeId = impl->Registry().AddWithBounds(prepared.shape, prepared.bounds);
+      return ERROR_OK;
+    }
+    const int rc = SharedImportCache().Get(key, load, &prepared);
+    if (rc != ERROR_OK) return rc;
+
+    const TopoDS_Shape copy =
+        BRepBuilderAPI_Copy(prepared.shape, Standard_False, Standard_False).Shape();
+    *outShapeId = impl->Registry().AddWithBounds(copy, prepared.bounds);
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int RunExportShape(OcctKernelImpl* impl, int shapeId, OutputFormat format, const MeshOptions& mesh,
+                   const std::string& filePathUtf8, MeshStats* outStats,
+                   const Message_ProgressRange& range, bool edgeRelative = false) {
+  try {
+    TopoDS_Shape shape;
+    std::shared_ptr<const ShapeBounds> shapeBounds;
+    if (!impl->Registry().FindWithBounds(shapeId, &shape, &shapeBounds))
+      return ERROR_SHAPE_NOT_FOUND;
+
+    if (format == OUT_STEP) {
+      std::lock_guard<std::mutex> stepLock(gStepSessionMutex);
+      STEPControl_Writer writer;
+      if (writer.Transfer(shape, STEPControl_AsIs, Standard_True, range) != IFSelect_RetDone)
+        return ERROR_EXPORT_FAILED;
+      if (writer.Write(filePathUtf8.c_str()) != IFSelect_RetDone)
+        return ERROR_EXPORT_FAILED;
+      return ERROR_OK;
+    }
+
+    if (format == OUT_STL || format == OUT_QMESH) {
+      Message_ProgressScope scope(range, "Mesh export", 2);
+      Bnd_Box bounds;
+      if (mesh.relativeDeflection > 0.0) bounds = shapeBounds->aabb;
+      // Registry faces are shared with async operations, duplicates, results
+      // that reuse untouched faces and forks; mesh a topology copy so no
+      // triangulation is written onto a face another thread may be reading.
+      TopoDS_Shape meshed;
+      const int meshError =
+          MeshShape(BRepBuilderAPI_Copy(shape, Standard_False, Standard_False).Shape(), bounds,
+                    mesh, &meshed, outStats, scope.Next(), edgeRelative);
+      if (meshError != ERROR_OK) return meshError;
+      const int writeError = WriteMeshFile(meshed, format, mesh, filePathUtf8, scope.Next());
+      if (writeError != ERROR_OK) return writeError;
+      if (scope.UserBreak()) return ERROR_EXPORT_FAILED;
+      return ERROR_OK;
+    }
+
+    return ERROR_INVALID_ARGUMENT;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+void SetLabelName(const TDF_Label& label, const std::string& nameUtf8) {
+  TDataStd_Name::Set(label, TCollection_ExtendedString(nameUtf8.c_str(), Standard_True));
+}
+
+// All bodies go into one XCAF document and through one STEPCAFControl_Writer,
+// so the header, schema setup and transfer session are paid once per file
+// instead of once per shape.
+int RunExportStepBodies(OcctKernelImpl* impl, const StepBodyDto* bodies, int bodyCount,
+                        const std::string& assemblyNameUtf8, const std::string& filePathUtf8) {
+  try {
+    std::vector<TopoDS_Shape> shapes(static_cast<std::size_t>(bodyCount));
+    for (int i = 0; i < bodyCount; ++i)
+      if (!impl->Registry().Find(bodies[i].shapeId, &shapes[i])) return ERROR_SHAPE_NOT_FOUND;
+
+    Handle(TDocStd_Document) doc = new TDocStd_Document("MDTV-XCAF");
+    const Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
+    const Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(doc->Main());
+
+    TDF_Label assembly;
+    if (!assemblyNameUtf8.empty()) {
+      assembly = shapeTool->NewShape();
+      SetLabelName(assembly, assemblyNameUtf8);
+    }
+    for (int i = 0; i < bodyCount; ++i) {
+      const StepBodyDto& body = bodies[i];
+      const TDF_Label part = shapeTool->AddShape(shapes[i], Standard_False);
+      SetLabelName(part, body.nameUtf8 && *body.nameUtf8
+                             ? std::string(body.nameUtf8)
+                             : "body_" + std::to_string(body.shapeId));
+      if (body.hasColor)
+        colorTool->SetColor(part, Quantity_Color(body.rgb[0], body.rgb[1], body.rgb[2],
+                                                 Quantity_TOC_RGB),
+                            XCAFDoc_ColorGen);
+      if (!assembly.IsNull()) shapeTool->AddComponent(assembly, part, TopLoc_Location());
+    }
+    if (!assembly.IsNull()) shapeTool->UpdateAssemblies();
+
+    std::lock_guard<std::mutex> stepLock(gStepSessionMutex);
+    STEPCAFControl_Writer writer;
+    writer.SetNameMode(Standard_True);
+    writer.SetColorMode(Standard_True);
+    if (!writer.Transfer(doc, STEPControl_AsIs))
+      return ERROR_EXPORT_FAILED;
+    if (writer.Write(filePathUtf8.c_str()) != IFSelect_RetDone)
+      return ERROR_EXPORT_FAILED;
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int StartAsync(OcctKernelImpl* impl, const AsyncOptions* options,
+               AsyncOperation::Work work, int* outOperationId) {
+  try {
+    *outOperationId = impl->Operations().Start(options, std::move(work));
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Stage mesh precompute
+// ---------------------------------------------------------------------------
+
+// One mesh file of L1_BuildStageMeshes, filled in by a mesh worker.
+struct StageMeshTask {
+  int         stage   = -1;  // -1: the stock
+  const char* kind    = "";  // stock / result / delta / removal
+  int         shapeId = 0;
+  std::string file;
+  int         errorCode = ERROR_OK;
+  double      meshMs    = 0.0;
+  double      startMs   = 0.0;  // since the call started
+  double      doneMs    = 0.0;
+};
+
+struct StageRun {
+  int            errorCode      = ERROR_OK;
+  BooleanPath    booleanPath    = BOOLEAN_PATH_FULL;
+  double         booleanStartMs = 0.0;  // since the call started
+  double         booleanMs      = 0.0;  // includes waiting for a prefetched tool
+  double         toolMs         = 0.0;  // prefetched tool build; 0: none
+  double         toolWaitMs     = 0.0;  // part of booleanMs spent waiting for that build
+  double         meshOverlapMs  = 0.0;  // earlier stages meshed during this boolean
+  StageMeshTask* meshes[3]      = {nullptr, nullptr, nullptr};  // result, delta, removal
+};
+
+// Fixed set of mesh workers fed while the caller keeps running booleans.
+class StageMeshQueue {
+ public:
+  StageMeshQueue(int threadCount, std::function<void(StageMeshTask*)> mesh)
+      : mesh_(std::move(mesh)) {
+    for (int i = 0; i < threadCount; ++i) workers_.emplace_back([this] { Loop(); });
+  }
+
+  ~StageMeshQueue() { Drain(); }
+
+  void Push(StageMeshTask* task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(task);
+    }
+    cv_.notify_one();
+  }
+
+  // Meshes what is queued and joins the workers.
+  void Drain() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_)
+      if (worker.joinable()) worker.join();
+  }
+
+ private:
+  void Loop() {
+    while (true) {
+      StageMeshTask* task = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return closed_ || !pending_.empty(); });
+        if (pending_.empty()) return;
+        task = pending_.front();
+        pending_.pop_front();
+      }
+      mesh_(task);
+    }
+  }
+
+  std::function<void(StageMeshTask*)> mesh_;
+  std::mutex                          mutex_;
+  std::condition_variable             cv_;
+  std::deque<StageMeshTask*>          pending_;
+  bool                                closed_ = false;
+  std::vector<std::thread>            workers_;
+};
+
+// Consecutive stages share every face the tool did not touch and the
+// boolean thread is reading the latest result, so each file is meshed from a
+// topology copy: no triangulation is ever written to a shared face.
+int MeshStageShape(OcctKernelImpl* impl, int shapeId, OutputFormat format,
+                   const MeshOptions& mesh, bool edgeRelative,
+                   const std::filesystem::path& path) {
+  try {
+    TopoDS_Shape shape;
+    if (!impl->Registry().Find(shapeId, &shape)) return ERROR_SHAPE_NOT_FOUND;
+    const TopoDS_Shape copy =
+        BRepBuilderAPI_Copy(shape, Standard_False, Standard_False).Shape();
+
+    TopoDS_Shape meshed;
+    const int meshError = MeshShape(copy, Bnd_Box(), mesh, &meshed, nullptr,
+                                    Message_ProgressRange(), edgeRelative);
+    if (meshError != ERROR_OK) return meshError;
+    return WriteMeshFile(meshed, format, mesh, path.u8string(), Message_ProgressRange());
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+void AppendStageMesh(std::string& out, const char* key, const StageMeshTask* task) {
+  out += ",\"";
+  out += key;
+  out += "\":";
+  if (!task) {
+    out += "null";
+    return;
+  }
+  out += "{\"file\":";      l1::AppendJsonString(out, task->file);
+  out += ",\"errorCode\":"; out += std::to_string(task->errorCode);
+  out += ",\"meshMs\":";    l1::AppendJsonNumber(out, task->meshMs, 3);
+  out += ",\"doneMs\":";    l1::AppendJsonNumber(out, task->doneMs, 3);
+  out += '}';
+}
+
+std::string FormatStageMeshes(const l1::JobSpec& job, int errorCode, int failedStage,
+                              int threadCount, double booleansDoneMs, double wallMs,
+                              const StageMeshTask* stock, const std::vector<StageRun>& stages) {
+  std::string out = "{\"errorCode\":" + std::to_string(errorCode);
+  out += ",\"failedStage\":"    + std::to_string(failedStage);
+  out += ",\"threadCount\":"    + std::to_string(threadCount);
+  out += ",\"booleansDoneMs\":"; l1::AppendJsonNumber(out, booleansDoneMs, 3);
+  out += ",\"wallMs\":";         l1::AppendJsonNumber(out, wallMs, 3);
+  AppendStageMesh(out, "stock", stock);
+  out += ",\"stages\":[";
+  for (std::size_t i = 0; i < stages.size(); ++i) {
+    const StageRun& s = stages[i];
+    if (i) out += ',';
+    out += "{\"index\":" + std::to_string(i);
+    out += ",\"type\":";        l1::AppendJsonString(out, job.features[i].type);
+    out += ",\"errorCode\":";   out += std::to_string(s.errorCode);
+    out += ",\"booleanPath\":"; out += std::to_string(s.booleanPath);
+    out += ",\"booleanMs\":";   l1::AppendJsonNumber(out, s.booleanMs, 3);
+    out += ",\"toolMs\":";      l1::AppendJsonNumber(out, s.toolMs, 3);
+    out += ",\"toolWaitMs\":";  l1::AppendJsonNumber(out, s.toolWaitMs, 3);
+    out += ",\"meshOverlapMs\":"; l1::AppendJsonNumber(out, s.meshOverlapMs, 3);
+    AppendStageMesh(out, "result",  s.meshes[0]);
+    AppendStageMesh(out, "delta",   s.meshes[1]);
+    AppendStageMesh(out, "removal", s.meshes[2]);
+    out += '}';
+  }
+  out += "]}";
+  return out;
+}
+
+// Runs the job's booleans in order on a private kernel and hands every
+// finished stage to the mesh workers right away, so meshing overlaps the
+// remaining booleans. The next stage's tool is built on its own thread
+// while the current boolean runs. Stops at the first failing feature;
+// stages already queued are still written.
+int RunStageMeshes(const l1::JobSpec& job, int threadCount, OutputFormat format,
+                   const std::filesystem::path& outDir, std::string* outJson) {
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  auto sinceStart = [start] {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  };
+
+  std::filesystem::create_directories(outDir);
+  MeshOptions mesh = ToMeshOptions(job.output.options);
+  const bool edgeRelative = IsEdgeRelative(job.output.options);
+  const MeshOptions defaults = DefaultMeshOptions();
+  if (mesh.linearDeflection  <= 0.0) mesh.linearDeflection  = defaults.linearDeflection;
+  if (mesh.angularDeflection <= 0.0) mesh.angularDeflection = defaults.angularDeflection;
+
+  // Declared before the kernel: tool builds still pending when the kernel
+  // goes away write into it.
+  std::vector<ToolBuildWindow> toolWindows(job.features.size());
+  auto msSinceStart = [start](Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(t - start).count();
+  };
+
+  OcctKernelImpl kernel;
+  void* handle = &kernel;
+
+  // Tasks live in a deque so the pointers handed to the workers stay valid.
+  std::deque<StageMeshTask> tasks;
+  std::vector<StageRun>     stages;
+  stages.reserve(job.features.size());
+  int    errorCode      = ERROR_OK;
+  int    failedStage    = -1;
+  double booleansDoneMs = 0.0;
+  {
+    StageMeshQueue queue(threadCount, [&](StageMeshTask* task) {
+      const auto meshStart = Clock::now();
+      task->startMs   = msSinceStart(meshStart);
+      task->errorCode = MeshStageShape(&kernel, task->shapeId, format, mesh, edgeRelative,
+                                       outDir / std::filesystem::u8path(task->file));
+      task->meshMs = std::chrono::duration<double, std::milli>(Clock::now() - meshStart).count();
+      task->doneMs = sinceStart();
+    });
+    auto enqueue = [&](int stage, const char* kind, int shapeId) -> StageMeshTask* {
+      if (shapeId <= 0) return nullptr;
+      StageMeshTask task;
+      task.stage   = stage;
+      task.kind    = kind;
+      task.shapeId = shapeId;
+      const char* extension = format == OUT_QMESH ? "qmesh" : "stl";
+      char name[64];
+      if (stage < 0)
+        std::snprintf(name, sizeof(name), "stock.%s", extension);
+      else
+        std::snprintf(name, sizeof(name), "stage_%03d_%s.%s", stage, kind, extension);
+      task.file = name;
+      tasks.push_back(std::move(task));
+      queue.Push(&tasks.back());
+      return &tasks.back();
+    };
+
+    int currentId = 0;
+    errorCode = L1_CreateStock(handle, &job.stock, &currentId);
+    if (errorCode == ERROR_OK) enqueue(-1, "stock", currentId);
+    if (errorCode == ERROR_OK && !job.features.empty())
+      PrefetchJobTool(&kernel, currentId, nullptr, job.features[0], &toolWindows[0]);
+
+    for (std::size_t i = 0; errorCode == ERROR_OK && i < job.features.size(); ++i) {
+      const int stage = static_cast<int>(i);
+      if (i + 1 < job.features.size())
+        PrefetchJobTool(&kernel, currentId, &job.features[i], job.features[i + 1],
+                        &toolWindows[i + 1]);
+
+      StageRun run;
+      OperationResult result = NewOperationResult();
+      const auto booleanStart = Clock::now();
+      run.errorCode      = l1::ApplyFeature(handle, currentId, job.features[i], &result);
+      run.booleanStartMs = msSinceStart(booleanStart);
+      run.booleanMs      = std::chrono::duration<double, std::milli>(Clock::now() - booleanStart).count();
+      run.booleanPath    = result.booleanPath;
+      if (run.errorCode != ERROR_OK) {
+        errorCode   = run.errorCode;
+        failedStage = stage;
+      } else {
+        run.meshes[0] = enqueue(stage, "result",  result.resultShapeId);
+        run.meshes[1] = enqueue(stage, "delta",   result.deltaShapeId);
+        run.meshes[2] = enqueue(stage, "removal", result.removalShapeId);
+        currentId = result.resultShapeId;
+      }
+      stages.push_back(run);
+    }
+    booleansDoneMs = sinceStart();
+    kernel.Tools().Clear();  // a failed stage can leave the next tool pending
+    queue.Drain();
+  }
+
+  for (std::size_t i = 0; i < stages.size(); ++i) {
+    StageRun& s = stages[i];
+    const double booleanEndMs = s.booleanStartMs + s.booleanMs;
+    const ToolBuildWindow& window = toolWindows[i];
+    if (window.ran) {
+      s.toolMs     = std::chrono::duration<double, std::milli>(window.end - window.start).count();
+      s.toolWaitMs = std::clamp(msSinceStart(window.end) - s.booleanStartMs, 0.0, s.booleanMs);
+    }
+    for (const StageMeshTask& task : tasks)
+      s.meshOverlapMs += std::max(0.0, std::min(task.doneMs, booleanEndMs) -
+                                           std::max(task.startMs, s.booleanStartMs));
+  }
+
+  if (errorCode == ERROR_OK)
+    for (const StageMeshTask& task : tasks)
+      if (task.errorCode != ERROR_OK) {
+        errorCode = task.errorCode;
+        break;
+      }
+
+  *outJson = FormatStageMeshes(job, errorCode, failedStage, threadCount, booleansDoneMs,
+                               sinceStart(), tasks.empty() ? nullptr : &tasks.front(), stages);
+  return errorCode;
+}
+
+// ---------------------------------------------------------------------------
+// Call journal
+// ---------------------------------------------------------------------------
+
+// Records one public call when the journal is on; otherwise costs one flag
+// check. Inputs are added up front, outputs by Finish.
+class JournalScope {
+ public:
+  JournalScope(l1::journal::Call call, const void* kernel, std::uint16_t flags = 0)
+      : active_(l1::journal::IsEnabled()), call_(call), flags_(flags), kernel_(kernel) {
+    if (active_) startMs_ = l1::journal::NowMs();
+  }
+
+  template <typename T>
+  JournalScope& In(const T& value) {
+    if (active_) payload_.Put(value);
+    return *this;
+  }
+
+  // Versioned option structs: their own structSize bytes.
+  template <typename T>
+  JournalScope& InVersioned(const T& value) {
+    if (active_) payload_.PutBlob(&value, static_cast<std::size_t>(value.structSize));
+    return *this;
+  }
+
+  JournalScope& InSegments(const Path2DSegmentDto* segments, int segmentCount) {
+    if (active_)
+      payload_.PutBlob(segments, sizeof(Path2DSegmentDto) *
+                                     static_cast<std::size_t>(std::max(segmentCount, 0)));
+    return *this;
+  }
+
+  JournalScope& InString(const char* text) {
+    if (active_) payload_.PutString(text);
+    return *this;
+  }
+
+  // Count, then per body: shape id, name, hasColor and the three components.
+  JournalScope& InBodies(const StepBodyDto* bodies, int bodyCount) {
+    if (!active_) return *this;
+    payload_.Put(bodyCount);
+    for (int i = 0; i < bodyCount; ++i)
+      payload_.Put(bodies[i].shapeId).PutString(bodies[i].nameUtf8).Put(bodies[i].hasColor)
+              .Put(bodies[i].rgb[0]).Put(bodies[i].rgb[1]).Put(bodies[i].rgb[2]);
+    return *this;
+  }
+
+  int Finish(int returnCode) {
+    if (active_)
+      l1::journal::Append(call_, flags_, kernel_, startMs_, l1::journal::NowMs() - startMs_,
+                          returnCode, payload_.Take());
+    return returnCode;
+  }
+
+  template <typename T>
+  int Finish(int returnCode, const T& output) {
+    In(output);
+    return Finish(returnCode);
+  }
+
+  // Versioned outputs: the full struct is journaled.
+  template <typename T>
+  int FinishVersioned(int returnCode, const T& output) {
+    InVersioned(output);
+    return Finish(returnCode);
+  }
+
+ private:
+  const bool                 active_;
+  const l1::journal::Call    call_;
+  const std::uint16_t        flags_;
+  const void* const          kernel_;
+  double                     startMs_ = 0.0;
+  l1::journal::PayloadWriter payload_;
+};
+
+// Copies the caller's structSize worth of an L1_Apply* result back.
+int FinishApply(JournalScope& journal, int returnCode, const OperationResult& result,
+                OperationResult* outResult) {
+  CopyStructFields(outResult, &result, outResult->structSize);
+  return journal.FinishVersioned(returnCode, result);
+}
+
+}  // namespace
+
+// ===========================================================================
+// Public API
+// ===========================================================================
+
+void* L1_CreateKernel() {
+  void* kernel = nullptr;
+  try {
+    kernel = new OcctKernelImpl();
+  } catch (...) {
+    return nullptr;
+  }
+  JournalScope(l1::journal::Call::kCreateKernel, kernel).Finish(ERROR_OK);
+  return kernel;
+}
+
+int L1_DestroyKernel(void* kernel) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kDestroyKernel, kernel);
+  try {
+    delete static_cast<OcctKernelImpl*>(kernel);
+    return journal.Finish(ERROR_OK);
+  } catch (...) {
+    return journal.Finish(MapExceptionToError());
+  }
+}
+
+int L1_ForkKernel(void* kernel, void** outKernel) {
+  if (!kernel || !outKernel) return ERROR_INVALID_ARGUMENT;
+  *outKernel = nullptr;
+  JournalScope journal(l1::journal::Call::kForkKernel, kernel);
+  int errorCode = ERROR_OK;
+  try {
+    *outKernel = static_cast<OcctKernelImpl*>(kernel)->Fork().release();
+  } catch (...) {
+    errorCode = MapExceptionToError();
+  }
+  return journal.Finish(errorCode, static_cast<std::uint64_t>(
+                                       reinterpret_cast<std::uintptr_t>(*outKernel)));
+}
+
+int L1_ResetKernel(void* kernel) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kResetKernel, kernel);
+  try {
+    static_cast<OcctKernelImpl*>(kernel)->Reset();
+    return journal.Finish(ERROR_OK);
+  } catch (...) {
+    return journal.Finish(MapExceptionToError());
+  }
+}
+
+int L1_SetKernelOptions(void* kernel, const KernelOptions* opt) {
+  if (!kernel || !opt) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<KernelOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kSetKernelOptions, kernel);
+  journal.InVersioned(*opt);
+  try {
+    KernelOptions options = DefaultKernelOptions();
+    CopyStructFields(&options, opt, opt->structSize);
+    static_cast<OcctKernelImpl*>(kernel)->SetOptions(options);
+    return journal.Finish(ERROR_OK);
+  } catch (...) {
+    return journal.Finish(MapExceptionToError());
+  }
+}
+
+int L1_GetKernelOptions(void* kernel, KernelOptions* outOpt) {
+  if (!kernel || !outOpt) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<KernelOptions>(outOpt->structSize)) return ERROR_INVALID_ARGUMENT;
+  try {
+    const KernelOptions options = static_cast<OcctKernelImpl*>(kernel)->Options();
+    CopyStructFields(outOpt, &options, outOpt->structSize);
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int L1_CreateStock(void* kernel, const StockDto* dto, int* outStockId) {
+  if (!kernel || !dto || !outStockId) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kCreateStock, kernel);
+  journal.In(*dto);
+  const int rc = RunCreateStock(static_cast<OcctKernelImpl*>(kernel), dto, outStockId);
+  return journal.Finish(rc, rc == ERROR_OK ? *outStockId : 0);
+}
+
+int L1_ApplyMillHole(void* kernel, int stockId,
+                     const MillHoleFeatureDto* dto,
+                     OperationResult* outResult) {
+  if (!kernel || !dto || !outResult) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kApplyMillHole, kernel);
+  journal.In(stockId).In(*dto);
+  OperationResult result = NewOperationResult();
+
+  if (dto->radius <= 0.0 || dto->depth <= 0.0)
+    return FinishApply(journal, ERROR_INVALID_ARGUMENT, result, outResult);
+
+  const int rc = RunApplyMillHole(static_cast<OcctKernelImpl*>(kernel), stockId, *dto, &result,
+                                  Message_ProgressRange());
+  return FinishApply(journal, rc, result, outResult);
+}
+
+int L1_ApplyPocketRect(void* kernel, int stockId,
+                       const PocketRectFeatureDto* dto,
+                       OperationResult* outResult) {
+  if (!kernel || !dto || !outResult) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kApplyPocketRect, kernel);
+  journal.In(stockId).In(*dto);
+  OperationResult result = NewOperationResult();
+
+  if (dto->width <= 0.0 || dto->height <= 0.0 || dto->depth <= 0.0)
+    return FinishApply(journal, ERROR_INVALID_ARGUMENT, result, outResult);
+
+  const int rc = RunApplyPocketRect(static_cast<OcctKernelImpl*>(kernel), stockId, *dto,
+                                    &result, Message_ProgressRange());
+  return FinishApply(journal, rc, result, outResult);
+}
+
+int L1_ApplyTurnOd(void* kernel, int stockId,
+                   const AxisDto* axis,
+                   const Path2DSegmentDto* segments, int segmentCount, int closed,
+                   OperationResult* outResult) {
+  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kApplyTurnOd, kernel);
+  journal.In(stockId).In(*axis).InSegments(segments, segmentCount).In(closed);
+  OperationResult result = NewOperationResult();
+
+  const int rc = RunApplyTurn(static_cast<OcctKernelImpl*>(kernel), stockId, *axis, segments,
+                              segmentCount, closed, &result, Message_ProgressRange());
+  return FinishApply(journal, rc, result, outResult);
+}
+
+int L1_ApplyTurnId(void* kernel, int stockId,
+                   const AxisDto* axis,
+                   const Path2DSegmentDto* segments, int segmentCount, int closed,
+                   OperationResult* outResult) {
+  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kApplyTurnId, kernel);
+  journal.In(stockId).In(*axis).InSegments(segments, segmentCount).In(closed);
+  OperationResult result = NewOperationResult();
+
+  const int rc = RunApplyTurn(static_cast<OcctKernelImpl*>(kernel), stockId, *axis, segments,
+                              segmentCount, closed, &result, Message_ProgressRange());
+  return FinishApply(journal, rc, result, outResult);
+}
+
+int L1_ApplyMillContour(void* kernel, int stockId,
+                        const AxisDto* axis,
+                        const Path2DSegmentDto* segments, int segmentCount, int closed,
+                        double depth,
+                        OperationResult* outResult) {
+  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kApplyMillContour, kernel);
+  journal.In(stockId).In(*axis).InSegments(segments, segmentCount).In(closed).In(depth);
+  OperationResult result = NewOperationResult();
+
+  const int rc = RunApplyMillContour(static_cast<OcctKernelImpl*>(kernel), stockId, *axis,
+                                     segments, segmentCount, closed, depth, &result,
+                                     Message_ProgressRange());
+  return FinishApply(journal, rc, result, outResult);
+}
+
+int L1_ApplyMillSlot(void* kernel, int stockId,
+                     const AxisDto* axis,
+                     const Path2DSegmentDto* segments, int segmentCount,
+                     double toolRadius, double depth,
+                     OperationResult* outResult) {
+  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kApplyMillSlot, kernel);
+  journal.In(stockId).In(*axis).InSegments(segments, segmentCount).In(toolRadius).In(depth);
+  OperationResult result = NewOperationResult();
+
+  const int rc = RunApplyMillSlot(static_cast<OcctKernelImpl*>(kernel), stockId, *axis, segments,
+                                  segmentCount, toolRadius, depth, &result,
+                                  Message_ProgressRange());
+  return FinishApply(journal, rc, result, outResult);
+}
+
+int L1_DeleteShape(void* kernel, int shapeId) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kDeleteShape, kernel);
+  journal.In(shapeId);
+  try {
+    auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    return journal.Finish(impl->Registry().Remove(shapeId) ? ERROR_OK : ERROR_SHAPE_NOT_FOUND);
+  } catch (...) {
+    return journal.Finish(MapExceptionToError());
   }
-
-  outResult->resultShapeId = impl->Registry().Add(cut.Shape());
-  outResult->deltaShapeId  = impl->Registry().Add(common.Shape());
-  outResult->removalShapeId = impl->Registry().Add(tool);
-  outResult->errorCode     = ERROR_OK;
-  return ERROR_OK;
 }
 
-}  // namespace
+int L1_ValidateShape(void* kernel, int shapeId,
+                     const ValidationOptions* opt,
+                     ValidationReport* outReport) {
+  if (!kernel || !opt || !outReport) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<ValidationOptions>(opt->structSize) ||
+      !IsValidStructSize<ValidationReport>(outReport->structSize))
+    return ERROR_INVALID_ARGUMENT;
 
-// ===========================================================================
-// Public API
-// ===========================================================================
+  ValidationOptions options{};
+  options.structSize = sizeof(ValidationOptions);
+  options.level      = VALIDATE_STRUCTURE;
+  CopyStructFields(&options, opt, opt->structSize);
+  if (options.level < VALIDATE_STRUCTURE || options.level > VALIDATE_FULL)
+    return ERROR_INVALID_ARGUMENT;
+  const double toleranceLimit =
+      options.toleranceLimit > 0.0 ? options.toleranceLimit : kDefaultToleranceLimit;
 
-void* L1_CreateKernel() {
   try {
-    return new OcctKernelImpl();
+    auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    TopoDS_Shape shape;
+    if (!impl->Registry().Find(shapeId, &shape)) return ERROR_SHAPE_NOT_FOUND;
+    ValidationReport report{};
+    ValidateShape(shape, options.level, toleranceLimit, &report);
+    CopyStructFields(outReport, &report, outReport->structSize);
+    return ERROR_OK;
   } catch (...) {
-    return nullptr;
+    return MapExceptionToError();
   }
 }
 
-int L1_DestroyKernel(void* kernel) {
-  if (!kernel) return ERROR_INVALID_ARGUMENT;
+int L1_CompareShapes(void* kernel, int shapeId, int referenceId,
+                     const CompareOptions* opt,
+                     const char* deviationMeshFileUtf8,
+                     CompareReport* outReport) {
+  if (!kernel || !opt || !outReport) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<CompareOptions>(opt->structSize) ||
+      !IsValidStructSize<CompareReport>(outReport->structSize))
+    return ERROR_INVALID_ARGUMENT;
+
+  CompareOptions options{};
+  options.structSize = sizeof(CompareOptions);
+  CopyStructFields(&options, opt, opt->structSize);
+  if (options.threadCount < 0) return ERROR_INVALID_ARGUMENT;
+
+  CompareReport report{};
+  report.structSize = sizeof(CompareReport);
+  const int rc = RunCompareShapes(static_cast<OcctKernelImpl*>(kernel), shapeId, referenceId,
+                                  options, deviationMeshFileUtf8, &report);
+  CopyStructFields(outReport, &report, outReport->structSize);
+  return rc;
+}
+
+int L1_ComputeMassProperties(void* kernel, const int* shapeIds, int shapeCount,
+                             const MassPropertiesOptions* opt, MassProperties* outProps) {
+  if (!kernel || !opt || shapeCount < 0) return ERROR_INVALID_ARGUMENT;
+  if (shapeCount > 0 && (!shapeIds || !outProps)) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<MassPropertiesOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+
+  MassPropertiesOptions options{};
+  options.structSize = sizeof(MassPropertiesOptions);
+  options.mode       = MASS_EXACT;
+  CopyStructFields(&options, opt, opt->structSize);
+  if (options.threadCount < 0 || (options.mode != MASS_EXACT && options.mode != MASS_FAST))
+    return ERROR_INVALID_ARGUMENT;
+
   try {
-    delete static_cast<OcctKernelImpl*>(kernel);
+    RunComputeMassProperties(static_cast<OcctKernelImpl*>(kernel), shapeIds, shapeCount,
+                             options, outProps);
     return ERROR_OK;
   } catch (...) {
     return MapExceptionToError();
   }
 }
 
-int L1_CreateStock(void* kernel, const StockDto* dto, int* outStockId) {
-  if (!kernel || !dto || !outStockId) return ERROR_INVALID_ARGUMENT;
-  try {
-    auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    gp_Pnt origin(dto->axis.origin[0], dto->axis.origin[1], dto->axis.origin[2]);
-    gp_Dir dir   (dto->axis.dir[0],    dto->axis.dir[1],    dto->axis.dir[2]);
-    gp_Dir xdir  (dto->axis.xdir[0],   dto->axis.xdir[1],   dto->axis.xdir[2]);
-    gp_Ax2 axis(origin, dir, xdir);
+int L1_SectionShape(void* kernel, int shapeId, const SectionOptions* opt,
+                    SectionPlane* outPlanes, Path2DSegmentDto* outSegments,
+                    int segmentCapacity, int* outSegmentCount) {
+  if (!kernel || !opt || !outPlanes || !outSegmentCount || segmentCapacity < 0)
+    return ERROR_INVALID_ARGUMENT;
+  if (segmentCapacity > 0 && !outSegments) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<SectionOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  *outSegmentCount = 0;
 
-    TopoDS_Shape shape;
-    switch (dto->type) {
-      case STOCK_BOX:
-        shape = BRepPrimAPI_MakeBox(axis, dto->p1, dto->p2, dto->p3).Shape();
-        break;
-      case STOCK_CYLINDER:
-        shape = BRepPrimAPI_MakeCylinder(axis, dto->p1, dto->p2).Shape();
-        break;
-      default:
-        return ERROR_INVALID_ARGUMENT;
-    }
+  SectionOptions options{};
+  options.structSize = sizeof(SectionOptions);
+  CopyStructFields(&options, opt, opt->structSize);
+  if (options.planeCount < 1 || options.threadCount < 0 ||
+      (options.planeCount > 1 && options.spacing == 0.0))
+    return ERROR_INVALID_ARGUMENT;
 
-    *outStockId = impl->Registry().Add(shape);
+  try {
+    std::vector<Path2DSegmentDto> segments;
+    const int rc = RunSectionShape(static_cast<OcctKernelImpl*>(kernel), shapeId, options,
+                                   outPlanes, &segments);
+    if (rc != ERROR_OK) return rc;
+    *outSegmentCount = static_cast<int>(segments.size());
+    if (segments.size() > static_cast<std::size_t>(segmentCapacity)) return ERROR_BUFFER_TOO_SMALL;
+    std::copy(segments.begin(), segments.end(), outSegments);
     return ERROR_OK;
   } catch (...) {
     return MapExceptionToError();
   }
 }
 
-int L1_ApplyMillHole(void* kernel, int stockId,
-                     const MillHoleFeatureDto* dto,
-                     OperationResult* outResult) {
-  if (!kernel || !dto || !outResult) return ERROR_INVALID_ARGUMENT;
-  outResult->resultShapeId = outResult->deltaShapeId = outResult->removalShapeId = 0;
-  outResult->errorCode = ERROR_INVALID_ARGUMENT;
+int L1_QueryClearance(void* kernel, int shapeId, int otherId,
+                      const double* offsets, int placementCount,
+                      const ClearanceOptions* opt, ClearanceResult* outResults) {
+  if (!kernel || !opt || !outResults || placementCount < 1) return ERROR_INVALID_ARGUMENT;
+  if (!offsets && placementCount != 1) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<ClearanceOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
 
-  if (dto->radius <= 0.0 || dto->depth <= 0.0) return ERROR_INVALID_ARGUMENT;
+  ClearanceOptions options{};
+  options.structSize = sizeof(ClearanceOptions);
+  CopyStructFields(&options, opt, opt->structSize);
+  if (options.threadCount < 0) return ERROR_INVALID_ARGUMENT;
 
   try {
-    auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    gp_Pnt origin(dto->axis.origin[0], dto->axis.origin[1], dto->axis.origin[2]);
-    gp_Dir dir   (dto->axis.dir[0],    dto->axis.dir[1],    dto->axis.dir[2]);
-    const TopoDS_Shape tool =
-        BRepPrimAPI_MakeCylinder(gp_Ax2(origin, dir), dto->radius, dto->depth).Shape();
-    return ApplyBooleanOp(impl, stockId, tool, outResult);
+    return RunQueryClearance(static_cast<OcctKernelImpl*>(kernel), shapeId, otherId, offsets,
+                             placementCount, options, outResults);
   } catch (...) {
-    outResult->errorCode = ERROR_OCCT_EXCEPTION;
     return MapExceptionToError();
   }
 }
 
-int L1_ApplyPocketRect(void* kernel, int stockId,
-                       const PocketRectFeatureDto* dto,
-                       OperationResult* outResult) {
-  if (!kernel || !dto || !outResult) return ERROR_INVALID_ARGUMENT;
-  outResult->resultShapeId = outResult->deltaShapeId = outResult->removalShapeId = 0;
-  outResult->errorCode = ERROR_INVALID_ARGUMENT;
+int L1_ImportStepAsShape(void* kernel,
+                         const char* filePathUtf8,
+                         int* outShapeId) {
+  if (!kernel || !filePathUtf8 || !outShapeId) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kImportStep, kernel);
+  journal.InString(filePathUtf8);
+  const int rc = RunImportStep(static_cast<OcctKernelImpl*>(kernel), filePathUtf8, outShapeId);
+  return journal.Finish(rc, rc == ERROR_OK ? *outShapeId : 0);
+}
+
+int L1_ImportStepAsShapeEx(void* kernel,
+                           const char* filePathUtf8,
+                           const ImportOptions* opt,
+                           int* outShapeId) {
+  if (!kernel || !filePathUtf8 || !opt || !outShapeId) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<ImportOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+
+  JournalScope journal(l1::journal::Call::kImportStepEx, kernel);
+  journal.InString(filePathUtf8).InVersioned(*opt);
+  ImportOptions options{};
+  options.structSize = sizeof(ImportOptions);
+  CopyStructFields(&options, opt, opt->structSize);
+  if (options.tolerance < 0.0) return journal.Finish(ERROR_INVALID_ARGUMENT, 0);
+
+  const int rc = RunImportStepEx(static_cast<OcctKernelImpl*>(kernel), filePathUtf8, options,
+                                 outShapeId);
+  return journal.Finish(rc, rc == ERROR_OK ? *outShapeId : 0);
+}
+
+int L1_ExportShape(void* kernel, int shapeId,
+                   const OutputOptions* opt,
+                   const char* filePathUtf8) {
+  if (!kernel || !opt || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  JournalScope journal(l1::journal::Call::kExportShape, kernel);
+  journal.In(shapeId).In(*opt).InString(filePathUtf8);
+  return journal.Finish(RunExportShape(static_cast<OcctKernelImpl*>(kernel), shapeId, opt->format,
+                                       ToMeshOptions(*opt), filePathUtf8, nullptr,
+                                       Message_ProgressRange(), IsEdgeRelative(*opt)));
+}
+
+int L1_ExportShapeEx(void* kernel, int shapeId,
+                     OutputFormat format, const MeshOptions* mesh,
+                     const char* filePathUtf8,
+                     MeshStats* outStats) {
+  if (!kernel || !mesh || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<MeshOptions>(mesh->structSize)) return ERROR_INVALID_ARGUMENT;
+  if (outStats && !IsValidStructSize<MeshStats>(outStats->structSize)) return ERROR_INVALID_ARGUMENT;
+
+  JournalScope journal(l1::journal::Call::kExportShapeEx, kernel);
+  journal.In(shapeId).In(format).InVersioned(*mesh).InString(filePathUtf8);
+  MeshOptions options = DefaultMeshOptions();
+  CopyStructFields(&options, mesh, mesh->structSize);
+  if (outStats) {
+    const MeshStats empty{};
+    CopyStructFields(outStats, &empty, outStats->structSize);
+  }
+  return journal.Finish(RunExportShape(static_cast<OcctKernelImpl*>(kernel), shapeId, format,
+                                       options, filePathUtf8, outStats, Message_ProgressRange()));
+}
+
+int L1_ExportStepBodies(void* kernel,
+                        const StepBodyDto* bodies, int bodyCount,
+                        const char* assemblyNameUtf8,
+                        const char* filePathUtf8) {
+  if (!kernel || !bodies || bodyCount <= 0 || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  for (int i = 0; i < bodyCount; ++i) {
+    if (!bodies[i].hasColor) continue;
+    for (double c : bodies[i].rgb)
+      if (!(c >= 0.0 && c <= 1.0)) return ERROR_INVALID_ARGUMENT;
+  }
+
+  JournalScope journal(l1::journal::Call::kExportStepBodies, kernel);
+  journal.InBodies(bodies, bodyCount).InString(assemblyNameUtf8).InString(filePathUtf8);
+  return journal.Finish(RunExportStepBodies(static_cast<OcctKernelImpl*>(kernel), bodies,
+                                            bodyCount, assemblyNameUtf8 ? assemblyNameUtf8 : "",
+                                            filePathUtf8));
+}
+
+// ---------------------------------------------------------------------------
+// Async variants: inputs are copied, the work runs on its own thread.
+// ---------------------------------------------------------------------------
+
+int L1_ApplyMillHoleAsync(void* kernel, int stockId,
+                          const MillHoleFeatureDto* dto,
+                          const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !dto || !outOperationId) return ERROR_INVALID_ARGUMENT;
+  if (dto->radius <= 0.0 || dto->depth <= 0.0) return ERROR_INVALID_ARGUMENT;
 
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  const MillHoleFeatureDto feature = *dto;
+  return StartAsync(impl, async,
+      [impl, stockId, feature](OperationResult* result, const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kApplyMillHole, impl, l1::journal::kFlagAsync);
+        journal.In(stockId).In(feature);
+        return journal.Finish(RunApplyMillHole(impl, stockId, feature, result, range), *result);
+      },
+      outOperationId);
+}
+
+int L1_ApplyPocketRectAsync(void* kernel, int stockId,
+                            const PocketRectFeatureDto* dto,
+                            const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !dto || !outOperationId) return ERROR_INVALID_ARGUMENT;
   if (dto->width <= 0.0 || dto->height <= 0.0 || dto->depth <= 0.0)
     return ERROR_INVALID_ARGUMENT;
 
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  const PocketRectFeatureDto feature = *dto;
+  return StartAsync(impl, async,
+      [impl, stockId, feature](OperationResult* result, const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kApplyPocketRect, impl, l1::journal::kFlagAsync);
+        journal.In(stockId).In(feature);
+        return journal.Finish(RunApplyPocketRect(impl, stockId, feature, result, range), *result);
+      },
+      outOperationId);
+}
+
+int L1_ApplyTurnOdAsync(void* kernel, int stockId,
+                        const AxisDto* axis,
+                        const Path2DSegmentDto* segments, int segmentCount, int closed,
+                        const AsyncOptions* async, int* outOperationId) {
+  return L1_ApplyTurnIdAsync(kernel, stockId, axis, segments, segmentCount, closed,
+                             async, outOperationId);
+}
+
+int L1_ApplyTurnIdAsync(void* kernel, int stockId,
+                        const AxisDto* axis,
+                        const Path2DSegmentDto* segments, int segmentCount, int closed,
+                        const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !axis || !segments || !outOperationId || segmentCount <= 0)
+    return ERROR_INVALID_ARGUMENT;
+
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  const AxisDto toolAxis = *axis;
+  std::vector<Path2DSegmentDto> profile(segments, segments + segmentCount);
+  return StartAsync(impl, async,
+      [impl, stockId, toolAxis, profile = std::move(profile), closed](
+          OperationResult* result, const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kApplyTurnId, impl, l1::journal::kFlagAsync);
+        journal.In(stockId).In(toolAxis)
+               .InSegments(profile.data(), static_cast<int>(profile.size())).In(closed);
+        return journal.Finish(RunApplyTurn(impl, stockId, toolAxis, profile.data(),
+                                           static_cast<int>(profile.size()), closed, result,
+                                           range),
+                              *result);
+      },
+      outOperationId);
+}
+
+int L1_ApplyMillContourAsync(void* kernel, int stockId,
+                             const AxisDto* axis,
+                             const Path2DSegmentDto* segments, int segmentCount, int closed,
+                             double depth,
+                             const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !axis || !segments || !outOperationId || segmentCount <= 0)
+    return ERROR_INVALID_ARGUMENT;
+
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  const AxisDto toolAxis = *axis;
+  std::vector<Path2DSegmentDto> profile(segments, segments + segmentCount);
+  return StartAsync(impl, async,
+      [impl, stockId, toolAxis, profile = std::move(profile), closed, depth](
+          OperationResult* result, const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kApplyMillContour, impl,
+                             l1::journal::kFlagAsync);
+        journal.In(stockId).In(toolAxis)
+               .InSegments(profile.data(), static_cast<int>(profile.size()))
+               .In(closed).In(depth);
+        return journal.Finish(RunApplyMillContour(impl, stockId, toolAxis, profile.data(),
+                                                  static_cast<int>(profile.size()), closed,
+                                                  depth, result, range),
+                              *result);
+      },
+      outOperationId);
+}
+
+int L1_ApplyMillSlotAsync(void* kernel, int stockId,
+                          const AxisDto* axis,
+                          const Path2DSegmentDto* segments, int segmentCount,
+                          double toolRadius, double depth,
+                          const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !axis || !segments || !outOperationId || segmentCount <= 0)
+    return ERROR_INVALID_ARGUMENT;
+
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  const AxisDto toolAxis = *axis;
+  std::vector<Path2DSegmentDto> path(segments, segments + segmentCount);
+  return StartAsync(impl, async,
+      [impl, stockId, toolAxis, path = std::move(path), toolRadius, depth](
+          OperationResult* result, const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kApplyMillSlot, impl,
+                             l1::journal::kFlagAsync);
+        journal.In(stockId).In(toolAxis)
+               .InSegments(path.data(), static_cast<int>(path.size()))
+               .In(toolRadius).In(depth);
+        return journal.Finish(RunApplyMillSlot(impl, stockId, toolAxis, path.data(),
+                                               static_cast<int>(path.size()), toolRadius,
+                                               depth, result, range),
+                              *result);
+      },
+      outOperationId);
+}
+
+int L1_ExportShapeAsync(void* kernel, int shapeId,
+                        const OutputOptions* opt,
+                        const char* filePathUtf8,
+                        const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !opt || !filePathUtf8 || !outOperationId) return ERROR_INVALID_ARGUMENT;
+
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  const OutputOptions output = *opt;
+  const std::string   path   = filePathUtf8;
+  return StartAsync(impl, async,
+      [impl, shapeId, output, path](OperationResult* result,
+                                    const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kExportShape, impl, l1::journal::kFlagAsync);
+        journal.In(shapeId).In(output).InString(path.c_str());
+        result->errorCode = RunExportShape(impl, shapeId, output.format, ToMeshOptions(output),
+                                           path, nullptr, range, IsEdgeRelative(output));
+        return journal.Finish(result->errorCode);
+      },
+      outOperationId);
+}
+
+int L1_ExportShapeExAsync(void* kernel, int shapeId,
+                          OutputFormat format, const MeshOptions* mesh,
+                          const char* filePathUtf8,
+                          const AsyncOptions* async, int* outOperationId) {
+  if (!kernel || !mesh || !filePathUtf8 || !outOperationId) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<MeshOptions>(mesh->structSize)) return ERROR_INVALID_ARGUMENT;
+
+  auto* impl = static_cast<OcctKernelImpl*>(kernel);
+  MeshOptions options = DefaultMeshOptions();
+  CopyStructFields(&options, mesh, mesh->structSize);
+  const std::string path = filePathUtf8;
+  return StartAsync(impl, async,
+      [impl, shapeId, format, options, path](OperationResult* result,
+                                             const Message_ProgressRange& range) {
+        JournalScope journal(l1::journal::Call::kExportShapeEx, impl, l1::journal::kFlagAsync);
+        journal.In(shapeId).In(format).InVersioned(options).InString(path.c_str());
+        result->errorCode = RunExportShape(impl, shapeId, format, options, path, nullptr, range);
+        return journal.Finish(result->errorCode);
+      },
+      outOperationId);
+}
+
+int L1_PollOperation(void* kernel, int operationId, int* outDone, double* outProgress) {
+  if (!kernel || !outDone) return ERROR_INVALID_ARGUMENT;
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    gp_Pnt origin(dto->axis.origin[0], dto->axis.origin[1], dto->axis.origin[2]);
-    gp_Dir dir   (dto->axis.dir[0],    dto->axis.dir[1],    dto->axis.dir[2]);
-    gp_Dir xdir  (dto->axis.xdir[0],   dto->axis.xdir[1],   dto->axis.xdir[2]);
-    gp_Dir ydir = dir.Crossed(xdir);
-    gp_Pnt corner = origin.Translated(
-        gp_Vec(xdir) * (-0.5 * dto->width) + gp_Vec(ydir) * (-0.5 * dto->height));
-    const TopoDS_Shape tool =
-        BRepPrimAPI_MakeBox(gp_Ax2(corner, dir, xdir),
-                            dto->width, dto->height, dto->depth).Shape();
-    return ApplyBooleanOp(impl, stockId, tool, outResult);
+    const std::shared_ptr<AsyncOperation> op = impl->Operations().Find(operationId);
+    if (!op) return ERROR_INVALID_ARGUMENT;
+    {
+      std::lock_guard<std::mutex> lock(op->mutex);
+      *outDone = op->done ? 1 : 0;
+    }
+    if (outProgress) *outProgress = op->progress.load();
+    return ERROR_OK;
   } catch (...) {
-    outResult->errorCode = ERROR_OCCT_EXCEPTION;
     return MapExceptionToError();
   }
 }
 
-int L1_ApplyTurnOd(void* kernel, int stockId,
-                   const AxisDto* axis,
-                   const Path2DSegmentDto* segments, int segmentCount, int closed,
-                   OperationResult* outResult) {
-  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
-  outResult->resultShapeId = outResult->deltaShapeId = outResult->removalShapeId = 0;
-  outResult->errorCode = ERROR_INVALID_ARGUMENT;
-
+int L1_WaitOperation(void* kernel, int operationId, double timeoutMs,
+                     OperationResult* outResult) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  if (outResult && !IsValidStructSize<OperationResult>(outResult->structSize))
+    return ERROR_INVALID_ARGUMENT;
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    TopoDS_Shape tool;
-    int buildError = ERROR_OK;
-    if (!BuildTurnTool(segments, segmentCount, closed, *axis, &tool, &buildError)) {
-      outResult->errorCode = buildError;
-      return buildError;
+    const std::shared_ptr<AsyncOperation> op = impl->Operations().Find(operationId);
+    if (!op) return ERROR_INVALID_ARGUMENT;
+
+    std::unique_lock<std::mutex> lock(op->mutex);
+    if (timeoutMs < 0.0) {
+      op->doneCv.wait(lock, [&op] { return op->done; });
+    } else if (!op->doneCv.wait_for(lock, std::chrono::duration<double, std::milli>(timeoutMs),
+                                    [&op] { return op->done; })) {
+      return ERROR_OPERATION_PENDING;
     }
-    return ApplyBooleanOp(impl, stockId, tool, outResult);
+
+    if (outResult) CopyStructFields(outResult, &op->result, outResult->structSize);
+    return op->errorCode;
   } catch (...) {
-    outResult->errorCode = ERROR_OCCT_EXCEPTION;
     return MapExceptionToError();
   }
 }
 
-int L1_ApplyTurnId(void* kernel, int stockId,
-                   const AxisDto* axis,
-                   const Path2DSegmentDto* segments, int segmentCount, int closed,
-                   OperationResult* outResult) {
-  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
-  outResult->resultShapeId = outResult->deltaShapeId = outResult->removalShapeId = 0;
-  outResult->errorCode = ERROR_INVALID_ARGUMENT;
+int L1_Cancel(void* kernel, int operationId) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  try {
+    auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    const std::shared_ptr<AsyncOperation> op = impl->Operations().Find(operationId);
+    if (!op) return ERROR_INVALID_ARGUMENT;
+    op->cancelRequested = true;
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
 
+int L1_ReleaseOperation(void* kernel, int operationId) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    TopoDS_Shape tool;
-    int buildError = ERROR_OK;
-    if (!BuildTurnTool(segments, segmentCount, closed, *axis, &tool, &buildError)) {
-      outResult->errorCode = buildError;
-      return buildError;
-    }
-    return ApplyBooleanOp(impl, stockId, tool, outResult);
+    const std::shared_ptr<AsyncOperation> op = impl->Operations().Take(operationId);
+    if (!op) return ERROR_INVALID_ARGUMENT;
+    op->cancelRequested = true;
+    op->WaitDone();
+    return ERROR_OK;
   } catch (...) {
-    outResult->errorCode = ERROR_OCCT_EXCEPTION;
     return MapExceptionToError();
   }
 }
 
-int L1_ApplyMillContour(void* kernel, int stockId,
-                        const AxisDto* axis,
-                        const Path2DSegmentDto* segments, int segmentCount, int closed,
-                        double depth,
-                        OperationResult* outResult) {
-  if (!kernel || !axis || !segments || !outResult) return ERROR_INVALID_ARGUMENT;
-  outResult->resultShapeId = outResult->deltaShapeId = outResult->removalShapeId = 0;
-  outResult->errorCode = ERROR_INVALID_ARGUMENT;
+int L1_CreatePreviewGrid(void* kernel, const StockDto* stock,
+                         const PreviewGridOptions* opt, int* outPreviewId) {
+  if (!kernel || !stock || !opt || !outPreviewId) return ERROR_INVALID_ARGUMENT;
+  if (opt->cellSize <= 0.0 || opt->threadCount < 0) return ERROR_INVALID_ARGUMENT;
+  if (stock->type != STOCK_BOX) return ERROR_FEATURE_NOT_SUPPORTED;
+  if (stock->p1 <= 0.0 || stock->p2 <= 0.0 || stock->p3 <= 0.0) return ERROR_INVALID_ARGUMENT;
+
+  const double cells = std::ceil(stock->p1 / opt->cellSize) * std::ceil(stock->p2 / opt->cellSize);
+  if (cells > kPreviewMaxCells) return ERROR_INVALID_ARGUMENT;
 
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    TopoDS_Shape tool;
-    int buildError = ERROR_OK;
-    if (!BuildMillContourTool(segments, segmentCount, closed, depth, *axis,
-                              &tool, &buildError)) {
-      outResult->errorCode = buildError;
-      return buildError;
-    }
-    return ApplyBooleanOp(impl, stockId, tool, outResult);
+    gp_Pnt origin(stock->axis.origin[0], stock->axis.origin[1], stock->axis.origin[2]);
+    gp_Dir dir   (stock->axis.dir[0],    stock->axis.dir[1],    stock->axis.dir[2]);
+    gp_Dir xdir  (stock->axis.xdir[0],   stock->axis.xdir[1],   stock->axis.xdir[2]);
+    const gp_Ax2 axis(origin, dir, xdir);
+
+    const double o[3] = {origin.X(), origin.Y(), origin.Z()};
+    const double x[3] = {axis.XDirection().X(), axis.XDirection().Y(), axis.XDirection().Z()};
+    const double y[3] = {axis.YDirection().X(), axis.YDirection().Y(), axis.YDirection().Z()};
+    const double z[3] = {axis.Direction().X(),  axis.Direction().Y(),  axis.Direction().Z()};
+    auto grid = std::make_unique<l1::ZMapGrid>(o, x, y, z, stock->p1, stock->p2, stock->p3,
+                                               opt->cellSize, opt->threadCount);
+    *outPreviewId = impl->Previews().Add(std::move(grid));
+    return ERROR_OK;
   } catch (...) {
-    outResult->errorCode = ERROR_OCCT_EXCEPTION;
     return MapExceptionToError();
   }
 }
 
-int L1_DeleteShape(void* kernel, int shapeId) {
+int L1_ClonePreviewGrid(void* kernel, int previewId, int* outPreviewId) {
+  if (!kernel || !outPreviewId) return ERROR_INVALID_ARGUMENT;
+  try {
+    auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    const auto grid = impl->Previews().Lock(previewId);
+    if (!grid) return ERROR_SHAPE_NOT_FOUND;
+    *outPreviewId = impl->Previews().Add(std::make_unique<l1::ZMapGrid>(*grid));
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int L1_DeletePreviewGrid(void* kernel, int previewId) {
   if (!kernel) return ERROR_INVALID_ARGUMENT;
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    return impl->Registry().Remove(shapeId) ? ERROR_OK : ERROR_SHAPE_NOT_FOUND;
+    return impl->Previews().Remove(previewId) ? ERROR_OK : ERROR_SHAPE_NOT_FOUND;
   } catch (...) {
     return MapExceptionToError();
   }
 }
 
-int L1_ImportStepAsShape(void* kernel,
-                         const char* filePathUtf8,
-                         int* outShapeId) {
-  if (!kernel || !filePathUtf8 || !outShapeId) return ERROR_INVALID_ARGUMENT;
+int L1_PreviewMillHole(void* kernel, int previewId, const MillHoleFeatureDto* dto) {
+  if (!kernel || !dto) return ERROR_INVALID_ARGUMENT;
+  if (dto->radius <= 0.0 || dto->depth <= 0.0) return ERROR_INVALID_ARGUMENT;
 
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    const auto grid = impl->Previews().Lock(previewId);
+    if (!grid) return ERROR_SHAPE_NOT_FOUND;
+
+    double origin[3], zBottom = 0.0, zTop = 0.0;
+    if (!ToPreviewToolFrame(*grid, dto->axis, dto->depth, origin, &zBottom, &zTop))
+      return ERROR_FEATURE_NOT_SUPPORTED;
+    grid->CutCylinder(origin[0], origin[1], dto->radius, zBottom, zTop);
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int L1_PreviewPocketRect(void* kernel, int previewId, const PocketRectFeatureDto* dto) {
+  if (!kernel || !dto) return ERROR_INVALID_ARGUMENT;
+  if (dto->width <= 0.0 || dto->height <= 0.0 || dto->depth <= 0.0)
+    return ERROR_INVALID_ARGUMENT;
 
-    STEPControl_Reader reader;
-    if (reader.ReadFile(filePathUtf8) != IFSelect_RetDone)
-      return ERROR_IMPORT_FAILED;
+  try {
+    auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    const auto grid = impl->Previews().Lock(previewId);
+    if (!grid) return ERROR_SHAPE_NOT_FOUND;
 
-    if (!reader.TransferRoots())
-      return ERROR_IMPORT_FAILED;
+    double origin[3], zBottom = 0.0, zTop = 0.0;
+    if (!ToPreviewToolFrame(*grid, dto->axis, dto->depth, origin, &zBottom, &zTop))
+      return ERROR_FEATURE_NOT_SUPPORTED;
 
-    const TopoDS_Shape shape = reader.OneShape();
-    if (shape.IsNull())
-      return ERROR_IMPORT_FAILED;
+    gp_Pnt center(dto->axis.origin[0], dto->axis.origin[1], dto->axis.origin[2]);
+    gp_Dir dir   (dto->axis.dir[0],    dto->axis.dir[1],    dto->axis.dir[2]);
+    gp_Dir xdir  (dto->axis.xdir[0],   dto->axis.xdir[1],   dto->axis.xdir[2]);
+    const gp_Ax2 frame(center, dir, xdir);
+    const gp_Vec halfX = gp_Vec(frame.XDirection()) * (0.5 * dto->width);
+    const gp_Vec halfY = gp_Vec(frame.YDirection()) * (0.5 * dto->height);
 
-    *outShapeId = impl->Registry().Add(shape);
+    l1::ZMapGrid::Loop loop;
+    AppendPreviewPoint(*grid, center.Translated(-halfX - halfY), &loop);
+    AppendPreviewPoint(*grid, center.Translated( halfX - halfY), &loop);
+    AppendPreviewPoint(*grid, center.Translated( halfX + halfY), &loop);
+    AppendPreviewPoint(*grid, center.Translated(-halfX + halfY), &loop);
+    grid->CutPolygons({loop}, zBottom, zTop);
     return ERROR_OK;
   } catch (...) {
     return MapExceptionToError();
   }
 }
 
-int L1_ExportShape(void* kernel, int shapeId,
-                   const OutputOptions* opt,
-                   const char* filePathUtf8) {
-  if (!kernel || !opt || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+int L1_PreviewMillContour(void* kernel, int previewId,
+                          const AxisDto* axis,
+                          const Path2DSegmentDto* segments, int segmentCount, int closed,
+                          double depth) {
+  if (!kernel || !axis || !segments) return ERROR_INVALID_ARGUMENT;
+  if (!closed || depth <= 0.0) return ERROR_INVALID_ARGUMENT;
 
   try {
     auto* impl = static_cast<OcctKernelImpl*>(kernel);
-    const TopoDS_Shape* shape = impl->Registry().Find(shapeId);
-    if (!shape) return ERROR_SHAPE_NOT_FOUND;
+    const auto grid = impl->Previews().Lock(previewId);
+    if (!grid) return ERROR_SHAPE_NOT_FOUND;
 
-    if (opt->format == OUT_STEP) {
-      STEPControl_Writer writer;
-      if (writer.Transfer(*shape, STEPControl_AsIs) != IFSelect_RetDone)
-        return ERROR_EXPORT_FAILED;
-      if (writer.Write(filePathUtf8) != IFSelect_RetDone)
-        return ERROR_EXPORT_FAILED;
-      return ERROR_OK;
-    }
+    int errorCode = ERROR_OK;
+    if (!ValidateSegments(segments, segmentCount, closed, *axis, PathFrameMode::kPlanarUv,
+                          &errorCode))
+      return errorCode;
 
-    if (opt->format == OUT_STL) {
-      BRepMesh_IncrementalMesh mesher(*shape, opt->linearDeflection,
-                                      opt->parallel != 0, opt->angularDeflection, true);
-      if (!mesher.IsDone()) return ERROR_EXPORT_FAILED;
-      StlAPI_Writer writer;
-      writer.Write(*shape, filePathUtf8);
-      return ERROR_OK;
-    }
+    double origin[3], zBottom = 0.0, zTop = 0.0;
+    if (!ToPreviewToolFrame(*grid, *axis, depth, origin, &zBottom, &zTop))
+      return ERROR_FEATURE_NOT_SUPPORTED;
+    grid->CutPolygons({FlattenPreviewProfile(*grid, *axis, segments, segmentCount)},
+                      zBottom, zTop);
+    return ERROR_OK;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int L1_ExportPreviewStl(void* kernel, int previewId, const char* filePathUtf8) {
+  if (!kernel || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  try {
+    auto* impl = static_cast<OcctKernelImpl*>(kernel);
+    const auto grid = impl->Previews().Lock(previewId);
+    if (!grid) return ERROR_SHAPE_NOT_FOUND;
+    return grid->WriteStl(filePathUtf8) ? ERROR_OK : ERROR_EXPORT_FAILED;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Stage mesh precompute
+// ---------------------------------------------------------------------------
+
+void l1::PrefetchFeatureTool(void* kernel, int stockId, const JobFeature* previous,
+                             const JobFeature& feature) {
+  if (kernel) PrefetchJobTool(static_cast<OcctKernelImpl*>(kernel), stockId, previous, feature);
+}
+
+int L1_BuildStageMeshes(const char* jobJsonUtf8, const StageMeshOptions* opt,
+                        char** outResultJson) {
+  if (!jobJsonUtf8 || !opt || !outResultJson) return ERROR_INVALID_ARGUMENT;
+  *outResultJson = nullptr;
+  if (!IsValidStructSize<StageMeshOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
 
+  StageMeshOptions options{};
+  options.structSize = sizeof(StageMeshOptions);
+  options.format     = OUT_STL;
+  CopyStructFields(&options, opt, opt->structSize);
+  if (!options.outDirUtf8 || *options.outDirUtf8 == '\0' || options.threadCount < 0)
     return ERROR_INVALID_ARGUMENT;
+  const OutputFormat format = options.format == 0 ? OUT_STL : options.format;
+  if (format != OUT_STL && format != OUT_QMESH) return ERROR_INVALID_ARGUMENT;
+
+  try {
+    std::vector<l1::JobEntry> jobs;
+    std::string parseError;
+    try {
+      jobs = l1::ParseJobList(jobJsonUtf8);
+      parseError = jobs.size() != 1 ? "exactly one job is required" : jobs[0].parseError;
+    } catch (const std::exception& ex) {
+      parseError = ex.what();
+    }
+    if (!parseError.empty()) {
+      std::string error = "{\"error\":";
+      l1::AppendJsonString(error, parseError);
+      error += '}';
+      *outResultJson = l1::CopyToCString(error);
+      return ERROR_INVALID_ARGUMENT;
+    }
+
+    // The boolean chain keeps one core busy; the rest mesh.
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    const int threadCount =
+        options.threadCount > 0 ? options.threadCount : std::max(1, hw - 1);
+
+    std::string json;
+    const int rc = RunStageMeshes(jobs[0].spec, threadCount, format,
+                                  std::filesystem::u8path(options.outDirUtf8), &json);
+    *outResultJson = l1::CopyToCString(json);
+    return *outResultJson ? rc : ERROR_OCCT_EXCEPTION;
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Call journal
+// ---------------------------------------------------------------------------
+
+int L1_StartJournal(const char* filePathUtf8) {
+  if (!filePathUtf8 || *filePathUtf8 == '\0') return ERROR_INVALID_ARGUMENT;
+  try {
+    return l1::journal::Start(filePathUtf8);
+  } catch (...) {
+    return MapExceptionToError();
+  }
+}
+
+int L1_StopJournal() {
+  try {
+    l1::journal::Stop();
+    return ERROR_OK;
   } catch (...) {
     return MapExceptionToError();
   }
@@ -0,0 +1,358 @@
+#include "mesh_deviation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_set>
+
+namespace l1 {
+
+namespace {
+
+constexpr int kLeafSize  = 4;
+constexpr int kMaxDepth  = 64;
+
+// Triangles this close in squared distance count as equally close.
+constexpr double kTieRelative = 1.0e-9;
+
+// Points below this count are not worth a thread.
+constexpr std::size_t kMinPointsPerThread = 4096;
+
+int ResolveThreads(int threadCount) {
+  if (threadCount > 0) return threadCount;
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+double Dot(const double a[3], const double b[3]) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision
+// Detection 5.1.5), by Voronoi region of the triangle.
+void ClosestPointOnTriangle(const double p[3], const float fa[3], const float fb[3],
+                            const float fc[3], double out[3]) {
+  const double a[3] = {fa[0], fa[1], fa[2]};
+  const double ab[3] = {fb[0] - a[0], fb[1] - a[1], fb[2] - a[2]};
+  const double ac[3] = {fc[0] - a[0], fc[1] - a[1], fc[2] - a[2]};
+  const double ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+  auto set = [out, &a, &ab, &ac](double v, double w) {
+    for (int k = 0; k < 3; ++k) out[k] = a[k] + ab[k] * v + ac[k] * w;
+  };
+
+  const double d1 = Dot(ab, ap);
+  const double d2 = Dot(ac, ap);
+  if (d1 <= 0.0 && d2 <= 0.0) return set(0.0, 0.0);
+
+  const double bp[3] = {p[0] - fb[0], p[1] - fb[1], p[2] - fb[2]};
+  const double d3 = Dot(ab, bp);
+  const double d4 = Dot(ac, bp);
+  if (d3 >= 0.0 && d4 <= d3) return set(1.0, 0.0);
+
+  const double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) return set(d1 / (d1 - d3), 0.0);
+
+  const double cp[3] = {p[0] - fc[0], p[1] - fc[1], p[2] - fc[2]};
+  const double d5 = Dot(ab, cp);
+  const double d6 = Dot(ac, cp);
+  if (d6 >= 0.0 && d5 <= d6) return set(0.0, 1.0);
+
+  const double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) return set(0.0, d2 / (d2 - d6));
+
+  const double va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+    const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return set(1.0 - w, w);
+  }
+
+  const double denom = 1.0 / (va + vb + vc);
+  set(vb * denom, vc * denom);
+}
+
+double BoxDistance2(const double p[3], const float min[3], const float max[3]) {
+  double d2 = 0.0;
+  for (int k = 0; k < 3; ++k) {
+    const double d = std::max({static_cast<double>(min[k]) - p[k], 0.0,
+                               p[k] - static_cast<double>(max[k])});
+    d2 += d * d;
+  }
+  return d2;
+}
+
+}  // namespace
+
+TriangleBvh::TriangleBvh(const std::vector<float>& positions,
+                         const std::vector<std::uint32_t>& indices, int threadCount) {
+  const std::size_t vertexCount = positions.size() / 3;
+  std::vector<Triangle>  triangles;
+  std::vector<BuildItem> items;
+  triangles.reserve(indices.size() / 3);
+  items.reserve(indices.size() / 3);
+  for (std::size_t t = 0; t + 2 < indices.size(); t += 3) {
+    if (indices[t] >= vertexCount || indices[t + 1] >= vertexCount ||
+        indices[t + 2] >= vertexCount)
+      continue;
+    Triangle tri;
+    float* corners[3] = {tri.a, tri.b, tri.c};
+    for (int v = 0; v < 3; ++v)
+      for (int k = 0; k < 3; ++k) corners[v][k] = positions[indices[t + v] * std::size_t{3} + k];
+
+    const double e1[3] = {tri.b[0] - tri.a[0], tri.b[1] - tri.a[1], tri.b[2] - tri.a[2]};
+    const double e2[3] = {tri.c[0] - tri.a[0], tri.c[1] - tri.a[1], tri.c[2] - tri.a[2]};
+    const double n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                         e1[2] * e2[0] - e1[0] * e2[2],
+                         e1[0] * e2[1] - e1[1] * e2[0]};
+    const double length = std::sqrt(Dot(n, n));
+    if (!(length > 0.0)) continue;
+    for (int k = 0; k < 3; ++k) tri.normal[k] = static_cast<float>(n[k] / length);
+
+    BuildItem item;
+    for (int k = 0; k < 3; ++k) {
+      item.min[k]      = std::min({tri.a[k], tri.b[k], tri.c[k]});
+      item.max[k]      = std::max({tri.a[k], tri.b[k], tri.c[k]});
+      item.centroid[k] = (tri.a[k] + tri.b[k] + tri.c[k]) / 3.0f;
+    }
+    item.triangle = static_cast<std::int32_t>(triangles.size());
+    triangles.push_back(tri);
+    items.push_back(item);
+  }
+  if (items.empty()) return;
+
+  // Subtrees below this depth are built on their own threads.
+  int parallelDepth = 0;
+  for (int threads = ResolveThreads(threadCount); (1 << parallelDepth) < threads;) ++parallelDepth;
+
+  nodes_.reserve(2 * items.size() / kLeafSize + 1);
+  Build(items, 0, static_cast<int>(items.size()), 0, parallelDepth, &nodes_);
+
+  triangles_.reserve(items.size());
+  for (const BuildItem& item : items) triangles_.push_back(triangles[item.triangle]);
+}
+
+// Median split along the longest centroid axis. `items` is partitioned in
+// place, so leaves address contiguous ranges of the final triangle order.
+void TriangleBvh::Build(std::vector<BuildItem>& items, int begin, int end, int depth,
+                        int parallelDepth, std::vector<Node>* nodes) {
+  Node node;
+  float cmin[3], cmax[3];
+  for (int k = 0; k < 3; ++k) {
+    node.min[k] = cmin[k] = std::numeric_limits<float>::max();
+    node.max[k] = cmax[k] = std::numeric_limits<float>::lowest();
+  }
+  for (int i = begin; i < end; ++i)
+    for (int k = 0; k < 3; ++k) {
+      node.min[k] = std::min(node.min[k], items[i].min[k]);
+      node.max[k] = std::max(node.max[k], items[i].max[k]);
+      cmin[k]     = std::min(cmin[k], items[i].centroid[k]);
+      cmax[k]     = std::max(cmax[k], items[i].centroid[k]);
+    }
+
+  const int index = static_cast<int>(nodes->size());
+  node.first = begin;
+  node.count = end - begin;
+  nodes->push_back(node);
+  if (end - begin <= kLeafSize || depth + 1 >= kMaxDepth) return;
+
+  int axis = 0;
+  for (int k = 1; k < 3; ++k)
+    if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis]) axis = k;
+  const int mid = begin + (end - begin) / 2;
+  std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                   [axis](const BuildItem& a, const BuildItem& b) {
+                     return a.centroid[axis] < b.centroid[axis];
+                   });
+
+  int right = 0;
+  if (depth < parallelDepth) {
+    std::vector<Node> leftNodes, rightNodes;
+    std::thread leftThread([&]() {
+      Build(items, begin, mid, depth + 1, parallelDepth, &leftNodes);
+    });
+    Build(items, mid, end, depth + 1, parallelDepth, &rightNodes);
+    leftThread.join();
+
+    for (const std::vector<Node>* subtree : {&leftNodes, &rightNodes}) {
+      const int offset = static_cast<int>(nodes->size());
+      if (subtree == &rightNodes) right = offset;
+      for (Node child : *subtree) {
+        if (child.count == 0) child.first += offset;
+        nodes->push_back(child);
+      }
+    }
+  } else {
+    Build(items, begin, mid, depth + 1, parallelDepth, nodes);
+    right = static_cast<int>(nodes->size());
+    Build(items, mid, end, depth + 1, parallelDepth, nodes);
+  }
+  (*nodes)[index].first = right;
+  (*nodes)[index].count = 0;
+}
+
+double TriangleBvh::SignedDistance(const double p[3], int* hint) const {
+  if (nodes_.empty()) return 0.0;
+
+  double bestD2       = std::numeric_limits<double>::max();
+  double bestPlane    = 0.0;  // signed distance of p from the deciding triangle's plane
+  int    bestTriangle = 0;
+  auto visit = [&](int i) {
+    const Triangle& tri = triangles_[i];
+    double c[3];
+    ClosestPointOnTriangle(p, tri.a, tri.b, tri.c, c);
+    const double d[3]  = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+    const double d2    = Dot(d, d);
+    const double plane = d[0] * tri.normal[0] + d[1] * tri.normal[1] + d[2] * tri.normal[2];
+    if (d2 < bestD2 * (1.0 - kTieRelative) ||
+        (d2 <= bestD2 * (1.0 + kTieRelative) && std::fabs(plane) > std::fabs(bestPlane))) {
+      bestD2       = std::min(bestD2, d2);
+      bestPlane    = plane;
+      bestTriangle = i;
+    }
+  };
+
+  // Neighbouring query points usually share their closest triangle; starting
+  // from it prunes most of the tree before the first box test.
+  if (hint && *hint >= 0 && *hint < TriangleCount()) visit(*hint);
+
+  int stack[kMaxDepth * 2];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0) {
+    const Node& node = nodes_[stack[--top]];
+    if (BoxDistance2(p, node.min, node.max) > bestD2 * (1.0 + kTieRelative)) continue;
+
+    if (node.count > 0) {
+      for (int i = node.first; i < node.first + node.count; ++i) visit(i);
+      continue;
+    }
+
+    // Nearer child on top of the stack, so it tightens bestD2 first.
+    const int left  = static_cast<int>(&node - nodes_.data()) + 1;
+    const int right = node.first;
+    const double dl = BoxDistance2(p, nodes_[left].min, nodes_[left].max);
+    const double dr = BoxDistance2(p, nodes_[right].min, nodes_[right].max);
+    const double limit = bestD2 * (1.0 + kTieRelative);
+    const int    nearChild = dl < dr ? left : right;
+    const int    farChild  = dl < dr ? right : left;
+    if (std::max(dl, dr) <= limit) stack[top++] = farChild;
+    if (std::min(dl, dr) <= limit) stack[top++] = nearChild;
+  }
+
+  if (hint) *hint = bestTriangle;
+  const double distance = std::sqrt(bestD2);
+  return bestPlane < 0.0 ? -distance : distance;
+}
+
+std::vector<float> SampleSurface(const std::vector<float>& positions,
+                                 const std::vector<std::uint32_t>& indices, double spacing,
+                                 std::size_t maxPoints) {
+  std::vector<float> points(positions);
+  const std::size_t vertexCount = positions.size() / 3;
+  auto vertex = [&](std::uint32_t v, double out[3]) {
+    for (int k = 0; k < 3; ++k) out[k] = positions[v * 3 + k];
+  };
+  auto length = [](const double a[3], const double b[3]) {
+    const double d[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    return std::sqrt(Dot(d, d));
+  };
+
+  // The grid divides the longest edge, so a right isosceles triangle of area
+  // A holds about 2A / pitch^2 points; slivers hold more.
+  double area = 0.0;
+  for (std::size_t t = 0; t + 2 < indices.size(); t += 3) {
+    double a[3], b[3], c[3];
+    vertex(indices[t], a); vertex(indices[t + 1], b); vertex(indices[t + 2], c);
+    const double u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const double w[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    const double n[3] = {u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2],
+                         u[0] * w[1] - u[1] * w[0]};
+    area += 0.5 * std::sqrt(Dot(n, n));
+  }
+  const std::size_t budget = maxPoints > vertexCount ? maxPoints - vertexCount : 1;
+  const double pitch = std::max(spacing, std::sqrt(2.0 * area / static_cast<double>(budget)));
+  if (!(pitch > 0.0)) return points;
+  constexpr int kMaxDivisions = 1024;
+  auto divisions = [&](double l) {
+    return static_cast<int>(std::min<double>(std::ceil(l / pitch), kMaxDivisions));
+  };
+  auto push = [&](const double p[3]) {
+    points.insert(points.end(), {static_cast<float>(p[0]), static_cast<float>(p[1]),
+                                 static_cast<float>(p[2])});
+  };
+
+  // An inner edge is walked once in each direction by its two triangles;
+  // only the walk from the lower vertex index samples it. Edges walked one
+  // way only (the face boundary) are sampled by their single triangle.
+  auto key = [](std::uint32_t from, std::uint32_t to) {
+    return static_cast<std::uint64_t>(from) << 32 | to;
+  };
+  std::unordered_set<std::uint64_t> directed;
+  directed.reserve(indices.size());
+  for (std::size_t t = 0; t + 2 < indices.size(); t += 3)
+    for (int e = 0; e < 3; ++e)
+      directed.insert(key(indices[t + e], indices[t + (e + 1) % 3]));
+
+  for (std::size_t t = 0; t + 2 < indices.size(); t += 3) {
+    std::uint32_t v[3] = {indices[t], indices[t + 1], indices[t + 2]};
+    if (v[0] >= vertexCount || v[1] >= vertexCount || v[2] >= vertexCount) continue;
+    double p[3][3];
+    for (int k = 0; k < 3; ++k) vertex(v[k], p[k]);
+
+    for (int e = 0; e < 3; ++e) {
+      const std::uint32_t from = v[e], to = v[(e + 1) % 3];
+      if (from > to && directed.count(key(to, from))) continue;
+      const double* a = p[e];
+      const double* b = p[(e + 1) % 3];
+      const int n = divisions(length(a, b));
+      for (int i = 1; i < n; ++i) {
+        const double s = static_cast<double>(i) / n;
+        const double q[3] = {a[0] + (b[0] - a[0]) * s, a[1] + (b[1] - a[1]) * s,
+                             a[2] + (b[2] - a[2]) * s};
+        push(q);
+      }
+    }
+
+    const int n = divisions(std::max({length(p[0], p[1]), length(p[1], p[2]),
+                                      length(p[2], p[0])}));
+    for (int i = 1; i < n; ++i) {
+      for (int j = 1; i + j < n; ++j) {
+        const double s = static_cast<double>(i) / n, r = static_cast<double>(j) / n;
+        const double q[3] = {p[0][0] + (p[1][0] - p[0][0]) * s + (p[2][0] - p[0][0]) * r,
+                             p[0][1] + (p[1][1] - p[0][1]) * s + (p[2][1] - p[0][1]) * r,
+                             p[0][2] + (p[1][2] - p[0][2]) * s + (p[2][2] - p[0][2]) * r};
+        push(q);
+      }
+    }
+  }
+  return points;
+}
+
+std::vector<float> ComputeDeviations(const TriangleBvh& bvh, const std::vector<float>& points,
+                                     int threadCount) {
+  const std::size_t count = points.size() / 3;
+  std::vector<float> deviations(count);
+  auto run = [&](std::size_t begin, std::size_t end) {
+    int hint = -1;
+    for (std::size_t i = begin; i < end; ++i) {
+      const double p[3] = {points[i * 3], points[i * 3 + 1], points[i * 3 + 2]};
+      deviations[i] = static_cast<float>(bvh.SignedDistance(p, &hint));
+    }
+  };
+
+  const std::size_t threads = std::min<std::size_t>(
+      static_cast<std::size_t>(ResolveThreads(threadCount)),
+      std::max<std::size_t>(1, count / kMinPointsPerThread));
+  if (threads <= 1) {
+    run(0, count);
+    return deviations;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (std::size_t t = 0; t < threads; ++t)
+    workers.emplace_back(run, count * t / threads, count * (t + 1) / threads);
+  for (std::thread& worker : workers) worker.join();
+  return deviations;
+}
+
+}  // namespace l1
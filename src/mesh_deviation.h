@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace l1 {
+
+// Bounding volume hierarchy over a triangle mesh, answering closest-point
+// queries for deviation analysis (see 1_funcspec.md §33). Triangles are
+// copied into leaf order, so the source buffers can be released after
+// construction. Queries are const and may run on any number of threads.
+class TriangleBvh {
+ public:
+  // positions: xyz per vertex; indices: 3 per triangle, counter-clockwise
+  // seen from outside. Degenerate triangles are dropped.
+  TriangleBvh(const std::vector<float>& positions, const std::vector<std::uint32_t>& indices,
+              int threadCount);
+
+  int TriangleCount() const { return static_cast<int>(triangles_.size()); }
+
+  // Distance from `p` to the closest triangle, positive on the outer side
+  // of that triangle. Where several triangles are equally close (an edge or
+  // vertex is closest) the one whose plane is farthest from `p` decides the
+  // sign, which is the correct side at convex and concave edges alike.
+  // Returns 0 for an empty mesh. `hint` (optional) is a triangle index
+  // tried first and receives the closest triangle, which speeds up runs of
+  // nearby points.
+  double SignedDistance(const double p[3], int* hint = nullptr) const;
+
+ private:
+  struct Triangle {
+    float a[3], b[3], c[3];
+    float normal[3];  // unit, outward
+  };
+
+  struct Node {
+    float        min[3];
+    float        max[3];
+    std::int32_t first;  // leaf: first triangle; inner: right child (left is this + 1)
+    std::int32_t count;  // 0 for inner nodes
+  };
+
+  struct BuildItem {
+    float        min[3], max[3], centroid[3];
+    std::int32_t triangle;
+  };
+
+  static void Build(std::vector<BuildItem>& items, int begin, int end, int depth,
+                    int parallelDepth, std::vector<Node>* nodes);
+
+  std::vector<Triangle> triangles_;
+  std::vector<Node>     nodes_;
+};
+
+// Points spread over the mesh surface, xyz per point: the vertices first
+// (in vertex order), then points along every edge longer than `spacing` and
+// inside every triangle wider than it, on a grid of about that pitch.
+// Vertices alone miss the middle of large triangles, where the other surface
+// can bulge away undetected. The pitch is coarsened so that the result stays
+// at about `maxPoints`.
+std::vector<float> SampleSurface(const std::vector<float>& positions,
+                                 const std::vector<std::uint32_t>& indices, double spacing,
+                                 std::size_t maxPoints);
+
+// Signed deviation of every point (xyz per point) from the mesh, computed
+// on `threadCount` threads (0: hardware concurrency).
+std::vector<float> ComputeDeviations(const TriangleBvh& bvh, const std::vector<float>& points,
+                                     int threadCount);
+
+}  // namespace l1
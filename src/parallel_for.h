@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace l1 {
+
+// Threads ParallelFor runs `count` items on: `threadCount` (0: hardware
+// concurrency), at most one per item and at least one.
+inline int ParallelThreadCount(int count, int threadCount) {
+  const int hw = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  return std::max(1, std::min(threadCount > 0 ? threadCount : hw, count));
+}
+
+// Calls fn(index, worker) for every index in [0, count) on
+// ParallelThreadCount(count, threadCount) threads, the calling thread being
+// worker 0. Indices are handed out one at a time, so a few slow items do not
+// hold up the rest. fn must not throw. When fewer threads can be started,
+// the started ones drain the list.
+template <typename Fn>
+void ParallelFor(int count, int threadCount, Fn&& fn) {
+  const int threads = ParallelThreadCount(count, threadCount);
+  std::atomic<int> next{0};
+  auto worker = [&](int id) {
+    for (int i = next++; i < count; i = next++) fn(i, id);
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  try {
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+  } catch (...) {
+  }
+  worker(0);
+  for (std::thread& thread : pool) thread.join();
+}
+
+}  // namespace l1
@@ -0,0 +1,141 @@
+#include "quantized_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifdef L1_WITH_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace l1 {
+namespace qmesh {
+
+namespace {
+
+void AppendU16(std::string& out, std::uint16_t value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendVarint(std::string& out, std::uint32_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+std::uint32_t ZigZag(std::int64_t delta) {
+  const auto d = static_cast<std::int32_t>(delta);
+  return (static_cast<std::uint32_t>(d) << 1) ^ static_cast<std::uint32_t>(d >> 31);
+}
+
+std::uint8_t ToUnorm8(float v) {
+  return static_cast<std::uint8_t>(std::lround((std::clamp(v, -1.0f, 1.0f) * 0.5f + 0.5f) * 255.0f));
+}
+
+// Octahedral mapping: project onto |x|+|y|+|z| = 1 and fold the lower half
+// over the diagonals, so two bytes cover the sphere evenly.
+void AppendOctahedral(std::string& out, float x, float y, float z) {
+  const float sum = std::fabs(x) + std::fabs(y) + std::fabs(z);
+  float u = sum > 0.0f ? x / sum : 0.0f;
+  float v = sum > 0.0f ? y / sum : 0.0f;
+  if (z < 0.0f) {
+    const float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    const float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    u = fu;
+    v = fv;
+  }
+  out += static_cast<char>(ToUnorm8(u));
+  out += static_cast<char>(ToUnorm8(v));
+}
+
+#ifdef L1_WITH_ZLIB
+bool Deflate(const std::string& raw, std::string* out) {
+  uLongf size = compressBound(static_cast<uLong>(raw.size()));
+  out->resize(size);
+  if (compress2(reinterpret_cast<Bytef*>(&(*out)[0]), &size,
+                reinterpret_cast<const Bytef*>(raw.data()), static_cast<uLong>(raw.size()),
+                Z_DEFAULT_COMPRESSION) != Z_OK)
+    return false;
+  out->resize(size);
+  return true;
+}
+#endif
+
+}  // namespace
+
+std::string Encode(const MeshBuffers& mesh, int positionBits, bool withNormals) {
+  if (positionBits < 1 || positionBits > 16) positionBits = kDefaultPositionBits;
+  const std::size_t vertexCount = mesh.positions.size() / 3;
+  withNormals = withNormals && mesh.normals.size() == mesh.positions.size();
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version       = kVersion;
+  header.vertexCount   = static_cast<std::uint32_t>(vertexCount);
+  header.triangleCount = static_cast<std::uint32_t>(mesh.indices.size() / 3);
+  header.positionBits  = static_cast<std::uint32_t>(positionBits);
+  for (int c = 0; c < 3; ++c) {
+    header.min[c] = vertexCount ? std::numeric_limits<float>::max() : 0.0f;
+    header.max[c] = vertexCount ? std::numeric_limits<float>::lowest() : 0.0f;
+  }
+  for (std::size_t i = 0; i < vertexCount; ++i)
+    for (int c = 0; c < 3; ++c) {
+      header.min[c] = std::min(header.min[c], mesh.positions[i * 3 + c]);
+      header.max[c] = std::max(header.max[c], mesh.positions[i * 3 + c]);
+    }
+
+  std::string body;
+  body.reserve(vertexCount * (withNormals ? 8 : 6) + mesh.indices.size() * 2);
+
+  const double steps = static_cast<double>((1u << positionBits) - 1u);
+  for (int c = 0; c < 3; ++c) {
+    const double extent = static_cast<double>(header.max[c]) - header.min[c];
+    const double scale  = extent > 0.0 ? steps / extent : 0.0;
+    std::uint16_t previous = 0;
+    for (std::size_t i = 0; i < vertexCount; ++i) {
+      const double offset = static_cast<double>(mesh.positions[i * 3 + c]) - header.min[c];
+      const auto q = static_cast<std::uint16_t>(std::min(std::lround(offset * scale),
+                                                         static_cast<long>(steps)));
+      AppendU16(body, static_cast<std::uint16_t>(q - previous));
+      previous = q;
+    }
+  }
+
+  if (withNormals) {
+    header.flags |= kFlagNormals;
+    for (std::size_t i = 0; i < vertexCount; ++i)
+      AppendOctahedral(body, mesh.normals[i * 3], mesh.normals[i * 3 + 1], mesh.normals[i * 3 + 2]);
+  }
+
+  std::int64_t previous = 0;
+  for (std::size_t i = 0; i < header.triangleCount * std::size_t{3}; ++i) {
+    AppendVarint(body, ZigZag(static_cast<std::int64_t>(mesh.indices[i]) - previous));
+    previous = mesh.indices[i];
+  }
+
+  if (vertexCount > 0 && mesh.scalars.size() == vertexCount) {
+    header.flags |= kFlagScalars;
+    body.append(reinterpret_cast<const char*>(mesh.scalars.data()),
+                mesh.scalars.size() * sizeof(float));
+  }
+
+  header.rawBodySize = static_cast<std::uint32_t>(body.size());
+#ifdef L1_WITH_ZLIB
+  std::string packed;
+  if (Deflate(body, &packed) && packed.size() < body.size()) {
+    header.flags |= kFlagDeflate;
+    body.swap(packed);
+  }
+#endif
+  header.bodySize = static_cast<std::uint32_t>(body.size());
+
+  std::string out(reinterpret_cast<const char*>(&header), sizeof(header));
+  out += body;
+  return out;
+}
+
+}  // namespace qmesh
+}  // namespace l1
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace l1 {
+namespace qmesh {
+
+// Quantized mesh file (OUT_QMESH, see 1_funcspec.md §30). A Header is
+// followed by `bodySize` bytes of body, deflate-compressed (zlib stream) when
+// kFlagDeflate is set. The raw body is:
+//   positions  three planes (x[], y[], z[]) of u16 grid coordinates, each
+//              value stored as the difference to the previous vertex mod 2^16
+//   normals    (kFlagNormals) two u8 octahedral coordinates per vertex
+//   indices    3 per triangle, LEB128 varints of zigzag(index - previous index)
+//   scalars    (kFlagScalars) one float32 per vertex, e.g. deviation for
+//              colouring; last, so readers unaware of the flag still decode
+//              the mesh
+// Grid coordinate q maps back to min + q * (max - min) / (2^positionBits - 1).
+// All values are little-endian.
+
+constexpr char          kMagic[4] = {'L', '1', 'Q', 'M'};
+constexpr std::uint16_t kVersion  = 1;
+
+enum Flags : std::uint16_t {
+  kFlagDeflate = 1,
+  kFlagNormals = 2,
+  kFlagScalars = 4,
+};
+
+struct Header {
+  char          magic[4];
+  std::uint16_t version;
+  std::uint16_t flags;
+  std::uint32_t vertexCount;
+  std::uint32_t triangleCount;
+  std::uint32_t positionBits;
+  std::uint32_t bodySize;
+  std::uint32_t rawBodySize;
+  float         min[3];
+  float         max[3];
+};
+static_assert(sizeof(Header) == 52, "Header layout is part of the file format");
+
+struct MeshBuffers {
+  std::vector<float>         positions;  // xyz per vertex
+  std::vector<float>         normals;    // xyz per vertex, unit length; empty: none
+  std::vector<std::uint32_t> indices;    // 3 per triangle, counter-clockwise from outside
+  std::vector<float>         scalars;    // one per vertex; empty: none
+};
+
+constexpr int kDefaultPositionBits = 16;
+
+// positionBits outside 1..16 falls back to kDefaultPositionBits. Normals are
+// written only when `withNormals` is set and the buffers carry them; scalars
+// whenever the buffers carry one per vertex. The body
+// is compressed when the build has zlib (L1_WITH_ZLIB) and that makes it
+// smaller.
+std::string Encode(const MeshBuffers& mesh, int positionBits, bool withNormals);
+
+}  // namespace qmesh
+}  // namespace l1
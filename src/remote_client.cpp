@@ -0,0 +1,456 @@
+#include "l1_geometry_remote.h"
+#include "call_journal.h"
+#include "l1_error_codes.h"
+#include "worker_protocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace {
+
+using l1::journal::Call;
+using l1::journal::PayloadReader;
+using l1::journal::PayloadWriter;
+using l1::worker::LocalSocket;
+
+const char* kWorkerSocketEnv = "L1_WORKER_SOCKET";
+const char* kWorkerCountEnv  = "L1_WORKER_COUNT";
+
+// ---------------------------------------------------------------------------
+// Endpoint
+// ---------------------------------------------------------------------------
+
+struct Endpoint {
+  std::string socketPath;
+  int         workerCount = 0;  // 0: socketPath is a single worker
+};
+
+std::mutex            gEndpointMutex;
+std::atomic<unsigned> gNextWorker{0};
+
+Endpoint& EndpointConfig() {
+  static Endpoint endpoint = [] {
+    Endpoint e;
+    if (const char* path = std::getenv(kWorkerSocketEnv)) e.socketPath = path;
+    if (const char* count = std::getenv(kWorkerCountEnv)) e.workerCount = std::max(std::atoi(count), 0);
+    return e;
+  }();
+  return endpoint;
+}
+
+// Tries each pool member once, starting round-robin, so new kernels spread
+// over the pool and skip a worker that is being restarted.
+LocalSocket ConnectToWorker() {
+  Endpoint endpoint;
+  {
+    std::lock_guard<std::mutex> lock(gEndpointMutex);
+    endpoint = EndpointConfig();
+  }
+  if (endpoint.socketPath.empty()) return LocalSocket();
+
+  const int      attempts = std::max(endpoint.workerCount, 1);
+  const unsigned first    = gNextWorker++;
+  for (int i = 0; i < attempts; ++i) {
+    const int index = endpoint.workerCount > 0
+                          ? static_cast<int>((first + static_cast<unsigned>(i)) %
+                                             static_cast<unsigned>(endpoint.workerCount))
+                          : -1;
+    LocalSocket socket =
+        LocalSocket::Connect(l1::worker::WorkerSocketPath(endpoint.socketPath, index));
+    l1::worker::ResponseHeader hello{};
+    std::string payload;
+    if (socket.Valid() && l1::worker::RecvFrame(socket, &hello, &payload) &&
+        hello.returnCode == static_cast<std::int32_t>(l1::worker::kProtocolVersion))
+      return socket;
+  }
+  return LocalSocket();
+}
+
+// ---------------------------------------------------------------------------
+// Remote kernel
+// ---------------------------------------------------------------------------
+
+// One connection to a worker. Calls on the same handle are serialised; the
+// connection is dropped for good on the first I/O failure.
+class RemoteKernel {
+ public:
+  explicit RemoteKernel(LocalSocket socket) : socket_(std::move(socket)) {}
+
+  int Exchange(Call call, const std::string& request, std::string* response) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!socket_.Valid()) return ERROR_WORKER_UNAVAILABLE;
+
+    l1::worker::RequestHeader header{};
+    header.call = static_cast<std::uint16_t>(call);
+    l1::worker::ResponseHeader reply{};
+    if (!l1::worker::SendFrame(socket_, header, request) ||
+        !l1::worker::RecvFrame(socket_, &reply, response)) {
+      socket_.Close();
+      response->clear();
+      return ERROR_WORKER_UNAVAILABLE;
+    }
+    return reply.returnCode;
+  }
+
+ private:
+  std::mutex  mutex_;
+  LocalSocket socket_;
+};
+
+// Sends `request` and hands the response outputs (if any) to `decode`.
+template <typename Decode>
+int Invoke(void* kernel, Call call, PayloadWriter& request, Decode&& decode) {
+  try {
+    std::string response;
+    const int rc = static_cast<RemoteKernel*>(kernel)->Exchange(call, request.Take(), &response);
+    if (!response.empty()) {
+      PayloadReader in(response.data(), response.size());
+      decode(in);
+    }
+    return rc;
+  } catch (...) {
+    return ERROR_WORKER_UNAVAILABLE;
+  }
+}
+
+int Invoke(void* kernel, Call call, PayloadWriter& request) {
+  return Invoke(kernel, call, request, [](PayloadReader&) {});
+}
+
+template <typename T>
+bool IsValidStructSize(int structSize) {
+  return structSize >= static_cast<int>(sizeof(int)) &&
+         structSize <= static_cast<int>(sizeof(T));
+}
+
+// Copies the fields of `value` up to the caller's structSize.
+template <typename T>
+void CopyVersioned(const T& value, T* out) {
+  std::memcpy(reinterpret_cast<char*>(out) + sizeof(int),
+              reinterpret_cast<const char*>(&value) + sizeof(int),
+              static_cast<std::size_t>(out->structSize) - sizeof(int));
+}
+
+// Copies a versioned struct returned by the worker, keeping the caller's
+// structSize.
+template <typename T>
+void ReadVersioned(PayloadReader& in, T* out) {
+  T value{};
+  in.GetVersioned(&value);
+  CopyVersioned(value, out);
+}
+
+int ApplyFeature(void* kernel, Call call, PayloadWriter& request, OperationResult* outResult) {
+  if (!IsValidStructSize<OperationResult>(outResult->structSize)) return ERROR_INVALID_ARGUMENT;
+  const int rc = Invoke(kernel, call, request, [outResult](PayloadReader& in) {
+    ReadVersioned(in, outResult);
+  });
+  if (rc == ERROR_WORKER_UNAVAILABLE) {
+    OperationResult failed{};
+    failed.errorCode = rc;
+    CopyVersioned(failed, outResult);
+  }
+  return rc;
+}
+
+int ApplyProfile(void* kernel, Call call, int stockId, const AxisDto* axis,
+                 const Path2DSegmentDto* segments, int segmentCount, int closed,
+                 const double* depth, OperationResult* outResult) {
+  if (!kernel || !axis || !segments || !outResult || segmentCount <= 0)
+    return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(stockId).Put(*axis)
+         .PutBlob(segments, sizeof(Path2DSegmentDto) * static_cast<std::size_t>(segmentCount))
+         .Put(closed);
+  if (depth) request.Put(*depth);
+  return ApplyFeature(kernel, call, request, outResult);
+}
+
+}  // namespace
+
+// ===========================================================================
+// Public API
+// ===========================================================================
+
+int L1_SetWorkerEndpoint(const char* socketPathUtf8, int workerCount) {
+  if (!socketPathUtf8 || *socketPathUtf8 == '\0' || workerCount < 0) return ERROR_INVALID_ARGUMENT;
+  std::lock_guard<std::mutex> lock(gEndpointMutex);
+  EndpointConfig() = Endpoint{socketPathUtf8, workerCount};
+  return ERROR_OK;
+}
+
+void* L1_CreateKernel() {
+  LocalSocket socket = ConnectToWorker();
+  if (!socket.Valid()) return nullptr;
+  return new (std::nothrow) RemoteKernel(std::move(socket));
+}
+
+int L1_DestroyKernel(void* kernel) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  delete static_cast<RemoteKernel*>(kernel);  // the worker resets and pools the kernel
+  return ERROR_OK;
+}
+
+int L1_ResetKernel(void* kernel) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  return Invoke(kernel, Call::kResetKernel, request);
+}
+
+int L1_SetKernelOptions(void* kernel, const KernelOptions* opt) {
+  if (!kernel || !opt) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<KernelOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.PutBlob(opt, static_cast<std::size_t>(opt->structSize));
+  return Invoke(kernel, Call::kSetKernelOptions, request);
+}
+
+int L1_GetKernelOptions(void* kernel, KernelOptions* outOpt) {
+  if (!kernel || !outOpt) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<KernelOptions>(outOpt->structSize)) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  return Invoke(kernel, Call::kGetKernelOptions, request, [outOpt](PayloadReader& in) {
+    ReadVersioned(in, outOpt);
+  });
+}
+
+int L1_CreateStock(void* kernel, const StockDto* dto, int* outStockId) {
+  if (!kernel || !dto || !outStockId) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(*dto);
+  *outStockId = 0;
+  return Invoke(kernel, Call::kCreateStock, request, [outStockId](PayloadReader& in) {
+    *outStockId = in.Get<int>();
+  });
+}
+
+int L1_ApplyMillHole(void* kernel, int stockId,
+                     const MillHoleFeatureDto* dto,
+                     OperationResult* outResult) {
+  if (!kernel || !dto || !outResult) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(stockId).Put(*dto);
+  return ApplyFeature(kernel, Call::kApplyMillHole, request, outResult);
+}
+
+int L1_ApplyPocketRect(void* kernel, int stockId,
+                       const PocketRectFeatureDto* dto,
+                       OperationResult* outResult) {
+  if (!kernel || !dto || !outResult) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(stockId).Put(*dto);
+  return ApplyFeature(kernel, Call::kApplyPocketRect, request, outResult);
+}
+
+int L1_ApplyTurnOd(void* kernel, int stockId,
+                   const AxisDto* axis,
+                   const Path2DSegmentDto* segments, int segmentCount, int closed,
+                   OperationResult* outResult) {
+  return ApplyProfile(kernel, Call::kApplyTurnOd, stockId, axis, segments, segmentCount,
+                      closed, nullptr, outResult);
+}
+
+int L1_ApplyTurnId(void* kernel, int stockId,
+                   const AxisDto* axis,
+                   const Path2DSegmentDto* segments, int segmentCount, int closed,
+                   OperationResult* outResult) {
+  return ApplyProfile(kernel, Call::kApplyTurnId, stockId, axis, segments, segmentCount,
+                      closed, nullptr, outResult);
+}
+
+int L1_ApplyMillContour(void* kernel, int stockId,
+                        const AxisDto* axis,
+                        const Path2DSegmentDto* segments, int segmentCount, int closed,
+                        double depth,
+                        OperationResult* outResult) {
+  return ApplyProfile(kernel, Call::kApplyMillContour, stockId, axis, segments, segmentCount,
+                      closed, &depth, outResult);
+}
+
+int L1_ApplyMillSlot(void* kernel, int stockId,
+                     const AxisDto* axis,
+                     const Path2DSegmentDto* segments, int segmentCount,
+                     double toolRadius, double depth,
+                     OperationResult* outResult) {
+  if (!kernel || !axis || !segments || !outResult || segmentCount <= 0)
+    return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(stockId).Put(*axis)
+         .PutBlob(segments, sizeof(Path2DSegmentDto) * static_cast<std::size_t>(segmentCount))
+         .Put(toolRadius).Put(depth);
+  return ApplyFeature(kernel, Call::kApplyMillSlot, request, outResult);
+}
+
+int L1_DeleteShape(void* kernel, int shapeId) {
+  if (!kernel) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(shapeId);
+  return Invoke(kernel, Call::kDeleteShape, request);
+}
+
+int L1_ValidateShape(void* kernel, int shapeId,
+                     const ValidationOptions* opt,
+                     ValidationReport* outReport) {
+  if (!kernel || !opt || !outReport) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<ValidationOptions>(opt->structSize) ||
+      !IsValidStructSize<ValidationReport>(outReport->structSize))
+    return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(shapeId)
+         .PutBlob(opt, static_cast<std::size_t>(opt->structSize))
+         .Put(outReport->structSize);
+  return Invoke(kernel, Call::kValidateShape, request, [outReport](PayloadReader& in) {
+    ReadVersioned(in, outReport);
+  });
+}
+
+int L1_CompareShapes(void* kernel, int shapeId, int referenceId,
+                     const CompareOptions* opt,
+                     const char* deviationMeshFileUtf8,
+                     CompareReport* outReport) {
+  if (!kernel || !opt || !outReport) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<CompareOptions>(opt->structSize) ||
+      !IsValidStructSize<CompareReport>(outReport->structSize))
+    return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(shapeId)
+         .Put(referenceId)
+         .PutBlob(opt, static_cast<std::size_t>(opt->structSize))
+         .PutString(deviationMeshFileUtf8)
+         .Put(outReport->structSize);
+  return Invoke(kernel, Call::kCompareShapes, request, [outReport](PayloadReader& in) {
+    ReadVersioned(in, outReport);
+  });
+}
+
+int L1_ComputeMassProperties(void* kernel, const int* shapeIds, int shapeCount,
+                             const MassPropertiesOptions* opt, MassProperties* outProps) {
+  if (!kernel || !opt || shapeCount < 0) return ERROR_INVALID_ARGUMENT;
+  if (shapeCount > 0 && (!shapeIds || !outProps)) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<MassPropertiesOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.PutBlob(shapeIds, sizeof(int) * static_cast<std::size_t>(shapeCount))
+         .PutBlob(opt, static_cast<std::size_t>(opt->structSize));
+  return Invoke(kernel, Call::kComputeMassProperties, request,
+                [outProps, shapeCount](PayloadReader& in) {
+    const std::vector<MassProperties> props = in.GetArray<MassProperties>();
+    std::copy_n(props.begin(), std::min<std::size_t>(props.size(), shapeCount), outProps);
+  });
+}
+
+int L1_SectionShape(void* kernel, int shapeId, const SectionOptions* opt,
+                    SectionPlane* outPlanes, Path2DSegmentDto* outSegments,
+                    int segmentCapacity, int* outSegmentCount) {
+  if (!kernel || !opt || !outPlanes || !outSegmentCount || segmentCapacity < 0)
+    return ERROR_INVALID_ARGUMENT;
+  if (segmentCapacity > 0 && !outSegments) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<SectionOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  *outSegmentCount = 0;
+  PayloadWriter request;
+  request.Put(shapeId)
+         .PutBlob(opt, static_cast<std::size_t>(opt->structSize))
+         .Put(segmentCapacity);
+  return Invoke(kernel, Call::kSectionShape, request,
+                [outPlanes, outSegments, segmentCapacity, outSegmentCount](PayloadReader& in) {
+    const std::vector<SectionPlane> planes = in.GetArray<SectionPlane>();  // opt->planeCount
+    std::copy(planes.begin(), planes.end(), outPlanes);
+    const std::vector<Path2DSegmentDto> segments = in.GetArray<Path2DSegmentDto>();
+    std::copy_n(segments.begin(), std::min<std::size_t>(segments.size(), segmentCapacity),
+                outSegments);
+    *outSegmentCount = in.Get<int>();
+  });
+}
+
+int L1_QueryClearance(void* kernel, int shapeId, int otherId,
+                      const double* offsets, int placementCount,
+                      const ClearanceOptions* opt, ClearanceResult* outResults) {
+  if (!kernel || !opt || !outResults || placementCount < 1) return ERROR_INVALID_ARGUMENT;
+  if (!offsets && placementCount != 1) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<ClearanceOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(shapeId).Put(otherId)
+         .PutBlob(offsets, offsets ? sizeof(double) * 3 * static_cast<std::size_t>(placementCount) : 0)
+         .Put(placementCount)
+         .PutBlob(opt, static_cast<std::size_t>(opt->structSize));
+  return Invoke(kernel, Call::kQueryClearance, request,
+                [outResults, placementCount](PayloadReader& in) {
+    const std::vector<ClearanceResult> results = in.GetArray<ClearanceResult>();
+    std::copy_n(results.begin(), std::min<std::size_t>(results.size(), placementCount), outResults);
+  });
+}
+
+int L1_ImportStepAsShape(void* kernel,
+                         const char* filePathUtf8,
+                         int* outShapeId) {
+  if (!kernel || !filePathUtf8 || !outShapeId) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.PutString(filePathUtf8);
+  *outShapeId = 0;
+  return Invoke(kernel, Call::kImportStep, request, [outShapeId](PayloadReader& in) {
+    *outShapeId = in.Get<int>();
+  });
+}
+
+int L1_ImportStepAsShapeEx(void* kernel,
+                           const char* filePathUtf8,
+                           const ImportOptions* opt,
+                           int* outShapeId) {
+  if (!kernel || !filePathUtf8 || !opt || !outShapeId) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<ImportOptions>(opt->structSize)) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.PutString(filePathUtf8).PutBlob(opt, static_cast<std::size_t>(opt->structSize));
+  *outShapeId = 0;
+  return Invoke(kernel, Call::kImportStepEx, request, [outShapeId](PayloadReader& in) {
+    *outShapeId = in.Get<int>();
+  });
+}
+
+int L1_ExportShape(void* kernel,
+                   int shapeId,
+                   const OutputOptions* opt,
+                   const char* filePathUtf8) {
+  if (!kernel || !opt || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(shapeId).Put(*opt).PutString(filePathUtf8);
+  return Invoke(kernel, Call::kExportShape, request);
+}
+
+int L1_ExportShapeEx(void* kernel, int shapeId,
+                     OutputFormat format, const MeshOptions* mesh,
+                     const char* filePathUtf8,
+                     MeshStats* outStats) {
+  if (!kernel || !mesh || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  if (!IsValidStructSize<MeshOptions>(mesh->structSize)) return ERROR_INVALID_ARGUMENT;
+  if (outStats && !IsValidStructSize<MeshStats>(outStats->structSize)) return ERROR_INVALID_ARGUMENT;
+
+  // The stats struct size travels with the request so the worker fills the
+  // same fields the caller asked for (0: no stats).
+  PayloadWriter request;
+  request.Put(shapeId).Put(format)
+         .PutBlob(mesh, static_cast<std::size_t>(mesh->structSize))
+         .PutString(filePathUtf8)
+         .Put(outStats ? outStats->structSize : 0);
+  return Invoke(kernel, Call::kExportShapeEx, request, [outStats](PayloadReader& in) {
+    if (outStats) ReadVersioned(in, outStats);
+  });
+}
+
+int L1_ExportStepBodies(void* kernel,
+                        const StepBodyDto* bodies, int bodyCount,
+                        const char* assemblyNameUtf8,
+                        const char* filePathUtf8) {
+  if (!kernel || !bodies || bodyCount <= 0 || !filePathUtf8) return ERROR_INVALID_ARGUMENT;
+  PayloadWriter request;
+  request.Put(bodyCount);
+  for (int i = 0; i < bodyCount; ++i)
+    request.Put(bodies[i].shapeId).PutString(bodies[i].nameUtf8).Put(bodies[i].hasColor)
+           .Put(bodies[i].rgb[0]).Put(bodies[i].rgb[1]).Put(bodies[i].rgb[2]);
+  request.PutString(assemblyNameUtf8).PutString(filePathUtf8);
+  return Invoke(kernel, Call::kExportStepBodies, request);
+}
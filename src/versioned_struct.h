@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+namespace l1 {
+
+// Versioned option structs start with `int structSize` (the caller's
+// sizeof). Only the fields both sides know are copied.
+template <typename T>
+bool IsValidStructSize(int structSize) {
+  return structSize >= static_cast<int>(sizeof(int)) &&
+         structSize <= static_cast<int>(sizeof(T));
+}
+
+inline void CopyStructFields(void* dst, const void* src, int structSize) {
+  std::memcpy(static_cast<char*>(dst) + sizeof(int),
+              static_cast<const char*>(src) + sizeof(int),
+              static_cast<std::size_t>(structSize) - sizeof(int));
+}
+
+}  // namespace l1
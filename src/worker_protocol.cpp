@@ -0,0 +1,155 @@
+#include "worker_protocol.h"
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <winsock2.h>
+  #include <afunix.h>
+#else
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+namespace l1 {
+namespace worker {
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+
+bool EnsureStarted() {
+  static const bool started = [] {
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+  }();
+  return started;
+}
+
+void CloseNative(NativeSocket s) { closesocket(s); }
+#else
+using NativeSocket = int;
+
+bool EnsureStarted() { return true; }
+
+void CloseNative(NativeSocket s) { ::close(s); }
+#endif
+
+NativeSocket ToNative(std::uintptr_t handle) { return static_cast<NativeSocket>(handle); }
+
+bool MakeAddress(const std::string& pathUtf8, sockaddr_un* addr) {
+  std::memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (pathUtf8.empty() || pathUtf8.size() >= sizeof(addr->sun_path)) return false;
+  std::memcpy(addr->sun_path, pathUtf8.data(), pathUtf8.size());
+  return true;
+}
+
+}  // namespace
+
+std::string WorkerSocketPath(const std::string& base, int index) {
+  return index < 0 ? base : base + "." + std::to_string(index);
+}
+
+LocalSocket::~LocalSocket() { Close(); }
+
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept : handle_(other.handle_) {
+  other.handle_ = kInvalid;
+}
+
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+  if (this != &other) {
+    Close();
+    handle_ = other.handle_;
+    other.handle_ = kInvalid;
+  }
+  return *this;
+}
+
+LocalSocket LocalSocket::Listen(const std::string& pathUtf8) {
+  sockaddr_un addr;
+  if (!EnsureStarted() || !MakeAddress(pathUtf8, &addr)) return LocalSocket();
+
+  std::error_code ec;
+  std::filesystem::remove(std::filesystem::u8path(pathUtf8), ec);
+
+  const NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  LocalSocket socket(static_cast<std::uintptr_t>(s));
+  if (!socket.Valid()) return LocalSocket();
+  if (::bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(s, SOMAXCONN) != 0)
+    return LocalSocket();
+  return socket;
+}
+
+LocalSocket LocalSocket::Connect(const std::string& pathUtf8) {
+  sockaddr_un addr;
+  if (!EnsureStarted() || !MakeAddress(pathUtf8, &addr)) return LocalSocket();
+
+  const NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  LocalSocket socket(static_cast<std::uintptr_t>(s));
+  if (!socket.Valid()) return LocalSocket();
+  if (::connect(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+    return LocalSocket();
+  return socket;
+}
+
+LocalSocket LocalSocket::Accept() const {
+  if (!Valid()) return LocalSocket();
+  const NativeSocket s = ::accept(ToNative(handle_), nullptr, nullptr);
+  return LocalSocket(static_cast<std::uintptr_t>(s));
+}
+
+bool LocalSocket::Valid() const {
+#ifdef _WIN32
+  return handle_ != kInvalid && ToNative(handle_) != INVALID_SOCKET;
+#else
+  return handle_ != kInvalid && ToNative(handle_) >= 0;
+#endif
+}
+
+bool LocalSocket::SendAll(const void* data, std::size_t size) {
+  const char* p = static_cast<const char*>(data);
+  while (size > 0) {
+    const int chunk = static_cast<int>(size < (1u << 30) ? size : (1u << 30));
+#ifdef _WIN32
+    const int n = ::send(ToNative(handle_), p, chunk, 0);
+#else
+    const ssize_t n = ::send(ToNative(handle_), p, static_cast<std::size_t>(chunk), MSG_NOSIGNAL);
+#endif
+    if (n <= 0) return false;
+    p    += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool LocalSocket::RecvAll(void* data, std::size_t size) {
+  char* p = static_cast<char*>(data);
+  while (size > 0) {
+    const int chunk = static_cast<int>(size < (1u << 30) ? size : (1u << 30));
+#ifdef _WIN32
+    const int n = ::recv(ToNative(handle_), p, chunk, 0);
+#else
+    const ssize_t n = ::recv(ToNative(handle_), p, static_cast<std::size_t>(chunk), 0);
+#endif
+    if (n <= 0) return false;
+    p    += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+void LocalSocket::Close() {
+  if (Valid()) CloseNative(ToNative(handle_));
+  handle_ = kInvalid;
+}
+
+}  // namespace worker
+}  // namespace l1
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace l1 {
+namespace worker {
+
+// Wire protocol between l1_geometry_remote (client) and occt_geometry_worker
+// (see 1_funcspec.md §27). One connection is one kernel: the worker assigns
+// a warm kernel on accept, answers with a hello frame and then serves
+// request/response pairs in order until the client disconnects.
+//
+// A request is a RequestHeader plus a payload holding the call's inputs in
+// the call journal encoding (journal::PayloadWriter); the response is a
+// ResponseHeader plus the call's outputs in the same encoding.
+
+constexpr std::uint32_t kProtocolVersion = 2;
+constexpr std::uint32_t kMaxPayloadBytes = 64 * 1024 * 1024;
+
+struct RequestHeader {
+  std::uint32_t payloadSize;
+  std::uint16_t call;  // journal::Call
+  std::uint16_t reserved;
+};
+
+struct ResponseHeader {
+  std::uint32_t payloadSize;
+  std::int32_t  returnCode;  // ErrorCode; the hello frame carries kProtocolVersion
+};
+
+static_assert(sizeof(RequestHeader) == 8 && sizeof(ResponseHeader) == 8,
+              "frame headers are part of the wire format");
+
+// Socket path of pool member `index` ("<base>.<index>"); `base` itself when
+// index < 0 (a single unsupervised worker).
+std::string WorkerSocketPath(const std::string& base, int index);
+
+// AF_UNIX stream socket (Winsock on Windows 10 1803+, POSIX elsewhere).
+// Move-only; closes on destruction.
+class LocalSocket {
+ public:
+  LocalSocket() = default;
+  ~LocalSocket();
+  LocalSocket(LocalSocket&& other) noexcept;
+  LocalSocket& operator=(LocalSocket&& other) noexcept;
+  LocalSocket(const LocalSocket&)            = delete;
+  LocalSocket& operator=(const LocalSocket&) = delete;
+
+  // Replaces a stale socket file left by a crashed worker.
+  static LocalSocket Listen(const std::string& pathUtf8);
+  static LocalSocket Connect(const std::string& pathUtf8);
+
+  LocalSocket Accept() const;
+
+  bool Valid() const;
+  bool SendAll(const void* data, std::size_t size);
+  bool RecvAll(void* data, std::size_t size);
+  void Close();
+
+ private:
+  explicit LocalSocket(std::uintptr_t handle) : handle_(handle) {}
+
+  std::uintptr_t handle_ = kInvalid;
+  static constexpr std::uintptr_t kInvalid = ~std::uintptr_t(0);
+};
+
+// Header and payload in one call; false when the peer is gone.
+template <typename Header>
+bool SendFrame(LocalSocket& socket, Header header, const std::string& payload) {
+  header.payloadSize = static_cast<std::uint32_t>(payload.size());
+  return socket.SendAll(&header, sizeof(header)) &&
+         (payload.empty() || socket.SendAll(payload.data(), payload.size()));
+}
+
+template <typename Header>
+bool RecvFrame(LocalSocket& socket, Header* header, std::string* payload) {
+  if (!socket.RecvAll(header, sizeof(*header))) return false;
+  if (header->payloadSize > kMaxPayloadBytes) return false;
+  payload->resize(header->payloadSize);
+  return header->payloadSize == 0 || socket.RecvAll(&(*payload)[0], payload->size());
+}
+
+}  // namespace worker
+}  // namespace l1
@@ -0,0 +1,340 @@
+#include "zmap_preview.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace l1 {
+
+namespace {
+
+constexpr float kHeightEps = 1.0e-5f;
+
+// Rows below this count are not worth a thread.
+constexpr int kMinRowsPerThread = 16;
+
+// Process-wide helper threads for ZMapGrid::ForEachRow. A preview cut takes
+// well under a millisecond, less than starting and joining its threads, so
+// the helpers are started on first use (up to the hardware concurrency - 1)
+// and kept. Several grids may run rows at once; each call is a batch that
+// idle helpers join until it has as many as it asked for. Never destroyed:
+// joining threads during static destruction can deadlock under the loader
+// lock, and idle helpers only ever wait on the condition variable.
+class RowPool {
+ public:
+  static RowPool& Instance() {
+    static RowPool* const pool = new RowPool;
+    return *pool;
+  }
+
+  // Calls fn(row) for every row in [0, rows) on the calling thread and up
+  // to `helpers` pool threads; returns when all rows are done.
+  void Run(int rows, int helpers, const std::function<void(int)>& fn) {
+    Batch batch;
+    batch.fn     = &fn;
+    batch.rows   = rows;
+    batch.wanted = helpers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      StartThreads(helpers);
+      batches_.push_back(&batch);
+    }
+    workCv_.notify_all();
+    Drain(batch);
+
+    // No helper joins once the batch is off the list; wait for the ones
+    // still finishing a row.
+    std::unique_lock<std::mutex> lock(mutex_);
+    batches_.erase(std::find(batches_.begin(), batches_.end(), &batch));
+    doneCv_.wait(lock, [&batch] { return batch.active == 0; });
+  }
+
+ private:
+  struct Batch {
+    const std::function<void(int)>* fn = nullptr;
+    int              rows   = 0;
+    int              wanted = 0;  // helpers still welcome
+    int              active = 0;  // helpers working on it
+    std::atomic<int> next{0};
+  };
+
+  static void Drain(Batch& batch) {
+    for (int row = batch.next++; row < batch.rows; row = batch.next++) (*batch.fn)(row);
+  }
+
+  // Called with mutex_ held.
+  void StartThreads(int wanted) {
+    const int hw  = static_cast<int>(std::thread::hardware_concurrency());
+    const int cap = std::min(wanted, std::max(1, hw - 1));
+    try {
+      while (threadCount_ < cap) {
+        std::thread([this] { Loop(); }).detach();
+        ++threadCount_;
+      }
+    } catch (...) {
+      // Fewer helpers; the caller drains the rest itself.
+    }
+  }
+
+  Batch* FindWork() const {
+    for (Batch* batch : batches_)
+      if (batch->wanted > 0 && batch->next.load() < batch->rows) return batch;
+    return nullptr;
+  }
+
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      workCv_.wait(lock, [this] { return FindWork() != nullptr; });
+      Batch* batch = FindWork();
+      --batch->wanted;
+      ++batch->active;
+      lock.unlock();
+      Drain(*batch);
+      lock.lock();
+      if (--batch->active == 0) doneCv_.notify_all();
+    }
+  }
+
+  std::mutex              mutex_;
+  std::condition_variable workCv_;
+  std::condition_variable doneCv_;
+  std::vector<Batch*>     batches_;
+  int                     threadCount_ = 0;
+};
+
+struct MeshTriangle {
+  float normal[3];
+  float v[3][3];
+};
+
+struct LocalPoint { double x, y, z; };
+
+// Splits a planar quad into two triangles wound counter-clockwise around the
+// requested normal. Everything stays in the grid's local frame.
+void EmitQuad(std::vector<MeshTriangle>& out, const LocalPoint corners[4],
+              const double normal[3]) {
+  const LocalPoint& a = corners[0];
+  const LocalPoint& b = corners[1];
+  const LocalPoint& c = corners[2];
+  const double e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+  const double e2[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+  const double cross[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                           e1[2] * e2[0] - e1[0] * e2[2],
+                           e1[0] * e2[1] - e1[1] * e2[0]};
+  const bool flip = cross[0] * normal[0] + cross[1] * normal[1] + cross[2] * normal[2] < 0.0;
+  const int order[4] = {0, flip ? 3 : 1, 2, flip ? 1 : 3};
+
+  const int tris[2][3] = {{order[0], order[1], order[2]}, {order[0], order[2], order[3]}};
+  for (const auto& tri : tris) {
+    MeshTriangle t;
+    for (int k = 0; k < 3; ++k) t.normal[k] = static_cast<float>(normal[k]);
+    for (int v = 0; v < 3; ++v) {
+      const LocalPoint& p = corners[tri[v]];
+      t.v[v][0] = static_cast<float>(p.x);
+      t.v[v][1] = static_cast<float>(p.y);
+      t.v[v][2] = static_cast<float>(p.z);
+    }
+    out.push_back(t);
+  }
+}
+
+}  // namespace
+
+ZMapGrid::ZMapGrid(const double origin[3], const double xdir[3], const double ydir[3],
+                   const double zdir[3], double sizeX, double sizeY, double sizeZ,
+                   double cellSize, int threadCount)
+    : sizeZ_(sizeZ), cell_(cellSize) {
+  for (int k = 0; k < 3; ++k) {
+    origin_[k]   = origin[k];
+    axes_[0][k]  = xdir[k];
+    axes_[1][k]  = ydir[k];
+    axes_[2][k]  = zdir[k];
+  }
+  nx_    = std::max(1, static_cast<int>(std::ceil(sizeX / cellSize)));
+  ny_    = std::max(1, static_cast<int>(std::ceil(sizeY / cellSize)));
+  cellX_ = sizeX / nx_;
+  cellY_ = sizeY / ny_;
+
+  const int hw = static_cast<int>(std::thread::hardware_concurrency());
+  threads_ = threadCount > 0 ? threadCount : std::max(1, hw);
+
+  heights_.assign(static_cast<std::size_t>(nx_) * ny_, static_cast<float>(sizeZ));
+}
+
+void ZMapGrid::ToLocalPoint(const double world[3], double local[3]) const {
+  const double d[3] = {world[0] - origin_[0], world[1] - origin_[1], world[2] - origin_[2]};
+  ToLocalVector(d, local);
+}
+
+void ZMapGrid::ToLocalVector(const double world[3], double local[3]) const {
+  for (int a = 0; a < 3; ++a)
+    local[a] = world[0] * axes_[a][0] + world[1] * axes_[a][1] + world[2] * axes_[a][2];
+}
+
+void ZMapGrid::ToWorld(double x, double y, double z, float out[3]) const {
+  for (int k = 0; k < 3; ++k)
+    out[k] = static_cast<float>(origin_[k] + x * axes_[0][k] + y * axes_[1][k] + z * axes_[2][k]);
+}
+
+template <typename RowFn>
+void ZMapGrid::ForEachRow(RowFn fn) const {
+  const int threads = std::min(threads_, std::max(1, ny_ / kMinRowsPerThread));
+  if (threads <= 1) {
+    for (int j = 0; j < ny_; ++j) fn(j);
+    return;
+  }
+  RowPool::Instance().Run(ny_, threads - 1, std::function<void(int)>(fn));
+}
+
+// Lowers every cell whose centre lies in the span and whose surface the tool
+// reaches. Kept branch-free so the compiler can vectorise the inner loop.
+void ZMapGrid::CutSpan(float* row, const Span& span, float zBottom, float zTop) const {
+  const int i0 = std::max(0,       static_cast<int>(std::ceil (span.x0 / cellX_ - 0.5)));
+  const int i1 = std::min(nx_ - 1, static_cast<int>(std::floor(span.x1 / cellX_ - 0.5)));
+  for (int i = i0; i <= i1; ++i) {
+    const float h = row[i];
+    row[i] = (zTop >= h - kHeightEps && zBottom < h) ? zBottom : h;
+  }
+}
+
+template <typename SpanFn>
+void ZMapGrid::CutRows(double zBottom, double zTop, SpanFn spansForRow) {
+  const float zb = static_cast<float>(std::max(zBottom, 0.0));
+  const float zt = static_cast<float>(zTop);
+  if (zt <= 0.0f || zb >= static_cast<float>(sizeZ_)) return;
+
+  float* heights = heights_.data();
+  ForEachRow([&](int j) {
+    std::vector<Span> spans;
+    spansForRow((j + 0.5) * cellY_, spans);
+    float* row = heights + static_cast<std::size_t>(j) * nx_;
+    for (const Span& span : spans) CutSpan(row, span, zb, zt);
+  });
+}
+
+void ZMapGrid::CutCylinder(double centerX, double centerY, double radius,
+                           double zBottom, double zTop) {
+  CutRows(zBottom, zTop, [=](double y, std::vector<Span>& spans) {
+    const double dy = y - centerY;
+    if (std::fabs(dy) >= radius) return;
+    const double half = std::sqrt(radius * radius - dy * dy);
+    spans.push_back({centerX - half, centerX + half});
+  });
+}
+
+void ZMapGrid::CutPolygons(const std::vector<Loop>& loops, double zBottom, double zTop) {
+  CutRows(zBottom, zTop, [&loops](double y, std::vector<Span>& spans) {
+    std::vector<double> crossings;
+    for (const Loop& loop : loops) {
+      const std::size_t n = loop.size();
+      for (std::size_t k = 0; k < n; ++k) {
+        const Point2& p = loop[k];
+        const Point2& q = loop[(k + 1) % n];
+        if ((p.y <= y) == (q.y <= y)) continue;
+        crossings.push_back(p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+    for (std::size_t k = 0; k + 1 < crossings.size(); k += 2)
+      spans.push_back({crossings[k], crossings[k + 1]});
+  });
+}
+
+bool ZMapGrid::WriteStl(const std::string& filePathUtf8) const {
+  std::vector<std::vector<MeshTriangle>> rows(ny_);
+  const float* heights = heights_.data();
+  auto at = [&](int i, int j) -> float {
+    if (i < 0 || j < 0 || i >= nx_ || j >= ny_) return 0.0f;
+    return heights[static_cast<std::size_t>(j) * nx_ + i];
+  };
+
+  ForEachRow([&](int j) {
+    std::vector<MeshTriangle>& out = rows[j];
+    const double y0 = j * cellY_;
+    const double y1 = (j + 1) * cellY_;
+
+    // Top and bottom faces, merged over runs of equal height.
+    for (int i = 0; i < nx_;) {
+      const float h = at(i, j);
+      int end = i + 1;
+      while (end < nx_ && at(end, j) == h) ++end;
+      if (h > 0.0f) {
+        const double x0 = i * cellX_, x1 = end * cellX_;
+        const LocalPoint top[4]    = {{x0, y0, h}, {x1, y0, h}, {x1, y1, h}, {x0, y1, h}};
+        const LocalPoint bottom[4] = {{x0, y0, 0}, {x1, y0, 0}, {x1, y1, 0}, {x0, y1, 0}};
+        const double up[3] = {0, 0, 1}, down[3] = {0, 0, -1};
+        EmitQuad(out, top,    up);
+        EmitQuad(out, bottom, down);
+      }
+      i = end;
+    }
+
+    // Walls between this row's cells along x (including both stock ends).
+    for (int i = 0; i <= nx_; ++i) {
+      const float hl = at(i - 1, j);
+      const float hr = at(i, j);
+      if (hl == hr) continue;
+      const double x  = i * cellX_;
+      const double lo = std::min(hl, hr), hi = std::max(hl, hr);
+      const LocalPoint wall[4] = {{x, y0, lo}, {x, y1, lo}, {x, y1, hi}, {x, y0, hi}};
+      const double normal[3] = {hl > hr ? 1.0 : -1.0, 0, 0};
+      EmitQuad(out, wall, normal);
+    }
+
+    // Walls on this row's lower y boundary, plus the far stock side for the
+    // last row, merged over runs of equal height pairs.
+    for (int boundary = j; boundary <= (j == ny_ - 1 ? j + 1 : j); ++boundary) {
+      const double y = boundary * cellY_;
+      for (int i = 0; i < nx_;) {
+        const float hb = at(i, boundary - 1);
+        const float ht = at(i, boundary);
+        int end = i + 1;
+        while (end < nx_ && at(end, boundary - 1) == hb && at(end, boundary) == ht) ++end;
+        if (hb != ht) {
+          const double x0 = i * cellX_, x1 = end * cellX_;
+          const double lo = std::min(hb, ht), hi = std::max(hb, ht);
+          const LocalPoint wall[4] = {{x0, y, lo}, {x1, y, lo}, {x1, y, hi}, {x0, y, hi}};
+          const double normal[3] = {0, hb > ht ? 1.0 : -1.0, 0};
+          EmitQuad(out, wall, normal);
+        }
+        i = end;
+      }
+    }
+  });
+
+  std::ofstream ofs(filePathUtf8, std::ios::binary | std::ios::trunc);
+  if (!ofs) return false;
+
+  char header[80] = {};
+  std::strncpy(header, "l1_geometry_kernel z-map preview", sizeof(header) - 1);
+  ofs.write(header, sizeof(header));
+
+  std::uint32_t count = 0;
+  for (const auto& row : rows) count += static_cast<std::uint32_t>(row.size());
+  ofs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+  const std::uint16_t attribute = 0;
+  for (const auto& row : rows) {
+    for (const MeshTriangle& tri : row) {
+      float world[4][3];
+      for (int k = 0; k < 3; ++k)
+        world[0][k] = static_cast<float>(tri.normal[0] * axes_[0][k] +
+                                         tri.normal[1] * axes_[1][k] +
+                                         tri.normal[2] * axes_[2][k]);
+      for (int v = 0; v < 3; ++v) ToWorld(tri.v[v][0], tri.v[v][1], tri.v[v][2], world[v + 1]);
+      ofs.write(reinterpret_cast<const char*>(world),      sizeof(world));
+      ofs.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+    }
+  }
+  return static_cast<bool>(ofs);
+}
+
+}  // namespace l1
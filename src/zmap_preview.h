@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace l1 {
+
+// Height field over the top face of a box stock, used for approximate stage
+// previews. The grid lives in the stock's local frame: x along the stock
+// xdir, y along dir x xdir, z along dir, with the box spanning
+// [0,sizeX] x [0,sizeY] x [0,sizeZ]. Each cell stores the material height of
+// its column; 0 means the column has been cut through.
+//
+// Only material reachable from the top is represented: a tool whose top is
+// below the current surface of a cell leaves that cell untouched.
+class ZMapGrid {
+ public:
+  struct Point2 { double x, y; };
+  using Loop = std::vector<Point2>;
+
+  ZMapGrid(const double origin[3], const double xdir[3], const double ydir[3],
+           const double zdir[3], double sizeX, double sizeY, double sizeZ,
+           double cellSize, int threadCount);
+
+  int    CellsX()   const { return nx_; }
+  int    CellsY()   const { return ny_; }
+  double CellSize() const { return cell_; }
+
+  // World point / direction -> stock local frame.
+  void ToLocalPoint(const double world[3], double local[3]) const;
+  void ToLocalVector(const double world[3], double local[3]) const;
+
+  void CutCylinder(double centerX, double centerY, double radius,
+                   double zBottom, double zTop);
+
+  // Closed polygons in local xy, combined with the even-odd rule.
+  void CutPolygons(const std::vector<Loop>& loops, double zBottom, double zTop);
+
+  // Binary STL of the column surface, in world coordinates.
+  bool WriteStl(const std::string& filePathUtf8) const;
+
+ private:
+  struct Span { double x0, x1; };
+
+  template <typename SpanFn>
+  void CutRows(double zBottom, double zTop, SpanFn spansForRow);
+
+  template <typename RowFn>
+  void ForEachRow(RowFn fn) const;
+
+  void CutSpan(float* row, const Span& span, float zBottom, float zTop) const;
+  void ToWorld(double x, double y, double z, float out[3]) const;
+
+  double origin_[3];
+  double axes_[3][3];
+  double sizeZ_;
+  double cell_;
+  double cellX_;
+  double cellY_;
+  int    nx_;
+  int    ny_;
+  int    threads_;
+  std::vector<float> heights_;
+};
+
+}  // namespace l1
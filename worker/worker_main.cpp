@@ -0,0 +1,630 @@
+#include "l1_geometry_kernel.h"
+#include "call_journal.h"
+#include "l1_error_codes.h"
+#include "worker_protocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <sys/types.h>
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using l1::journal::Call;
+using l1::journal::PayloadReader;
+using l1::journal::PayloadWriter;
+using l1::worker::LocalSocket;
+
+constexpr int kExitUsage   = 1;
+constexpr int kExitListen  = 2;
+constexpr int kExitRunaway = 3;
+constexpr int kExitAccept  = 4;
+
+// 起動直後に落ちるワーカーを連続再起動しないための待ち
+constexpr auto kQuickExit    = std::chrono::seconds(2);
+constexpr auto kRestartDelay = std::chrono::seconds(1);
+constexpr auto kPollInterval = std::chrono::milliseconds(200);
+
+// accept の連続失敗（EMFILE など）は待ち時間を倍々にして再試行し、
+// 続くようなら終了してスーパーバイザに再起動させる
+constexpr auto kAcceptBackoffMin = std::chrono::milliseconds(10);
+constexpr auto kAcceptBackoffMax = std::chrono::seconds(1);
+constexpr auto kAcceptGiveUp     = std::chrono::seconds(30);
+
+struct WorkerOptions {
+  std::string socketPath;
+  int         pool         = 0;    // > 0: この数のワーカープロセスを監視するだけ
+  int         warm         = 2;    // 起動時に用意するカーネル数
+  long long   maxRequestMs = 0;    // > 0: 1 要求がこれを超えたらプロセスごと終了
+};
+
+std::atomic<bool> gStop{false};
+
+void OnStopSignal(int) { gStop = true; }
+
+// ---------------------------------------------------------------------------
+// カーネルプール
+// ---------------------------------------------------------------------------
+
+// 接続ごとに 1 カーネルを貸し出す。返却時にリセットして次の接続で再利用する。
+class KernelPool {
+ public:
+  ~KernelPool() {
+    for (void* kernel : idle_) L1_DestroyKernel(kernel);
+  }
+
+  // OCCT の初回ロード・初期化をここで済ませる（穴 1 個の演算まで通す）
+  void Warm(int count) {
+    for (int i = 0; i < count; ++i) {
+      void* kernel = L1_CreateKernel();
+      if (!kernel) break;
+
+      StockDto stock{};
+      stock.type = STOCK_BOX;
+      stock.p1 = stock.p2 = stock.p3 = 10.0;
+      stock.axis.dir[2]  = 1.0;
+      stock.axis.xdir[0] = 1.0;
+      MillHoleFeatureDto hole{};
+      hole.radius = 1.0;
+      hole.depth  = 5.0;
+      hole.axis.origin[0] = hole.axis.origin[1] = 5.0;
+      hole.axis.origin[2] = 10.0;
+      hole.axis.dir[2]    = -1.0;
+      hole.axis.xdir[0]   = 1.0;
+
+      int stockId = 0;
+      OperationResult result{};
+      result.structSize = sizeof(result);
+      if (L1_CreateStock(kernel, &stock, &stockId) == ERROR_OK)
+        L1_ApplyMillHole(kernel, stockId, &hole, &result);
+      Release(kernel);
+    }
+  }
+
+  void* Acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        void* kernel = idle_.back();
+        idle_.pop_back();
+        return kernel;
+      }
+    }
+    return L1_CreateKernel();
+  }
+
+  // 前の接続の形状と設定を残さない
+  void Release(void* kernel) {
+    KernelOptions defaults{};
+    defaults.structSize = sizeof(defaults);
+    if (L1_ResetKernel(kernel) != ERROR_OK ||
+        L1_SetKernelOptions(kernel, &defaults) != ERROR_OK) {
+      L1_DestroyKernel(kernel);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(kernel);
+  }
+
+ private:
+  std::mutex         mutex_;
+  std::vector<void*> idle_;
+};
+
+// ---------------------------------------------------------------------------
+// 暴走監視
+// ---------------------------------------------------------------------------
+
+// 要求の処理中は開始時刻（steady_clock の tick）、待機中は 0 を持つ。
+using BusySlot = std::shared_ptr<std::atomic<Clock::rep>>;
+
+// OCCT の演算は途中で止められないため、上限を超えた要求があればプロセスを
+// 終了してスーパーバイザに再起動させる（同じプロセスの他の接続も切れる）。
+class Watchdog {
+ public:
+  explicit Watchdog(long long limitMs)
+      : limitMs_(limitMs), limit_(std::chrono::milliseconds(limitMs)) {
+    if (limitMs > 0) std::thread([this] { Loop(); }).detach();
+  }
+
+  BusySlot Register() {
+    auto slot = std::make_shared<std::atomic<Clock::rep>>(0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.push_back(slot);
+    return slot;
+  }
+
+  void Unregister(const BusySlot& slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.remove(slot);
+  }
+
+ private:
+  void Loop() {
+    while (true) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      const Clock::rep now = Clock::now().time_since_epoch().count();
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const BusySlot& slot : slots_) {
+        const Clock::rep since = slot->load();
+        if (since != 0 && Clock::duration(now - since) > limit_) {
+          std::cerr << "Request exceeded " << limitMs_ << " ms; exiting" << std::endl;
+          std::_Exit(kExitRunaway);
+        }
+      }
+    }
+  }
+
+  const long long        limitMs_;
+  const Clock::duration  limit_;
+  std::mutex             mutex_;
+  std::list<BusySlot>    slots_;
+};
+
+// ---------------------------------------------------------------------------
+// 要求の処理
+// ---------------------------------------------------------------------------
+
+// バージョン付き構造体は受け取ったバイト数までを上書きし、structSize も揃える
+template <typename T>
+T ReadVersioned(PayloadReader& in) {
+  T value{};
+  in.GetVersioned(&value);
+  value.structSize = std::min<int>(value.structSize, sizeof(T));
+  return value;
+}
+
+int Dispatch(void* kernel, Call call, PayloadReader& in, PayloadWriter& out) {
+  switch (call) {
+    case Call::kResetKernel:
+      return L1_ResetKernel(kernel);
+    case Call::kSetKernelOptions: {
+      const KernelOptions opt = ReadVersioned<KernelOptions>(in);
+      return L1_SetKernelOptions(kernel, &opt);
+    }
+    case Call::kGetKernelOptions: {
+      KernelOptions opt{};
+      opt.structSize = sizeof(opt);
+      const int rc = L1_GetKernelOptions(kernel, &opt);
+      out.PutBlob(&opt, sizeof(opt));
+      return rc;
+    }
+    case Call::kCreateStock: {
+      const StockDto dto = in.Get<StockDto>();
+      int id = 0;
+      const int rc = L1_CreateStock(kernel, &dto, &id);
+      out.Put(id);
+      return rc;
+    }
+    case Call::kApplyMillHole: {
+      const int stockId = in.Get<int>();
+      const MillHoleFeatureDto dto = in.Get<MillHoleFeatureDto>();
+      OperationResult result{};
+      result.structSize = sizeof(result);
+      const int rc = L1_ApplyMillHole(kernel, stockId, &dto, &result);
+      out.PutBlob(&result, sizeof(result));
+      return rc;
+    }
+    case Call::kApplyPocketRect: {
+      const int stockId = in.Get<int>();
+      const PocketRectFeatureDto dto = in.Get<PocketRectFeatureDto>();
+      OperationResult result{};
+      result.structSize = sizeof(result);
+      const int rc = L1_ApplyPocketRect(kernel, stockId, &dto, &result);
+      out.PutBlob(&result, sizeof(result));
+      return rc;
+    }
+    case Call::kApplyTurnOd:
+    case Call::kApplyTurnId:
+    case Call::kApplyMillContour: {
+      const int stockId = in.Get<int>();
+      const AxisDto axis = in.Get<AxisDto>();
+      const std::vector<Path2DSegmentDto> segments = in.GetArray<Path2DSegmentDto>();
+      const int closed = in.Get<int>();
+      const int count  = static_cast<int>(segments.size());
+      if (count == 0) return ERROR_INVALID_ARGUMENT;
+      OperationResult result{};
+      result.structSize = sizeof(result);
+      int rc = 0;
+      if (call == Call::kApplyMillContour) {
+        const double depth = in.Get<double>();
+        rc = L1_ApplyMillContour(kernel, stockId, &axis, segments.data(), count, closed,
+                                 depth, &result);
+      } else if (call == Call::kApplyTurnOd) {
+        rc = L1_ApplyTurnOd(kernel, stockId, &axis, segments.data(), count, closed, &result);
+      } else {
+        rc = L1_ApplyTurnId(kernel, stockId, &axis, segments.data(), count, closed, &result);
+      }
+      out.PutBlob(&result, sizeof(result));
+      return rc;
+    }
+    case Call::kApplyMillSlot: {
+      const int stockId = in.Get<int>();
+      const AxisDto axis = in.Get<AxisDto>();
+      const std::vector<Path2DSegmentDto> segments = in.GetArray<Path2DSegmentDto>();
+      const double toolRadius = in.Get<double>();
+      const double depth      = in.Get<double>();
+      if (segments.empty()) return ERROR_INVALID_ARGUMENT;
+      OperationResult result{};
+      result.structSize = sizeof(result);
+      const int rc = L1_ApplyMillSlot(kernel, stockId, &axis, segments.data(),
+                                      static_cast<int>(segments.size()), toolRadius, depth,
+                                      &result);
+      out.PutBlob(&result, sizeof(result));
+      return rc;
+    }
+    case Call::kDeleteShape:
+      return L1_DeleteShape(kernel, in.Get<int>());
+    case Call::kValidateShape: {
+      const int shapeId = in.Get<int>();
+      const ValidationOptions opt = ReadVersioned<ValidationOptions>(in);
+      ValidationReport report{};
+      report.structSize = std::min<int>(in.Get<int>(), sizeof(report));
+      const int rc = L1_ValidateShape(kernel, shapeId, &opt, &report);
+      out.PutBlob(&report, static_cast<std::size_t>(std::max(report.structSize, 0)));
+      return rc;
+    }
+    case Call::kCompareShapes: {
+      const int shapeId     = in.Get<int>();
+      const int referenceId = in.Get<int>();
+      const CompareOptions opt = ReadVersioned<CompareOptions>(in);
+      const std::string meshPath = in.GetString();
+      CompareReport report{};
+      report.structSize = std::min<int>(in.Get<int>(), sizeof(report));
+      const int rc = L1_CompareShapes(kernel, shapeId, referenceId, &opt,
+                                      meshPath.empty() ? nullptr : meshPath.c_str(), &report);
+      out.PutBlob(&report, static_cast<std::size_t>(std::max(report.structSize, 0)));
+      return rc;
+    }
+    case Call::kComputeMassProperties: {
+      const std::vector<int> shapeIds = in.GetArray<int>();
+      const MassPropertiesOptions opt = ReadVersioned<MassPropertiesOptions>(in);
+      std::vector<MassProperties> props(shapeIds.size());
+      const int rc = L1_ComputeMassProperties(kernel, shapeIds.data(),
+                                              static_cast<int>(shapeIds.size()), &opt,
+                                              props.data());
+      out.PutBlob(props.data(), sizeof(MassProperties) * props.size());
+      return rc;
+    }
+    case Call::kSectionShape: {
+      const int shapeId = in.Get<int>();
+      const SectionOptions opt = ReadVersioned<SectionOptions>(in);
+      const int segmentCapacity = in.Get<int>();
+      if (opt.planeCount < 1 || segmentCapacity < 0) return ERROR_INVALID_ARGUMENT;
+      std::vector<SectionPlane> planes(static_cast<std::size_t>(opt.planeCount));
+      std::vector<Path2DSegmentDto> segments(static_cast<std::size_t>(segmentCapacity));
+      int segmentCount = 0;
+      const int rc = L1_SectionShape(kernel, shapeId, &opt, planes.data(),
+                                     segments.empty() ? nullptr : segments.data(),
+                                     segmentCapacity, &segmentCount);
+      segments.resize(rc == ERROR_OK ? static_cast<std::size_t>(segmentCount) : 0);
+      out.PutBlob(planes.data(), sizeof(SectionPlane) * planes.size())
+         .PutBlob(segments.data(), sizeof(Path2DSegmentDto) * segments.size())
+         .Put(segmentCount);
+      return rc;
+    }
+    case Call::kQueryClearance: {
+      const int shapeId = in.Get<int>();
+      const int otherId = in.Get<int>();
+      const std::vector<double> offsets = in.GetArray<double>();
+      const int placementCount = in.Get<int>();
+      const ClearanceOptions opt = ReadVersioned<ClearanceOptions>(in);
+      if (placementCount < 1 ||
+          (!offsets.empty() && offsets.size() != static_cast<std::size_t>(placementCount) * 3))
+        return ERROR_INVALID_ARGUMENT;
+      std::vector<ClearanceResult> results(static_cast<std::size_t>(placementCount));
+      const int rc = L1_QueryClearance(kernel, shapeId, otherId,
+                                       offsets.empty() ? nullptr : offsets.data(),
+                                       placementCount, &opt, results.data());
+      out.PutBlob(results.data(), sizeof(ClearanceResult) * results.size());
+      return rc;
+    }
+    case Call::kImportStep: {
+      const std::string path = in.GetString();
+      int id = 0;
+      const int rc = L1_ImportStepAsShape(kernel, path.c_str(), &id);
+      out.Put(id);
+      return rc;
+    }
+    case Call::kImportStepEx: {
+      const std::string path = in.GetString();
+      const ImportOptions opt = ReadVersioned<ImportOptions>(in);
+      int id = 0;
+      const int rc = L1_ImportStepAsShapeEx(kernel, path.c_str(), &opt, &id);
+      out.Put(id);
+      return rc;
+    }
+    case Call::kExportShape: {
+      const int shapeId = in.Get<int>();
+      const OutputOptions opt = in.Get<OutputOptions>();
+      const std::string path = in.GetString();
+      return L1_ExportShape(kernel, shapeId, &opt, path.c_str());
+    }
+    case Call::kExportShapeEx: {
+      const int shapeId = in.Get<int>();
+      const OutputFormat format = in.Get<OutputFormat>();
+      const MeshOptions mesh = ReadVersioned<MeshOptions>(in);
+      const std::string path = in.GetString();
+      const int statsSize = in.Get<int>();
+      MeshStats stats{};
+      stats.structSize = std::min<int>(statsSize, sizeof(stats));
+      const int rc = L1_ExportShapeEx(kernel, shapeId, format, &mesh, path.c_str(),
+                                      statsSize > 0 ? &stats : nullptr);
+      if (statsSize > 0) out.PutBlob(&stats, static_cast<std::size_t>(stats.structSize));
+      return rc;
+    }
+    case Call::kExportStepBodies: {
+      const int count = in.Get<int>();
+      if (count <= 0) return ERROR_INVALID_ARGUMENT;
+      std::vector<std::string> names(static_cast<std::size_t>(count));
+      std::vector<StepBodyDto> bodies(names.size());
+      for (std::size_t i = 0; i < bodies.size(); ++i) {
+        bodies[i].shapeId  = in.Get<int>();
+        names[i]           = in.GetString();
+        bodies[i].nameUtf8 = names[i].c_str();
+        bodies[i].hasColor = in.Get<int>();
+        for (double& c : bodies[i].rgb) c = in.Get<double>();
+      }
+      const std::string assemblyName = in.GetString();
+      const std::string path = in.GetString();
+      return L1_ExportStepBodies(kernel, bodies.data(), count, assemblyName.c_str(), path.c_str());
+    }
+    case Call::kCreateKernel:
+    case Call::kDestroyKernel:
+      break;  // 接続の確立・切断がカーネルの生成・破棄に当たる
+    case Call::kForkKernel:
+      break;  // 形状はワーカーのプロセス内にしかなく、接続をまたいで共有できない
+  }
+  return ERROR_FEATURE_NOT_SUPPORTED;
+}
+
+void ServeConnection(LocalSocket socket, KernelPool& pool, Watchdog& watchdog) {
+  void* kernel = pool.Acquire();
+
+  l1::worker::ResponseHeader hello{};
+  hello.returnCode = kernel ? static_cast<std::int32_t>(l1::worker::kProtocolVersion)
+                            : ERROR_WORKER_UNAVAILABLE;
+  if (!l1::worker::SendFrame(socket, hello, std::string()) || !kernel) {
+    if (kernel) pool.Release(kernel);
+    return;
+  }
+
+  const BusySlot busy = watchdog.Register();
+  l1::worker::RequestHeader request{};
+  std::string payload;
+  while (l1::worker::RecvFrame(socket, &request, &payload)) {
+    busy->store(Clock::now().time_since_epoch().count());
+    PayloadWriter out;
+    int rc = ERROR_OK;
+    try {
+      PayloadReader in(payload.data(), payload.size());
+      rc = Dispatch(kernel, static_cast<Call>(request.call), in, out);
+    } catch (const std::exception&) {
+      out = PayloadWriter();
+      rc = ERROR_INVALID_ARGUMENT;  // 壊れた要求
+    }
+    busy->store(0);
+
+    l1::worker::ResponseHeader response{};
+    response.returnCode = rc;
+    if (!l1::worker::SendFrame(socket, response, out.Take())) break;
+  }
+  watchdog.Unregister(busy);
+  pool.Release(kernel);
+}
+
+int RunWorker(const WorkerOptions& options) {
+  LocalSocket listener = LocalSocket::Listen(options.socketPath);
+  if (!listener.Valid()) {
+    std::cerr << "Failed to listen on " << options.socketPath << std::endl;
+    return kExitListen;
+  }
+
+  KernelPool pool;
+  pool.Warm(options.warm);
+  Watchdog watchdog(options.maxRequestMs);
+  std::cerr << "Worker listening on " << options.socketPath << std::endl;
+
+  // 接続ごとに 1 スレッド。カーネル間は独立なので並行に処理できる
+  std::chrono::milliseconds backoff = kAcceptBackoffMin;
+  Clock::time_point failingSince{};
+  while (true) {
+    LocalSocket connection = listener.Accept();
+    if (!connection.Valid()) {
+      const Clock::time_point now = Clock::now();
+      if (failingSince == Clock::time_point{}) failingSince = now;
+      if (now - failingSince > kAcceptGiveUp) {
+        std::cerr << "Accept keeps failing on " << options.socketPath << "; exiting" << std::endl;
+        // 接続スレッドは pool を参照したまま動いているので、return せずに終わる
+        L1_StopJournal();
+        std::_Exit(kExitAccept);
+      }
+      std::this_thread::sleep_for(backoff);
+      backoff = std::min<std::chrono::milliseconds>(backoff * 2, kAcceptBackoffMax);
+      continue;
+    }
+    backoff      = kAcceptBackoffMin;
+    failingSince = Clock::time_point{};
+    std::thread(ServeConnection, std::move(connection), std::ref(pool), std::ref(watchdog))
+        .detach();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// スーパーバイザ
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+using ChildHandle = HANDLE;
+const ChildHandle kNoChild = nullptr;
+
+std::wstring Quote(const std::wstring& text) { return L"\"" + text + L"\""; }
+
+ChildHandle SpawnWorker(const WorkerOptions& options, const std::string& socketPath) {
+  std::wstring exe(MAX_PATH, L'\0');
+  DWORD length = 0;
+  while ((length = GetModuleFileNameW(nullptr, &exe[0], static_cast<DWORD>(exe.size()))) ==
+         exe.size())
+    exe.resize(exe.size() * 2);
+  exe.resize(length);
+
+  std::wstring commandLine = Quote(exe) +
+      L" --socket " + Quote(std::filesystem::u8path(socketPath).wstring()) +
+      L" --warm " + std::to_wstring(options.warm) +
+      L" --max-request-ms " + std::to_wstring(options.maxRequestMs);
+
+  STARTUPINFOW startup{};
+  startup.cb = sizeof(startup);
+  PROCESS_INFORMATION process{};
+  if (!CreateProcessW(exe.c_str(), &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr,
+                      nullptr, &startup, &process))
+    return kNoChild;
+  CloseHandle(process.hThread);
+  return process.hProcess;
+}
+
+bool HasExited(ChildHandle child, int* exitCode) {
+  if (WaitForSingleObject(child, 0) != WAIT_OBJECT_0) return false;
+  DWORD code = 0;
+  GetExitCodeProcess(child, &code);
+  CloseHandle(child);
+  *exitCode = static_cast<int>(code);
+  return true;
+}
+
+void TerminateWorker(ChildHandle child) {
+  TerminateProcess(child, 0);
+  WaitForSingleObject(child, INFINITE);
+  CloseHandle(child);
+}
+#else
+using ChildHandle = pid_t;
+const ChildHandle kNoChild = -1;
+
+ChildHandle SpawnWorker(const WorkerOptions& options, const std::string& socketPath) {
+  const std::vector<std::string> args = {
+      "occt_geometry_worker", "--socket", socketPath,
+      "--warm", std::to_string(options.warm),
+      "--max-request-ms", std::to_string(options.maxRequestMs)};
+  std::vector<char*> argv;
+  for (const std::string& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  const pid_t pid = fork();
+  if (pid == 0) {
+    execv("/proc/self/exe", argv.data());
+    _exit(127);
+  }
+  return pid > 0 ? pid : kNoChild;
+}
+
+bool HasExited(ChildHandle child, int* exitCode) {
+  int status = 0;
+  if (waitpid(child, &status, WNOHANG) != child) return false;
+  *exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  return true;
+}
+
+void TerminateWorker(ChildHandle child) {
+  kill(child, SIGTERM);
+  waitpid(child, nullptr, 0);
+}
+#endif
+
+struct WorkerSlot {
+  std::string       socketPath;
+  ChildHandle       child = kNoChild;
+  Clock::time_point startedAt;
+  Clock::time_point restartAt;
+  int               restarts = 0;
+};
+
+// 終了したワーカーを再起動し続ける。SIGINT / SIGTERM で全ワーカーを止めて戻る
+int RunSupervisor(const WorkerOptions& options) {
+  std::vector<WorkerSlot> slots(static_cast<std::size_t>(options.pool));
+  for (std::size_t i = 0; i < slots.size(); ++i)
+    slots[i].socketPath = l1::worker::WorkerSocketPath(options.socketPath, static_cast<int>(i));
+
+  std::signal(SIGINT, OnStopSignal);
+  std::signal(SIGTERM, OnStopSignal);
+
+  while (!gStop) {
+    const Clock::time_point now = Clock::now();
+    for (WorkerSlot& slot : slots) {
+      int exitCode = 0;
+      if (slot.child != kNoChild && HasExited(slot.child, &exitCode)) {
+        std::cerr << "Worker " << slot.socketPath << " exited with " << exitCode << std::endl;
+        slot.child     = kNoChild;
+        slot.restartAt = now - slot.startedAt < kQuickExit ? now + kRestartDelay : now;
+        ++slot.restarts;
+      }
+      if (slot.child == kNoChild && now >= slot.restartAt) {
+        slot.child     = SpawnWorker(options, slot.socketPath);
+        slot.startedAt = now;
+        if (slot.child == kNoChild) slot.restartAt = now + kRestartDelay;
+      }
+    }
+    std::this_thread::sleep_for(kPollInterval);
+  }
+
+  for (WorkerSlot& slot : slots)
+    if (slot.child != kNoChild) TerminateWorker(slot.child);
+  return 0;
+}
+
+bool ParseArgs(int argc, char* argv[], WorkerOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if      (arg == "--socket"         && hasValue) options->socketPath   = argv[++i];
+    else if (arg == "--pool"           && hasValue) options->pool         = std::stoi(argv[++i]);
+    else if (arg == "--warm"           && hasValue) options->warm         = std::stoi(argv[++i]);
+    else if (arg == "--max-request-ms" && hasValue) options->maxRequestMs = std::stoll(argv[++i]);
+    else return false;
+  }
+  return !options->socketPath.empty() && options->pool >= 0 && options->warm >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  WorkerOptions options;
+  bool parsed = false;
+  try {
+    parsed = ParseArgs(argc, argv, &options);
+  } catch (const std::exception&) {
+    parsed = false;
+  }
+  if (!parsed) {
+    std::cerr << "Usage: occt_geometry_worker --socket path [--pool N] [--warm K]"
+                 " [--max-request-ms ms]" << std::endl;
+    return kExitUsage;
+  }
+  const int exitCode = options.pool > 0 ? RunSupervisor(options) : RunWorker(options);
+  L1_StopJournal();  // L1_JOURNAL_PATH の記録を閉じる（未開始なら何もしない）
+  return exitCode;
+}